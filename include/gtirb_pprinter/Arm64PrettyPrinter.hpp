@@ -75,15 +75,15 @@ protected:
   void printSymbolHeader(std::ostream& os, const gtirb::Symbol& sym) override;
 
 private:
-  void buildSymGotRefTable(void);
+  const std::unordered_set<const gtirb::Symbol*>& localGotSyms();
 
   bool IsPrintingGroupedOperands = false;
 
   /*
-  UUIDs of symbols in the Module where at least one of the references to that
-  symbol are via the GOT.
+  Symbols in the Module where at least one of the references to that symbol
+  are via the GOT. Built on first use, once the symbol forwarding is shared.
   */
-  std::set<gtirb::UUID> LocalGotSyms = {};
+  std::optional<std::unordered_set<const gtirb::Symbol*>> LocalGotSyms;
 };
 
 class Arm64PrettyPrinterFactory : public ElfPrettyPrinterFactory {
@@ -4,6 +4,9 @@
 #include <gtirb/gtirb.hpp>
 #include <optional>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "AuxDataSchema.hpp"
 #include "Export.hpp"
@@ -178,6 +181,10 @@ std::map<gtirb::UUID, gtirb::UUID> getFunctionNames(const gtirb::Module& Mod);
 std::optional<uint64_t> getSymbolicExpressionSize(const gtirb::Offset& Offset,
                                                   const gtirb::Module& Mod);
 
+// Load the whole `symbolicExpressionSizes' AuxData table, if present.
+const std::map<gtirb::Offset, uint64_t>*
+getSymbolicExpressionSizes(const gtirb::Module& Mod);
+
 // Load all alignment entries from the `alignment' AuxData table.
 std::map<gtirb::UUID, uint64_t> getAlignments(const gtirb::Module& Mod);
 
@@ -208,6 +215,33 @@ void setBinaryType(gtirb::Module& Module, const std::vector<std::string>& Vec);
 std::map<gtirb::UUID, gtirb::UUID>
 getSymbolForwarding(const gtirb::Module& Module);
 
+// The `symbolForwarding' AuxData table with its symbols resolved, so that
+// finding where a symbol is forwarded to is a lookup by pointer instead of a
+// lookup by UUID in the table and then in the context.
+class DEBLOAT_PRETTYPRINTER_EXPORT_API SymbolForwardingTable {
+public:
+  using Entry = std::pair<const gtirb::Symbol*, const gtirb::Symbol*>;
+
+  SymbolForwardingTable() = default;
+  SymbolForwardingTable(const gtirb::Context& Context,
+                        const gtirb::Module& Module);
+
+  // Return the symbol that Symbol is forwarded to, or nullptr.
+  const gtirb::Symbol* lookup(const gtirb::Symbol* Symbol) const {
+    auto It = Targets.find(Symbol);
+    return It == Targets.end() ? nullptr : It->second;
+  }
+
+  // The forwarded symbols and their targets in the order of the AuxData
+  // table, leaving out entries whose symbols do not exist.
+  const std::vector<Entry>& entries() const { return Entries; }
+  bool empty() const { return Entries.empty(); }
+
+private:
+  std::unordered_map<const gtirb::Symbol*, const gtirb::Symbol*> Targets;
+  std::vector<Entry> Entries;
+};
+
 // Load all comments for instructions from the `comments' AuxData table.
 const std::map<gtirb::Offset, std::string>*
 getComments(const gtirb::Module& Module);
@@ -22,6 +22,7 @@
 
 /// \brief Binary-print GTIRB representations.
 namespace gtirb_bprint {
+class ObjectCache;
 class TempFile;
 
 class DEBLOAT_PRETTYPRINTER_EXPORT_API BinaryPrinter {
@@ -29,6 +30,7 @@ protected:
   std::vector<std::string> ExtraCompileArgs;
   std::vector<std::string> LibraryPaths;
   const gtirb_pprint::PrettyPrinter& Printer;
+  ObjectCache* Objects = nullptr;
 
   bool prepareSource(gtirb::Context& ctx, gtirb::Module& mod,
                      TempFile& tempFile) const;
@@ -44,6 +46,12 @@ public:
         Printer(prettyPrinter) {}
 
   virtual ~BinaryPrinter() = default;
+
+  /// Reuse the objects assembled from unchanged assembly that are kept in
+  /// Cache, and add the ones that are assembled to it. Only the ELF binary
+  /// printer uses the cache.
+  void setObjectCache(ObjectCache* Cache) { Objects = Cache; }
+
   virtual int assemble(const std::string& outputFilename,
                        gtirb::Context& context, gtirb::Module& mod) const = 0;
   virtual int link(const std::string& outputFilename, gtirb::Context& context,
@@ -20,6 +20,7 @@
 
 #include <gtirb/gtirb.hpp>
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -35,6 +36,7 @@ private:
   std::string compiler;
   bool debug = false;
   bool useDummySO = false;
+  bool useBuiltinAssembler = false;
   bool isInfixLibraryName(const std::string& library) const;
   std::optional<std::string>
   findLibrary(const std::string& library,
@@ -78,9 +80,56 @@ private:
                           const gtirb::Module& module,
                           const std::string& libDir,
                           std::vector<std::string>& libArgs) const;
+
+  /**
+  Prepare the linker arguments that do not depend on the printed assembly:
+  the libraries, the version script, the dynamic list and the init/fini
+  arguments. The files they refer to are written to dummySoDir,
+  VersionScript and DynamicList, which must outlive the link.
+
+  Returns false if the dummy libraries cannot be created.
+  */
+  bool prepareLinkArgs(gtirb::Context& ctx, gtirb::Module& module,
+                       const std::string& outputFilename,
+                       std::optional<TempDir>& dummySoDir,
+                       TempFile& VersionScript, TempFile& DynamicList,
+                       std::vector<std::string>& libArgs) const;
   void addOrigLibraryArgs(const gtirb::Module& module,
                           std::vector<std::string>& args,
                           const std::string& location) const;
+
+  /**
+  Write the module as an object file with the built-in ELF writer (see
+  writeElfObject), if it is enabled and supports the module.
+
+  Returns std::nullopt if the printed assembly has to be assembled instead.
+  */
+  std::optional<std::string> buildObject(gtirb::Context& ctx,
+                                         const gtirb::Module& module) const;
+
+  /**
+  Assemble the file Source into an object file at ObjectPath. If an object
+  cache is set and holds an object assembled from the same assembly with the
+  same arguments, it is copied instead.
+
+  Returns the exit code of the assembler, or std::nullopt if it cannot be
+  found on the PATH.
+  */
+  std::optional<int> assembleFile(const std::string& Source,
+                                  const std::string& ObjectPath,
+                                  const gtirb::Module& module) const;
+
+  /**
+  Print the module as listing shards (see
+  gtirb_pprint::PrettyPrinterBase::computeListingShards) and assemble each of
+  them with assembleFile, so that the object cache only misses on the shards
+  that changed. The objects are appended to ObjectFiles.
+
+  Returns false, after logging the error, if a shard cannot be assembled.
+  */
+  bool assembleShards(gtirb::Context& context, const gtirb::Module& module,
+                      std::vector<TempFile>& ObjectFiles) const;
+
   std::vector<std::string>
   buildCompilerArgs(std::string outputFilename,
                     const std::vector<TempFile>& asmPath, gtirb::Module& module,
@@ -92,10 +141,12 @@ public:
                             const std::string& gccExecutable,
                             const std::vector<std::string>& extraCompileArgs,
                             const std::vector<std::string>& libraryPaths,
-                            bool debugFlag, bool dummySOFlag)
+                            bool debugFlag, bool dummySOFlag,
+                            bool builtinAssemblerFlag = false)
       : BinaryPrinter(prettyPrinter, extraCompileArgs, libraryPaths),
         compiler(gccExecutable.empty() ? defaultCompiler : gccExecutable),
-        debug(debugFlag), useDummySO(dummySOFlag) {}
+        debug(debugFlag), useDummySO(dummySOFlag),
+        useBuiltinAssembler(builtinAssemblerFlag) {}
   virtual ~ElfBinaryPrinter() = default;
 
   int assemble(const std::string& outputFilename, gtirb::Context& context,
@@ -0,0 +1,54 @@
+//===- ElfObjectWriter.hpp --------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PP_ELF_OBJECT_WRITER_H
+#define GTIRB_PP_ELF_OBJECT_WRITER_H
+
+#include "Export.hpp"
+#include "PrettyPrinter.hpp"
+
+#include <gtirb/gtirb.hpp>
+#include <string>
+
+namespace gtirb_bprint {
+
+/// \brief Write an x86-64 ELF relocatable object for a module directly from
+/// the IR, without printing and assembling its source.
+///
+/// The printed blocks of every printed section are laid out like the
+/// assembler lays out the listing of the module, and each symbolic
+/// expression becomes a relocation. The printer of the module decides which
+/// blocks and symbols are printed, how blocks are aligned and how ambiguous
+/// symbols are named. Only a conservative subset of modules is supported:
+/// anything the writer cannot reproduce like the assembler would (CFI
+/// directives, symbol versions or forwarding, TLS, ...) is rejected.
+///
+/// \param Printer the printer the module would be printed with
+/// \param Module  the module to write
+/// \param Policy  the policy of the printer
+/// \param Object  receives the contents of the object file on success
+/// \param Reason  receives a description of the first unsupported feature
+///                on failure
+///
+/// \return true if the object was written, or false if the caller should
+/// fall back to assembling the printed source.
+DEBLOAT_PRETTYPRINTER_EXPORT_API bool
+writeElfObject(gtirb_pprint::PrettyPrinterBase& Printer,
+               const gtirb::Module& Module,
+               const gtirb_pprint::PrintingPolicy& Policy, std::string& Object,
+               std::string& Reason);
+
+} // namespace gtirb_bprint
+
+#endif /* GTIRB_PP_ELF_OBJECT_WRITER_H */
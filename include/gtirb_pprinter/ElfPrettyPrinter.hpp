@@ -136,6 +136,8 @@ protected:
                            const gtirb::Symbol& symbol) override;
   void printUndefinedSymbol(std::ostream& os,
                             const gtirb::Symbol& symbol) override;
+  void printShardExport(std::ostream& os,
+                        const gtirb::Symbol& symbol) override;
 
   void printSymbolicDataType(
       std::ostream& os,
@@ -146,11 +148,11 @@ protected:
 
   virtual void printSymbolHeader(std::ostream& os, const gtirb::Symbol& symbol);
 
-  void printSymbolType(std::ostream& os, std::string& Name,
+  void printSymbolType(std::ostream& os, std::string_view Name,
                        const aux_data::ElfSymbolInfo& SymbolInfo);
 
   /** Print .size directives for OBJECT and TLS symbols. */
-  void printSymbolSize(std::ostream& os, std::string& Name,
+  void printSymbolSize(std::ostream& os, std::string_view Name,
                        const aux_data::ElfSymbolInfo& SymbolInfo);
 
   void printString(std::ostream& Stream, const gtirb::DataBlock& Block,
@@ -165,7 +167,7 @@ protected:
 
 private:
   bool TlsGdSequence = false;
-  void computeFunctionAliases();
+  void computeFunctionAliases(FunctionInformation& Info) const override;
 };
 
 class DEBLOAT_PRETTYPRINTER_EXPORT_API ElfPrettyPrinterFactory
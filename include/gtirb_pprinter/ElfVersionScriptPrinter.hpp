@@ -15,22 +15,31 @@
 #ifndef GTIRB_PP_ELFVERSIONSCRIPT_PRINTER_H
 #define GTIRB_PP_ELFVERSIONSCRIPT_PRINTER_H
 
-#include <fstream>
+#include <ostream>
 #include <gtirb/gtirb.hpp>
+#include <optional>
+#include <string>
 
 #include "Export.hpp"
 
 namespace gtirb_pprint {
 
+/// \brief build the ELF version script for a module.
+///
+/// \return the text of the script, which is empty if the module has no
+/// symbol versions to define, or std::nullopt if the module is not ELF.
+DEBLOAT_PRETTYPRINTER_EXPORT_API std::optional<std::string>
+buildVersionScript(const gtirb::Context& Context, const gtirb::Module& Module);
+
 /// \brief print ELF version scripts from GTIRB representations.
 DEBLOAT_PRETTYPRINTER_EXPORT_API bool
 printVersionScript(const gtirb::Context& Context, const gtirb::Module& Module,
-                   std::ofstream& VersionScript);
+                   std::ostream& VersionScript);
 
 /// \brief print ELF version scripts for dummy-so from GTIRB representations.
 DEBLOAT_PRETTYPRINTER_EXPORT_API bool
 printVersionScriptForDummySo(const gtirb::Module& Module,
-                             std::ofstream& VersionScript);
+                             std::ostream& VersionScript);
 
 } // namespace gtirb_pprint
 
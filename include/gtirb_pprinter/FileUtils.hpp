@@ -15,7 +15,9 @@
 #ifndef GTIRB_FileUtils_H
 #define GTIRB_FileUtils_H
 
-#include <fstream>
+#include "OutputSink.hpp"
+
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -25,7 +27,7 @@ namespace gtirb_bprint {
 /// end
 class TempFile {
   std::string Name;
-  std::ofstream FileStream;
+  std::unique_ptr<gtirb_pprint::OutputSinkStream> FileStream;
   bool Empty = false;
 
 public:
@@ -33,11 +35,14 @@ public:
   TempFile(TempFile&& Other);
   ~TempFile();
 
-  bool isOpen() const { return FileStream.is_open(); }
-  void close() { FileStream.close(); }
+  bool isOpen() const { return FileStream && FileStream->is_open(); }
+  void close() {
+    if (FileStream)
+      FileStream->close();
+  }
 
-  operator const std::ofstream &() const { return FileStream; }
-  operator std::ofstream &() { return FileStream; }
+  operator const std::ostream &() const { return *FileStream; }
+  operator std::ostream &() { return *FileStream; }
   const std::string& fileName() const { return Name; }
 };
 
@@ -15,6 +15,11 @@
 #ifndef GT_PPRINTER_FIXUP_H
 #define GT_PPRINTER_FIXUP_H
 #include "Export.hpp"
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
 
 namespace gtirb {
 class Context;
@@ -24,6 +29,48 @@ class Module;
 namespace gtirb_pprint {
 class PrettyPrinter;
 
+/// Cost of a single fixup pass.
+struct DEBLOAT_PRETTYPRINTER_EXPORT_API FixupPassStats {
+  std::string Name;
+  std::chrono::nanoseconds WallTime{0};
+  /// Number of symbols inspected by the pass.
+  size_t SymbolsScanned = 0;
+  /// Number of existing symbols whose name, referent, or info was changed.
+  size_t SymbolsModified = 0;
+  /// Number of symbols added to the module (excluding hidden aliases).
+  size_t SymbolsCreated = 0;
+  /// Number of symbolic expressions replaced.
+  size_t ExpressionsRewritten = 0;
+  /// Number of `.gtirb_pprinter.hidden_alias.*` symbols added.
+  size_t AliasesCreated = 0;
+  /// The pass was skipped because the printer records it as already
+  /// applied.
+  bool Cached = false;
+
+  /// Whether the pass changed (or, in a dry run, would change) the module.
+  bool changed() const {
+    return SymbolsModified || SymbolsCreated || ExpressionsRewritten ||
+           AliasesCreated;
+  }
+};
+
+/// Options controlling how fixups are applied.
+struct DEBLOAT_PRETTYPRINTER_EXPORT_API FixupOptions {
+  /// Compute the cost of every pass without modifying the module.
+  bool DryRun = false;
+  /// Run every pass even if the printer records it as already applied.
+  bool Force = false;
+};
+
+/// Per-pass cost of a call to applyFixups, in the order the passes ran.
+struct DEBLOAT_PRETTYPRINTER_EXPORT_API FixupReport {
+  bool DryRun = false;
+  std::vector<FixupPassStats> Passes;
+
+  /// Whether any pass changed (or would change) the module.
+  bool changed() const;
+};
+
 /// Transforms a GTIRB module to make it acceptable to
 /// the assembler.
 /// For ELF shared object modules, this consists of removing
@@ -31,20 +78,36 @@ class PrettyPrinter;
 /// with indirect ones
 /// For PE modules, this means ensuring that the entry symbols
 /// are correctly named.
+/// Each pass that is applied is recorded in the module caches of the
+/// printer (see \link PrettyPrinter::isFixupApplied), and is skipped on
+/// later calls with the printer or its copies, e.g. when printing the same
+/// module with several syntaxes, unless Options.Force is set. A module that
+/// is edited after it was fixed up must have its caches invalidated (see
+/// \link PrettyPrinter::invalidateModuleCaches) for the passes to run
+/// again.
 /// \param Ctx
 /// \param Mod
 /// \param Printer
-void DEBLOAT_PRETTYPRINTER_EXPORT_API applyFixups(gtirb::Context& Ctx,
-                                                  gtirb::Module& Mod,
-                                                  const PrettyPrinter& Printer);
+/// \param Options
+/// \return the cost of each pass that was run
+FixupReport DEBLOAT_PRETTYPRINTER_EXPORT_API
+applyFixups(gtirb::Context& Ctx, gtirb::Module& Mod,
+            const PrettyPrinter& Printer, const FixupOptions& Options = {});
+
+/// Write a human-readable summary of a FixupReport, one line per pass.
+void DEBLOAT_PRETTYPRINTER_EXPORT_API
+printFixupReport(std::ostream& Stream, const gtirb::Module& Mod,
+                 const FixupReport& Report);
 
 /// Turn any direct references to global symbols, which
 /// are illegal relocations in shared objects, into
 /// indirect references
-void fixupSharedObject(gtirb::Context& Ctx, gtirb::Module& Mod);
+FixupPassStats fixupSharedObject(gtirb::Context& Ctx, gtirb::Module& Mod,
+                                 bool DryRun = false);
 
 /// Ensure that PE entry symbols are correctly named
-void fixupPESymbols(gtirb::Context& Ctx, gtirb::Module& Mod);
+FixupPassStats fixupPESymbols(gtirb::Context& Ctx, gtirb::Module& Mod,
+                              bool DryRun = false);
 
 /// Fixup ELF symbol bindings.
 ///
@@ -55,7 +118,8 @@ void fixupPESymbols(gtirb::Context& Ctx, gtirb::Module& Mod);
 ///
 /// - main (only necessary for --policy=dynamic, but we fixup unconditionally)
 /// - DT_INIT and DT_FINI functions
-void fixupELFSymbols(gtirb::Context& Ctx, gtirb::Module& Mod);
+FixupPassStats fixupELFSymbols(gtirb::Context& Ctx, gtirb::Module& Mod,
+                               bool DryRun = false);
 
 /// Remove "_copy" suffix from "__x86.get_pc_thunk.*" symbols.
 ///
@@ -65,7 +129,8 @@ void fixupELFSymbols(gtirb::Context& Ctx, gtirb::Module& Mod);
 /// gtirb-pprinter>=2.1.1 expects these to exist in the IR if they were in
 /// the original binary. This fixup maintains compatibility with earlier GTIRB
 /// files where these symbols were renamed.
-void fixupGetPcThunkNames(gtirb::Context& Ctx, gtirb::Module& Mod);
+FixupPassStats fixupGetPcThunkNames(gtirb::Context& Ctx, gtirb::Module& Mod,
+                                    bool DryRun = false);
 
 } // namespace gtirb_pprint
 
@@ -0,0 +1,108 @@
+//===- ListingIndex.hpp -----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PP_LISTING_INDEX_H
+#define GTIRB_PP_LISTING_INDEX_H
+
+#include "Export.hpp"
+
+#include <gtirb/gtirb.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace gtirb_pprint {
+
+/// A section, function or block of a listing: the addresses it covers and
+/// where its text is in the listing.
+struct ListingIndexEntry {
+  enum class Kind : uint8_t { Section, Function, Block };
+
+  Kind EntryKind;
+  gtirb::UUID Id;
+  /// The address range [Begin, End) of the entry.
+  uint64_t Begin = 0;
+  uint64_t End = 0;
+  /// The byte range [Offset, Offset + Size) of the entry in the listing.
+  uint64_t Offset = 0;
+  uint64_t Size = 0;
+  /// The section or function name; empty for blocks.
+  std::string Name;
+};
+
+/// \brief Map the sections, functions and blocks of a module to their text
+/// in a listing, so that a viewer can show part of a listing without reading
+/// or printing all of it (see \link PrettyPrinterBase::printRange).
+///
+/// The sidecar file written by \link write has one entry per line:
+///
+///     <kind> <uuid> <begin> <end> <offset> <size> [<name>]
+///
+/// where kind is `section`, `function` or `block`, addresses are hexadecimal
+/// and offsets and sizes are decimal. Entries of a kind are in listing
+/// order. A function whose blocks are not contiguous covers the smallest
+/// range that contains all of them.
+class DEBLOAT_PRETTYPRINTER_EXPORT_API ListingIndex {
+public:
+  /// Add an entry and return its position.
+  size_t add(ListingIndexEntry Entry);
+  ListingIndexEntry& operator[](size_t I) {
+    Lookup.Valid = false;
+    return Entries[I];
+  }
+
+  const std::vector<ListingIndexEntry>& entries() const { return Entries; }
+
+  /// Return the entries of the given kind whose address range overlaps
+  /// [Begin, End), in address order. The entries are sorted by address on
+  /// the first call after the index changed, and found by binary search.
+  std::vector<const ListingIndexEntry*>
+  find(ListingIndexEntry::Kind Kind, uint64_t Begin, uint64_t End) const;
+
+  void write(std::ostream& Stream) const;
+
+  /// Read an index written by \link write. Returns std::nullopt if the
+  /// input is malformed.
+  static std::optional<ListingIndex> read(std::istream& Stream);
+
+private:
+  std::vector<ListingIndexEntry> Entries;
+
+  // The entries of each kind sorted by their first address, and the
+  // largest end address of each prefix of them. Built by find, and not
+  // copied with the index.
+  struct LookupTable {
+    LookupTable() = default;
+    LookupTable(const LookupTable&) {}
+    LookupTable& operator=(const LookupTable&) {
+      Valid = false;
+      return *this;
+    }
+
+    static constexpr size_t NumKinds = 3;
+    std::mutex Mutex;
+    bool Valid = false;
+    std::vector<size_t> Sorted[NumKinds];
+    std::vector<uint64_t> MaxEnd[NumKinds];
+  };
+  mutable LookupTable Lookup;
+};
+
+} // namespace gtirb_pprint
+
+#endif /* GTIRB_PP_LISTING_INDEX_H */
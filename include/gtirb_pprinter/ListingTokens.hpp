@@ -0,0 +1,76 @@
+//===- ListingTokens.hpp ----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PP_LISTING_TOKENS_H
+#define GTIRB_PP_LISTING_TOKENS_H
+
+#include "Export.hpp"
+
+#include <gtirb/gtirb.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace gtirb_pprint {
+
+/// Kinds of records in a listing token stream.
+enum class ListingToken : uint8_t {
+  Line = 1,        // u64 EA, 16-byte block UUID, then the line text
+  Label = 2,       // u64 EA, 16-byte symbol UUID, then the label name
+  Instruction = 3, // u32 mnemonic length, mnemonic, then the operand text
+  SymbolRef = 4,   // 16-byte symbol UUID
+};
+
+/// \brief Write a binary token stream of a listing, so that clients can
+/// recover addresses, instructions and symbol references without parsing the
+/// listing text.
+///
+/// The stream starts with the magic "GTLT" and a u32 format version. Each
+/// record is a u8 ListingToken kind, three reserved zero bytes and a u32
+/// payload size, followed by the payload, padded with zeros to a multiple of
+/// 8 bytes. All integers are little-endian, and the block UUID of lines
+/// outside of any block is all zeros.
+///
+/// Instruction and SymbolRef records belong to the Line record before them.
+/// The printer produces them while it is still building that line, so the
+/// writer buffers them until the line itself is written.
+class DEBLOAT_PRETTYPRINTER_EXPORT_API ListingTokenWriter {
+public:
+  static constexpr uint32_t Version = 1;
+
+  explicit ListingTokenWriter(std::ostream& Stream);
+  ~ListingTokenWriter();
+
+  ListingTokenWriter(const ListingTokenWriter&) = delete;
+  ListingTokenWriter& operator=(const ListingTokenWriter&) = delete;
+
+  void label(uint64_t EA, const gtirb::UUID& Symbol, std::string_view Name);
+  void instruction(std::string_view Mnemonic, std::string_view Operands);
+  void symbolReference(const gtirb::UUID& Symbol);
+  void line(uint64_t EA, const gtirb::UUID& Block, std::string_view Text);
+
+  /// Write out any records still buffered.
+  void flush();
+
+private:
+  std::ostream& Stream;
+  std::string Record;
+  std::string Pending;
+};
+
+} // namespace gtirb_pprint
+
+#endif /* GTIRB_PP_LISTING_TOKENS_H */
@@ -23,6 +23,8 @@ class DEBLOAT_PRETTYPRINTER_EXPORT_API MasmSyntax : public Syntax {
 public:
   // Styles
   const std::string& comment() const override { return CommentStyle; }
+  // Numeric constants must start with a digit for the MASM assembler.
+  const HexFormat& hexFormat() const override { return MasmHexFormat; }
 
   // Common directives
   const std::string& string() const override { return StringDirective; }
@@ -59,9 +61,11 @@ public:
   std::string formatFunctionName(const std::string& x) const override;
   std::string avoidRegNameConflicts(const std::string& x) const override;
   std::string formatSymbolName(const std::string& x) const override;
+  void escapeString(std::string& Buf, std::string_view Bytes) const override;
 
 private:
   const std::string CommentStyle{";"};
+  const HexFormat MasmHexFormat{"0", "H", false};
 
   const std::string StringDirective{"DB"};
 
@@ -151,6 +155,7 @@ protected:
                                bool inData = false) override;
 
   void printByte(std::ostream& os, std::byte byte) override;
+  void printZeros(std::ostream& os, uint64_t Count) override;
   void printZeroDataBlock(std::ostream& os, const gtirb::DataBlock& dataObject,
                           uint64_t offset) override;
 
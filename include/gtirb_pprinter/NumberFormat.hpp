@@ -0,0 +1,78 @@
+//===- NumberFormat.hpp -----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PP_NUMBER_FORMAT_H
+#define GTIRB_PP_NUMBER_FORMAT_H
+
+#include "Export.hpp"
+#include <charconv>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace gtirb_pprint {
+
+/// Spelling of a hexadecimal literal in an assembler dialect, e.g. "0x1f"
+/// for GAS or "01fH" for MASM.
+struct HexFormat {
+  std::string_view Prefix;
+  std::string_view Suffix;
+  bool UpperCase = false;
+};
+
+/// C-style hexadecimal literals: 0x1f.
+inline constexpr HexFormat CHexFormat{"0x", "", false};
+
+/// Hexadecimal digits without any prefix or suffix: 1f.
+inline constexpr HexFormat BareHexFormat{"", "", false};
+
+// The functions below format integers with std::to_chars. Unlike the
+// iostream manipulators they replace, they neither consult the stream's
+// locale nor read or modify its format flags, so callers do not need to
+// save and restore them.
+
+/// Append the decimal spelling of Value to Buf.
+template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+void appendDecimal(std::string& Buf, T Value) {
+  char Digits[20];
+  auto Result = std::to_chars(std::begin(Digits), std::end(Digits), Value);
+  Buf.append(Digits, Result.ptr);
+}
+
+/// Append Value in hexadecimal to Buf, padded with zeros to at least
+/// MinDigits digits.
+DEBLOAT_PRETTYPRINTER_EXPORT_API void
+appendHex(std::string& Buf, uint64_t Value,
+          const HexFormat& Format = CHexFormat, unsigned MinDigits = 0);
+
+/// Write the decimal spelling of Value to Stream.
+template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+void writeDecimal(std::ostream& Stream, T Value) {
+  char Digits[20];
+  auto Result = std::to_chars(std::begin(Digits), std::end(Digits), Value);
+  Stream.write(Digits, Result.ptr - Digits);
+}
+
+/// Write Value in hexadecimal to Stream, padded with zeros to at least
+/// MinDigits digits.
+DEBLOAT_PRETTYPRINTER_EXPORT_API void
+writeHex(std::ostream& Stream, uint64_t Value,
+         const HexFormat& Format = CHexFormat, unsigned MinDigits = 0);
+
+} // namespace gtirb_pprint
+
+#endif /* GTIRB_PP_NUMBER_FORMAT_H */
@@ -0,0 +1,72 @@
+//===- ObjectCache.hpp ------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PP_OBJECT_CACHE_H
+#define GTIRB_PP_OBJECT_CACHE_H
+
+#include "Export.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace gtirb_bprint {
+
+/// \brief Directory of object files assembled from printed assembly.
+///
+/// Objects are keyed by a SHA-256 hash of the assembly and of the command
+/// that assembled it, so unchanged assembly is not assembled again. The
+/// cache does not know about the assembler binary itself; clear it when the
+/// toolchain changes. Several threads may fetch and store at once.
+class DEBLOAT_PRETTYPRINTER_EXPORT_API ObjectCache {
+public:
+  /// Use the directory Dir as the cache. If MaxSize is not zero, the least
+  /// recently used objects are removed when the cache grows past MaxSize
+  /// bytes.
+  explicit ObjectCache(std::string Dir, uint64_t MaxSize = 0);
+
+  /// Return the key of the object assembled from the file Source by running
+  /// Tool with Args, which must not name the source or output files. Returns
+  /// std::nullopt if Source cannot be read.
+  static std::optional<std::string> key(const std::string& Source,
+                                        const std::string& Tool,
+                                        const std::vector<std::string>& Args);
+
+  /// Copy the object cached under Key to Path, counting a hit or a miss.
+  /// Returns false if there is no such object.
+  bool fetch(const std::string& Key, const std::string& Path);
+
+  /// Add the object file at Path to the cache under Key, then remove the
+  /// least recently used objects if the cache is over its size limit.
+  bool store(const std::string& Key, const std::string& Path);
+
+  const std::string& directory() const { return Dir; }
+  uint64_t hits() const { return Hits; }
+  uint64_t misses() const { return Misses; }
+
+private:
+  std::string objectPath(const std::string& Key) const;
+  void trim();
+
+  std::string Dir;
+  uint64_t MaxSize;
+  std::atomic<uint64_t> Hits{0};
+  std::atomic<uint64_t> Misses{0};
+};
+
+} // namespace gtirb_bprint
+
+#endif /* GTIRB_PP_OBJECT_CACHE_H */
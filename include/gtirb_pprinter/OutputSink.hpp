@@ -0,0 +1,95 @@
+//===- OutputSink.hpp -------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PP_OUTPUT_SINK_H
+#define GTIRB_PP_OUTPUT_SINK_H
+
+#include "Export.hpp"
+
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace gtirb_pprint {
+
+/// \brief Stream buffer writing to a file through a large buffer.
+///
+/// The buffer is only written out, with write(2) or writev(2), when it is full
+/// or the sink is synced or closed; writes larger than the free space go out
+/// together with the buffered bytes in a single call. Files are opened in
+/// binary mode, so no newline translation takes place on Windows. The sink
+/// cannot seek, but reports its position (tellp) as the number of bytes
+/// written since the file was opened.
+class DEBLOAT_PRETTYPRINTER_EXPORT_API OutputSink : public std::streambuf {
+public:
+  static constexpr std::size_t DefaultBufferSize = 1 << 20;
+
+  explicit OutputSink(std::size_t BufferSize = DefaultBufferSize);
+  OutputSink(const OutputSink&) = delete;
+  OutputSink& operator=(const OutputSink&) = delete;
+  ~OutputSink() override;
+
+  /// Create or truncate the file at Path. Returns false if it could not be
+  /// opened.
+  bool open(const std::string& Path);
+  bool isOpen() const { return FD >= 0; }
+
+  /// Write out the buffer and close the file. Returns false if any write
+  /// since the file was opened failed.
+  bool close();
+
+protected:
+  int_type overflow(int_type C) override;
+  std::streamsize xsputn(const char* Data, std::streamsize Size) override;
+  int sync() override;
+  pos_type seekoff(off_type Off, std::ios_base::seekdir Dir,
+                   std::ios_base::openmode Which) override;
+
+private:
+  /// Write the buffered bytes followed by Size bytes of Data.
+  bool drain(const char* Data, std::size_t Size);
+
+  std::vector<char> Buffer;
+  /// Bytes written out of the buffer since the file was opened.
+  std::size_t Drained = 0;
+  int FD = -1;
+  bool Failed = false;
+};
+
+/// \brief std::ostream writing to an OutputSink, for the interfaces that take
+/// a stream.
+class DEBLOAT_PRETTYPRINTER_EXPORT_API OutputSinkStream : public std::ostream {
+public:
+  explicit OutputSinkStream(
+      std::size_t BufferSize = OutputSink::DefaultBufferSize);
+  explicit OutputSinkStream(
+      const std::string& Path,
+      std::size_t BufferSize = OutputSink::DefaultBufferSize);
+  ~OutputSinkStream() override = default;
+
+  /// Open Path, setting the failbit if it could not be opened.
+  void open(const std::string& Path);
+  bool is_open() const { return Sink.isOpen(); }
+  /// Close the file, setting the failbit if any write failed.
+  void close();
+
+private:
+  OutputSink Sink;
+};
+
+} // namespace gtirb_pprint
+
+#endif /* GTIRB_PP_OUTPUT_SINK_H */
@@ -17,6 +17,9 @@
 
 #include "AuxDataUtils.hpp"
 #include "Export.hpp"
+#include "ListingIndex.hpp"
+#include "ListingTokens.hpp"
+#include "Statistics.hpp"
 #include "Syntax.hpp"
 
 #include <gtirb/gtirb.hpp>
@@ -24,14 +27,20 @@
 #include <boost/range/any_range.hpp>
 #include <capstone/capstone.h>
 #include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <iosfwd>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 /// \brief Pretty-print GTIRB representations.
@@ -187,6 +196,37 @@ struct DEBLOAT_PRETTYPRINTER_EXPORT_API PrintingPolicy {
 };
 using NamedPolicyMap = std::unordered_map<std::string, PrintingPolicy>;
 
+/// One listing printed by PrettyPrinter::print when printing several at once:
+/// the syntax and listing mode to print with and the stream to print to.
+struct PrintTarget {
+  std::string Syntax;
+  std::string ListingMode;
+  std::ostream* Stream = nullptr;
+};
+
+/// The instructions most recently decoded from a code block. Printers that
+/// print the same module together and decode it the same way share one, so
+/// each block is decoded once however many listings are printed from it.
+class DEBLOAT_PRETTYPRINTER_EXPORT_API DecodeCache {
+public:
+  DecodeCache() = default;
+  DecodeCache(const DecodeCache&) = delete;
+  DecodeCache& operator=(const DecodeCache&) = delete;
+  ~DecodeCache();
+
+  /// Return the instructions of Block starting at Offset, decoding them with
+  /// Handle unless they are the ones already held. Decoded instructions are
+  /// counted in Stats.
+  std::pair<cs_insn*, size_t> decode(csh Handle, const gtirb::CodeBlock& Block,
+                                     uint64_t Offset, Statistics* Stats);
+
+private:
+  const gtirb::CodeBlock* Block = nullptr;
+  uint64_t Offset = 0;
+  cs_insn* Insns = nullptr;
+  size_t Count = 0;
+};
+
 enum DynMode {
   DYN_MODE_SHARED,
   DYN_MODE_PIE,
@@ -208,6 +248,7 @@ public:
   /// Construct a PrettyPrinter with the default configuration.
   PrettyPrinter() = default;
 
+  // Copies share the per-module caches (see \link getVersionScript).
   PrettyPrinter(const PrettyPrinter&) = default;
   PrettyPrinter(PrettyPrinter&&) = default;
   PrettyPrinter& operator=(const PrettyPrinter&) = default;
@@ -237,6 +278,11 @@ public:
 
   /// Indicates whether symbol versions should be ignored (only for ELF).
   bool getIgnoreSymbolVersions() const { return IgnoreSymbolVersions; }
+
+  /// Report the time spent printing and the work done to Stats, and let the
+  /// binary printers that use this printer report their phases too.
+  void setStatistics(Statistics* S) { Stats = S; }
+  Statistics* getStatistics() const { return Stats; }
   /// fixes up any direct references to global symbols, which
   /// are illegal relocations in shared objects.
   void fixupSharedObject(gtirb::Context& Ctx, gtirb::Module& Mod,
@@ -256,6 +302,28 @@ public:
   int print(std::ostream& Stream, gtirb::Context& Context,
             const gtirb::Module& Module) const;
 
+  /// Pretty-print the IR module to a stream, and write the token stream of
+  /// the listing (see \link ListingTokenWriter) to Tokens as it is printed.
+  int print(std::ostream& Stream, ListingTokenWriter& Tokens,
+            gtirb::Context& Context, const gtirb::Module& Module) const;
+
+  /// Pretty-print the IR module once per target, each with its own syntax
+  /// and listing mode and otherwise configured like this printer. The
+  /// module is analyzed once and the listings are printed together, block by
+  /// block, so that targets that decode instructions the same way share the
+  /// decoding. Returns 0 on success, or -1 if a target is not registered for
+  /// the module's format and ISA or cannot print it.
+  int print(const std::vector<PrintTarget>& Targets, gtirb::Context& Context,
+            const gtirb::Module& Module) const;
+
+  /// Create the printer that \link print uses for the module, e.g. to attach
+  /// a listing index or to print only part of the module. Returns nullptr if
+  /// the module's AuxData is not valid for the output format. The printer
+  /// uses the symbol forwarding cached by this PrettyPrinter, so this object
+  /// or a copy of it must outlive it.
+  std::unique_ptr<PrettyPrinterBase>
+  createPrinter(gtirb::Context& Context, const gtirb::Module& Module) const;
+
   PolicyOptions& functionPolicy() { return FunctionPolicy; }
   const PolicyOptions& functionPolicy() const { return FunctionPolicy; }
 
@@ -275,11 +343,56 @@ public:
   bool namedPolicyExists(const std::string& Name) const;
   const PrintingPolicy& getPolicy(const gtirb::Module& Module) const;
 
+  /// Return the policy the module is printed with: the selected named policy
+  /// with the keep/skip options and listing settings applied.
+  PrintingPolicy getEffectivePolicy(const gtirb::Module& Module) const;
+
   /// Update BinaryType aux_data for the given module
   void updateDynMode(gtirb::Module& Module, const std::string& SharedOption);
   /// Lookup BinaryType aux_data for the given module
   DynMode getDynMode(const gtirb::Module& Module) const;
 
+  /// Return the ELF version script for the given module (see
+  /// \link buildVersionScript), or null if it has none. The script is built
+  /// on first use and reused by later callers, e.g. the driver and the ELF
+  /// binary printer, so any fixups must be applied before the first call, or
+  /// the cache invalidated after them. It is cached by module UUID and
+  /// context, is shared by the copies of this printer, and may be requested
+  /// from several threads.
+  std::shared_ptr<const std::string>
+  getVersionScript(const gtirb::Context& Context,
+                   const gtirb::Module& Module) const;
+
+  /// Drop the version script, symbol forwarding and applied fixups cached
+  /// for the module, so that the next call rebuilds them and applyFixups
+  /// runs its passes again, e.g. after the module was edited. What was
+  /// returned for the module before, and the printers created for it with
+  /// \link createPrinter, keep the old values.
+  void invalidateModuleCaches(const gtirb::Context& Context,
+                              const gtirb::Module& Module) const;
+
+  /// Return the module's symbol forwarding with its symbols resolved. Like
+  /// the version script, it is built on first use, cached by module UUID and
+  /// context under a lock, and shared by the printers created for the
+  /// module, copies of this printer and the binary printers, so any fixups
+  /// must be applied before the first call, or the cache invalidated after
+  /// them.
+  std::shared_ptr<const aux_data::SymbolForwardingTable>
+  getSymbolForwarding(const gtirb::Context& Context,
+                      const gtirb::Module& Module) const;
+
+  /// Whether applyFixups applied the named pass to the module since its
+  /// caches were last invalidated. The record is kept with the other module
+  /// caches, so it is shared by the copies of this printer and is not saved
+  /// with the IR.
+  bool isFixupApplied(const gtirb::Context& Context,
+                      const gtirb::Module& Module,
+                      const std::string& Pass) const;
+  /// Record that applyFixups applied the named pass to the module.
+  void setFixupApplied(const gtirb::Context& Context,
+                       const gtirb::Module& Module,
+                       const std::string& Pass) const;
+
 private:
   std::string m_format;
   std::string m_isa;
@@ -288,6 +401,29 @@ private:
   PolicyOptions FunctionPolicy, SymbolPolicy, SectionPolicy, ArraySectionPolicy;
   std::string PolicyName = "default";
   bool IgnoreSymbolVersions = false;
+  Statistics* Stats = nullptr;
+
+  // What is built once per module and shared by the copies of a printer.
+  // Keyed by context and module UUID rather than by address, which another
+  // module can reuse once the first is destroyed.
+  struct ModuleCaches {
+    using Key = std::pair<const gtirb::Context*, gtirb::UUID>;
+    std::mutex Mutex;
+    std::map<Key, std::shared_ptr<const std::string>> VersionScripts;
+    std::map<Key, std::shared_ptr<const aux_data::SymbolForwardingTable>>
+        SymbolForwardings;
+    std::map<Key, std::set<std::string>> AppliedFixups;
+  };
+  // Moving copies the pointer, so that a moved-from printer still has
+  // caches to use.
+  struct SharedCaches {
+    SharedCaches() = default;
+    SharedCaches(const SharedCaches&) = default;
+    SharedCaches& operator=(const SharedCaches&) = default;
+    ModuleCaches* operator->() const { return Ptr.get(); }
+    std::shared_ptr<ModuleCaches> Ptr = std::make_shared<ModuleCaches>();
+  };
+  SharedCaches Caches;
 
   PrettyPrinterFactory& getFactory(const gtirb::Module& Module) const;
 };
@@ -329,6 +465,55 @@ private:
   NamedPolicyMap NamedPolicies;
 };
 
+/// Capstone group membership of a decoded instruction that affects how its
+/// operands are printed.
+struct InsnGroups {
+  enum : uint8_t {
+    Call = 1 << 0,
+    Jump = 1 << 1,
+    BranchRelative = 1 << 2,
+  };
+  uint8_t Flags = 0;
+
+  bool isCall() const { return Flags & Call; }
+  bool isJump() const { return Flags & Jump; }
+  bool isBranchRelative() const { return Flags & BranchRelative; }
+  /// Whether the instruction refers to code: a call, jump, or relative branch.
+  bool referencesCode() const { return Flags != 0; }
+};
+
+/// What a printer derives from the function aux data of its module. It
+/// depends only on the module and its file format, so the printers of a
+/// module can share it (see \link PrettyPrinterBase::setFunctionInformation).
+struct FunctionInformation {
+  /** Mapping from function UUIDs to the symbols that define the function
+   * name.*/
+  std::map<gtirb::UUID, const gtirb::Symbol*> FunctionToSymbols;
+  /** Mapping from Block UUIDs to Function UUIDs.*/
+  std::map<gtirb::UUID, gtirb::UUID> BlockToFunction;
+  /** Set of blocks that are the first in each function.*/
+  std::set<gtirb::UUID> FunctionFirstBlocks;
+  /** Set of block UUIDS that are the last in each function.*/
+  std::set<gtirb::UUID> FunctionLastBlocks;
+  /** The set of all symbols associated to a function.*/
+  std::set<const gtirb::Symbol*> FunctionSymbols;
+  /** Mapping from function names to aliases. These are computed depending on
+   * the file format.*/
+  std::map<const gtirb::Symbol*, std::set<const gtirb::Symbol*>>
+      FunctionAliases;
+};
+
+/// A part of a module's listing that can be assembled on its own and linked
+/// with the other parts (see \link PrettyPrinterBase::computeListingShards).
+struct ListingShard {
+  /** The sections printed in this part, in module order.*/
+  std::vector<const gtirb::Section*> Sections;
+  /** Symbols defined in these sections that the other parts refer to.*/
+  std::vector<const gtirb::Symbol*> Exports;
+  /** The integral symbols are defined in the primary part only.*/
+  bool Primary = false;
+};
+
 /// The pretty-printer interface. There is only one exposed function, \link
 /// print().
 class DEBLOAT_PRETTYPRINTER_EXPORT_API PrettyPrinterBase {
@@ -339,6 +524,110 @@ public:
 
   virtual std::ostream& print(std::ostream& out);
 
+  /// Write the token stream of the listing to Writer while printing. The
+  /// writer must outlive the call to print().
+  void setListingTokens(ListingTokenWriter* Writer) { Tokens = Writer; }
+
+  /// Record in Index where each section, function and block is printed. The
+  /// offsets are taken with tellp(), so nothing is recorded for streams that
+  /// do not support it.
+  void setListingIndex(ListingIndex* I) { Index = I; }
+
+  /// Report the time spent in print() and the work it does to S.
+  void setStatistics(Statistics* S) { Stats = S; }
+
+  /// Print only the blocks that overlap [Begin, End), along with the listing
+  /// header and footer, the integral symbols and the headers and footers of
+  /// their sections. The state that earlier blocks would have left behind
+  /// (the program counter used for overlapping blocks and open CFI
+  /// procedures) is restored first. Sections are printed with printSection,
+  /// as by print().
+  std::ostream& printRange(std::ostream& out, gtirb::Addr Begin,
+                           gtirb::Addr End);
+
+  /// Print only the blocks of a function, like \link printRange.
+  std::ostream& printFunction(std::ostream& out, const gtirb::UUID& Function);
+
+  /// Share the instructions decoded by this printer with the other printers
+  /// given the same cache. They must print the same module with the same
+  /// decoder configuration.
+  void setDecodeCache(DecodeCache* Cache) { Decoded = Cache; }
+
+  /// Use a symbol forwarding table resolved for this printer's module, e.g.
+  /// the one shared by \link PrettyPrinter::getSymbolForwarding. Without one,
+  /// the printer resolves its own on first use.
+  void setSymbolForwarding(
+      std::shared_ptr<const aux_data::SymbolForwardingTable> Table) {
+    Forwarding = std::move(Table);
+  }
+
+  /// The functions of this printer's module. They are computed on first use
+  /// unless they were shared with the printer by \link
+  /// setFunctionInformation.
+  std::shared_ptr<const FunctionInformation> functionInformation() const;
+
+  /// Use the function information of another printer of the same module and
+  /// file format instead of computing it again.
+  void setFunctionInformation(std::shared_ptr<const FunctionInformation> F) {
+    Functions = std::move(F);
+  }
+
+  /// Split the module into parts that can be assembled separately. Sections
+  /// are kept together when a function or a symbol difference spans them.
+  /// The first part is the primary one.
+  std::vector<ListingShard> computeListingShards();
+
+  /// Print each shard to the stream at the same position. Symbols referred
+  /// to by other shards are exported from their shard with
+  /// printShardExport.
+  void printShards(const std::vector<ListingShard>& Shards,
+                   const std::vector<std::ostream*>& Streams);
+
+  /// Print the module with each printer to its stream, block by block. The
+  /// printers must print the same module and be of the same file format; the
+  /// names given to ambiguous symbols are computed once for all of them.
+  using Output = std::pair<PrettyPrinterBase*, std::ostream*>;
+  static void printTogether(const std::vector<Output>& Outputs);
+
+  /// Whether the listing prints a block, or defines a symbol and refers to
+  /// it by name. References to symbols that are not printed are printed as
+  /// 0.
+  bool isPrinted(const gtirb::CodeBlock& Block) const {
+    return !shouldSkip(policy, Block);
+  }
+  bool isPrinted(const gtirb::DataBlock& Block) const {
+    return !shouldSkip(policy, Block);
+  }
+  bool isPrinted(const gtirb::Symbol& Symbol) const {
+    return !shouldSkip(policy, Symbol);
+  }
+
+  /// The alignment requested before a printed block that does not overlap
+  /// the block printed before it, if any.
+  std::optional<uint64_t> listingAlignment(const gtirb::CodeBlock& Block) {
+    return getAlignment(Block);
+  }
+  std::optional<uint64_t> listingAlignment(const gtirb::DataBlock& Block) {
+    return getAlignment(Block);
+  }
+
+  /// The names given to the symbols whose names are ambiguous in the module,
+  /// as printing computes them. Other symbols are printed with their names.
+  const std::unordered_map<const gtirb::Symbol*, std::string>&
+  listingNames() {
+    computeAmbiguousSymbols();
+    return AmbiguousSymbols;
+  }
+
+  /// Print the contents of a block as printing the module does, without its
+  /// label, its alignment or the directives around it.
+  void printContents(std::ostream& OS, const gtirb::CodeBlock& Block) {
+    printBlockContents(OS, Block, 0);
+  }
+  void printContents(std::ostream& OS, const gtirb::DataBlock& Block) {
+    printBlockContents(OS, Block, 0);
+  }
+
 protected:
   const Syntax& syntax;
   PrintingPolicy policy;
@@ -351,6 +640,11 @@ protected:
 
   virtual std::string getRegisterName(unsigned int reg) const;
 
+  /// Get the groups of an instruction. They are computed in a single pass
+  /// over the instruction details and reused for every operand of the same
+  /// instruction, instead of calling cs_insn_group for each operand.
+  const InsnGroups& getInsnGroups(const cs_insn& Insn);
+
   virtual void printBar(std::ostream& os, bool heavy = true);
   virtual void printHeader(std::ostream& os) = 0;
   virtual void printFooter(std::ostream& os) = 0;
@@ -388,6 +682,8 @@ protected:
                                   const gtirb::DataBlock& dataObject,
                                   uint64_t offset);
   virtual void printByte(std::ostream& os, std::byte byte) = 0;
+  // Print a directive that emits Count zero bytes.
+  virtual void printZeros(std::ostream& os, uint64_t Count);
 
   virtual void fixupInstruction(cs_insn& inst);
 
@@ -407,6 +703,13 @@ protected:
                                 const cs_insn& inst,
                                 const gtirb::Offset& offset);
 
+  // Record the mnemonic of an instruction and the operands printed to Line
+  // since OperandsStart in the listing token stream, if one is attached.
+  void recordInstructionTokens(std::string_view Mnemonic,
+                               const std::stringstream& Line,
+                               std::streampos OperandsStart);
+  void recordSymbolReference(const gtirb::Symbol& Symbol);
+
   virtual void printEA(std::ostream& os, gtirb::Addr ea);
   virtual void printOperandList(std::ostream& os, const gtirb::CodeBlock& block,
                                 const cs_insn& inst);
@@ -473,6 +776,8 @@ protected:
                                    const gtirb::Symbol& symbol) = 0;
   virtual void printUndefinedSymbol(std::ostream& os,
                                     const gtirb::Symbol& symbol) = 0;
+  // Make a symbol defined in this shard visible to the other shards.
+  virtual void printShardExport(std::ostream& os, const gtirb::Symbol& symbol);
   // This method assumes sections do not overlap
   const std::optional<const gtirb::Section*>
   getContainerSection(const gtirb::Addr addr) const;
@@ -488,15 +793,21 @@ protected:
       "Use getContainerFunctionSymbol instead.")]] std::optional<std::string>
   getContainerFunctionName(gtirb::Addr Addr) const;
   [[deprecated]] virtual std::string getFunctionName(gtirb::Addr x) const;
-  [[deprecated("Use attribute FunctionFirstBlocks instead.")]] bool
+  [[deprecated("Use functions().FunctionFirstBlocks instead.")]] bool
   isFunctionEntry(gtirb::Addr Addr) const;
-  [[deprecated("Use attribute FunctionLastBlocks instead.")]] bool
+  [[deprecated("Use functions().FunctionLastBlocks instead.")]] bool
   isFunctionLastBlock(gtirb::Addr Addr) const;
 
   virtual std::string getSymbolName(const gtirb::Symbol& symbol) const;
+  /// Get the printed name of a symbol. This is getSymbolName, computed once
+  /// per symbol and interned for the rest of the printing.
+  std::string_view getSymbolSpelling(const gtirb::Symbol& Symbol) const;
   virtual std::optional<std::string>
   getForwardedSymbolName(const gtirb::Symbol* symbol) const;
-  virtual gtirb::Symbol* getForwardedSymbol(const gtirb::Symbol* Sym) const;
+  virtual const gtirb::Symbol*
+  getForwardedSymbol(const gtirb::Symbol* Sym) const;
+  /// The module's symbol forwarding with its symbols resolved.
+  const aux_data::SymbolForwardingTable& symbolForwarding() const;
 
   virtual const gtirb::Symbol*
   getBestSymbol(const std::set<const gtirb::Symbol*, CmpSymPtr>& Symbols) const;
@@ -507,6 +818,10 @@ protected:
   // printCodeBlock, etc. doesn't bother to call this method.
   uint64_t getSymbolicExpressionSize(
       const gtirb::ByteInterval::ConstSymbolicExpressionElement& SEE) const;
+  // Size of a symbolic expression that has no `symbolicExpressionSizes'
+  // entry, derived from the data blocks at its offset.
+  uint64_t inferSymbolicExpressionSize(
+      const gtirb::ByteInterval::ConstSymbolicExpressionElement& SEE) const;
 
   std::optional<uint64_t> getAlignment(gtirb::Addr Addr) const;
 
@@ -531,14 +846,51 @@ private:
 
   template <typename BlockType>
   void printBlockImpl(std::ostream& OS, BlockType& Block);
+  void recordLabel(const gtirb::Symbol& Symbol, gtirb::Addr BlockAddr);
+
+  using BlockPredicate =
+      std::function<bool(const gtirb::Node&, gtirb::Addr, uint64_t)>;
+  // Print the module like print(), but only the blocks for which
+  // Selected(Block, Addr, Size) holds and the sections that contain them.
+  std::ostream& printBlocksIf(std::ostream& OS, BlockPredicate Selected);
+  // Reset the per-listing state and print the header, and print what follows
+  // the sections. Every way of printing the module goes through these.
+  void startListing(std::ostream& OS);
+  void finishListing(std::ostream& OS);
+  // printSection in steps, so that several printers can take turns on each
+  // block of a section. beginSection returns false if the section is skipped.
+  struct SectionProgress {
+    std::optional<uint64_t> Start;
+    bool Printed = false;
+  };
+  bool beginSection(std::ostream& OS, const gtirb::Section& Section,
+                    SectionProgress& Progress);
+  void printSectionBlock(std::ostream& OS, const gtirb::Section& Section,
+                         const gtirb::Node& Block, SectionProgress& Progress);
+  void endSection(std::ostream& OS, const gtirb::Section& Section,
+                  const SectionProgress& Progress);
+  // Update the printing state as if Block had been printed.
+  void skipBlock(const gtirb::Node& Block, gtirb::Addr Addr, uint64_t Size);
+
+  std::optional<uint64_t> listingOffset(std::ostream& OS) const;
+  template <typename BlockType>
+  void indexBlock(std::ostream& OS, const BlockType& Block,
+                  std::optional<uint64_t> Start);
+  void indexSection(std::ostream& OS, const gtirb::Section& Section,
+                    std::optional<uint64_t> Start);
 
   template <typename BlockType>
   std::optional<uint64_t> getAlignmentImpl(const BlockType& Block);
 
   static bool x86InstHasMoffsetEncoding(const cs_insn& inst);
 
+  /** The function information, computed on first use.*/
+  const FunctionInformation& functions() const;
   /** Populate Function-related fields.*/
-  void computeFunctionInformation();
+  void computeFunctionInformation(FunctionInformation& Info) const;
+  /** Add the aliases of the function symbols, which depend on the file
+   * format, to Info.FunctionAliases.*/
+  virtual void computeFunctionAliases(FunctionInformation& Info) const;
   /** Populate AmbiguousSymbols */
   void computeAmbiguousSymbols();
 
@@ -553,30 +905,40 @@ private:
   bool isFunctionSkipped(const PrintingPolicy& Policy,
                          const gtirb::Symbol& FunctionSymbol) const;
 
-  /** Mapping from function UUIDs to the symbols that define the function
-   * name.*/
-  std::map<gtirb::UUID, const gtirb::Symbol*> FunctionToSymbols;
-  /** Mapping from Block UUIDs to Function UUIDs.*/
-  std::map<gtirb::UUID, gtirb::UUID> BlockToFunction;
-  /** Set of blocks that are the first in each function.*/
-  std::set<gtirb::UUID> FunctionFirstBlocks;
-  /** Set of block UUIDS that are the last in each function.*/
-  std::set<gtirb::UUID> FunctionLastBlocks;
+  /** Position of each function's entry in the listing index.*/
+  std::map<gtirb::UUID, size_t> FunctionIndexEntries;
 
 protected:
-  [[deprecated("Use FunctionFirstBlocks instead.")]] std::set<gtirb::Addr>
-      functionEntry;
-  [[deprecated("Use FunctionLastBlocks instead.")]] std::set<gtirb::Addr>
-      functionLastBlock;
-
-  /** The set of all symbols associated to a function.*/
-  std::set<const gtirb::Symbol*> FunctionSymbols;
-  /** Mapping from function names to aliases. These are computed depending on
-   * the file format.*/
-  std::map<const gtirb::Symbol*, std::set<const gtirb::Symbol*>>
-      FunctionAliases;
-
-  std::map<const gtirb::Symbol*, std::string> AmbiguousSymbols;
+  std::unordered_map<const gtirb::Symbol*, std::string> AmbiguousSymbols;
+  /** Interned results of getSymbolName. The table is node-based, so views of
+   * the mapped strings stay valid as it grows.*/
+  mutable std::unordered_map<const gtirb::Symbol*, std::string>
+      SymbolSpellings;
+  /** The instruction whose groups are in CachedInsnGroups.*/
+  const cs_insn* CachedGroupsInsn = nullptr;
+  uint64_t CachedGroupsAddress = 0;
+  InsnGroups CachedInsnGroups;
+  /** The listing token stream, index and statistics, if any, and the block
+   * being printed.*/
+  ListingTokenWriter* Tokens = nullptr;
+  ListingIndex* Index = nullptr;
+  gtirb::UUID CurrentBlock{};
+  Statistics* Stats = nullptr;
+  DecodeCache* Decoded = nullptr;
+  /** Set by printBlocksIf: printSection leaves out the blocks it rejects,
+   * and the sections without any block it accepts.*/
+  BlockPredicate SelectedBlocks;
+  /** Cleared by printShards outside the primary shard, so that integral
+   * symbols are defined once.*/
+  bool DefineIntegralSymbols = true;
+  /** The resolved symbol forwarding, shared with the printer or built by it
+   * on first use.*/
+  mutable std::shared_ptr<const aux_data::SymbolForwardingTable> Forwarding;
+  /** The function information, shared with the printer or computed by it
+   * on first use.*/
+  mutable std::shared_ptr<const FunctionInformation> Functions;
+  /** Number of lines printed with printCommentableLine.*/
+  uint64_t LinesPrinted = 0;
   std::string m_accum_comment;
   static std::string s_symaddr_0_warning(uint64_t symAddr);
 };
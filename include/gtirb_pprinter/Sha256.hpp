@@ -0,0 +1,57 @@
+//===- Sha256.hpp -----------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PP_SHA256_H
+#define GTIRB_PP_SHA256_H
+
+#include "Export.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace gtirb_pprint {
+
+/// \brief Incremental SHA-256 (FIPS 180-4), for keying caches by content.
+class DEBLOAT_PRETTYPRINTER_EXPORT_API Sha256 {
+public:
+  void update(const void* Data, size_t Size);
+  void update(const std::string& S) { update(S.data(), S.size()); }
+
+  /// Finish the hash and return it as 64 hexadecimal digits. The object
+  /// must not be updated afterwards.
+  std::string hexDigest();
+
+  /// Return the hexadecimal SHA-256 of Data.
+  static std::string hexDigest(const std::string& Data) {
+    Sha256 Hash;
+    Hash.update(Data);
+    return Hash.hexDigest();
+  }
+
+private:
+  void compress();
+
+  std::array<uint32_t, 8> State{0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                0x1f83d9ab, 0x5be0cd19};
+  std::array<uint8_t, 64> Block{};
+  size_t Used = 0;
+  uint64_t Length = 0;
+};
+
+} // namespace gtirb_pprint
+
+#endif /* GTIRB_PP_SHA256_H */
@@ -0,0 +1,111 @@
+//===- Statistics.hpp -------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PP_STATISTICS_H
+#define GTIRB_PP_STATISTICS_H
+
+#include "Export.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gtirb_pprint {
+
+/// \brief Wall and CPU time of each phase of a run, and counters of the work
+/// done while printing, attributed to the module being processed.
+///
+/// Everything that reports to a Statistics object takes a pointer to it and
+/// does nothing if the pointer is null, so collection costs nothing unless it
+/// is requested. The CPU time of a phase is that of the thread that timed it,
+/// so phases running concurrently on other threads are not counted in it.
+/// Time spent in external tools (assemblers, linkers) only shows up as wall
+/// time. Counters may be incremented from any thread.
+class DEBLOAT_PRETTYPRINTER_EXPORT_API Statistics {
+public:
+  enum class Counter {
+    InstructionsDecoded,
+    DataLines,
+    SymbolicExpressions,
+    BytesWritten,
+    ObjectCacheHits,
+    ObjectCacheMisses,
+  };
+  static constexpr size_t NumCounters = 6;
+
+  Statistics() = default;
+  Statistics(const Statistics&) = delete;
+  Statistics& operator=(const Statistics&) = delete;
+
+  /// Record the time from construction to destruction as a phase of the
+  /// module that is current at construction. Does nothing if S is null.
+  class DEBLOAT_PRETTYPRINTER_EXPORT_API Timer {
+  public:
+    Timer(Statistics* S, std::string Phase);
+    ~Timer();
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+  private:
+    Statistics* Stats;
+    std::string Phase;
+    std::string Module;
+    std::chrono::steady_clock::time_point WallStart;
+    double CpuStart = 0;
+  };
+
+  /// Attribute the phases and counts that follow to the named module. An
+  /// empty name is used for work that is not specific to a module. Must not
+  /// be called concurrently with itself or with writeJSON.
+  void setModule(const std::string& Name);
+
+  void add(Counter C, uint64_t N = 1) {
+    (*CurrentCounts.load())[size_t(C)].fetch_add(N,
+                                                 std::memory_order_relaxed);
+  }
+
+  /// Write the statistics as a JSON object with a "phases" array, in the
+  /// order the phases ended, and a "modules" object with the counters of
+  /// each module.
+  void writeJSON(std::ostream& Stream) const;
+
+private:
+  struct PhaseRecord {
+    std::string Name;
+    std::string Module;
+    double WallSeconds;
+    double CpuSeconds;
+  };
+
+  /// Phases may end on other threads, e.g. the link preparation of the ELF
+  /// binary printer.
+  std::mutex PhasesMutex;
+  std::vector<PhaseRecord> Phases;
+  using CounterArray = std::array<std::atomic<uint64_t>, NumCounters>;
+  /// Nodes of the map are never erased, so pointers to them stay valid.
+  std::map<std::string, CounterArray> Counts;
+  std::string Module;
+  std::atomic<CounterArray*> CurrentCounts{&Counts[std::string()]};
+};
+
+} // namespace gtirb_pprint
+
+#endif /* GTIRB_PP_STATISTICS_H */
@@ -16,9 +16,11 @@
 #define GTIRB_PP_SYNTAX_H
 
 #include "Export.hpp"
+#include "NumberFormat.hpp"
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace gtirb_pprint {
 
@@ -40,6 +42,7 @@ public:
   virtual SyntaxAlignmentStyle alignmentStyle() const {
     return SyntaxAlignmentBytes;
   }
+  virtual const HexFormat& hexFormat() const { return CHexFormat; }
 
   // Sections
   virtual const std::string& textSection() const { return TextSection; }
@@ -72,6 +75,10 @@ public:
   virtual std::string formatSymbolName(const std::string& x) const;
   virtual std::string avoidRegNameConflicts(const std::string& x) const;
   virtual std::string escapeByte(uint8_t b) const;
+  // Append the escaped form of Bytes to Buf. Runs of bytes that escapeByte
+  // prints verbatim are copied in bulk; dialects that override escapeByte
+  // must override this as well.
+  virtual void escapeString(std::string& Buf, std::string_view Bytes) const;
   virtual std::optional<std::string> getSizeName(uint64_t bits) const;
 
 protected:
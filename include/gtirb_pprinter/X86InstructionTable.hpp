@@ -0,0 +1,158 @@
+//===- X86InstructionTable.hpp ----------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PP_X86_INSTRUCTION_TABLE_H
+#define GTIRB_PP_X86_INSTRUCTION_TABLE_H
+
+#include "Export.hpp"
+
+#include <array>
+#include <capstone/capstone.h>
+#include <cstdint>
+#include <initializer_list>
+
+namespace gtirb_pprint {
+namespace x86 {
+
+/// Properties of an x86 instruction that the printers need to know about
+/// while fixing up and printing instructions decoded by Capstone.
+enum InsnFlag : uint16_t {
+  /// MOVS*: operands are implicit (except for the SSE2 MOVSD).
+  ImplicitStringOperands = 1 << 0,
+  /// STOS*: the register operand is implicit.
+  ImplicitStoreRegister = 1 << 1,
+  /// IMUL: the third operand is signed, but it is decoded as unsigned.
+  SignedThirdImmediate = 1 << 2,
+  /// FXCH: the first operand st(0) is implicit.
+  ImplicitFirstStackRegister = 1 << 3,
+  /// COMISD: loads 64 bits from memory, not 128.
+  Mem64Operand = 1 << 4,
+  /// COMISS: loads 32 bits from memory, not 64.
+  Mem32Operand = 1 << 5,
+  /// PUNPCKL*: memory operands are 32 bits, not 64.
+  Mem32PackedOperand = 1 << 6,
+  /// FXSAVE, XSAVE, ...: the memory operand has no size annotation.
+  UnsizedOperand = 1 << 7,
+  /// RDRAND, RDSEED, INT1, INT3: the mnemonic is rewritten.
+  RewriteMnemonic = 1 << 8,
+  /// AVX-512 instructions whose k registers are not printed in braces.
+  UnbracketedKMask = 1 << 9,
+  /// AVX-512 instructions where only the second k register is in braces,
+  /// e.g. vpcmpnequb (%rdi),%ymm18,%k1{%k2}
+  BracketedSecondKMask = 1 << 10,
+};
+
+/// Flags that require fixupInstruction to do some work.
+constexpr uint16_t FixupFlags =
+    ImplicitStringOperands | ImplicitStoreRegister | SignedThirdImmediate |
+    ImplicitFirstStackRegister | Mem64Operand | Mem32Operand |
+    Mem32PackedOperand | UnsizedOperand | RewriteMnemonic;
+
+using InsnFlagTable = std::array<uint16_t, X86_INS_ENDING>;
+
+namespace detail {
+
+constexpr void setFlag(InsnFlagTable& Table,
+                       std::initializer_list<x86_insn> Insns, uint16_t Flag) {
+  for (x86_insn Insn : Insns) {
+    Table[Insn] |= Flag;
+  }
+}
+
+constexpr InsnFlagTable makeInsnFlagTable() {
+  InsnFlagTable Table{};
+  setFlag(Table,
+          {X86_INS_MOVSB, X86_INS_MOVSW, X86_INS_MOVSD, X86_INS_MOVSQ},
+          ImplicitStringOperands);
+  setFlag(Table,
+          {X86_INS_STOSB, X86_INS_STOSW, X86_INS_STOSD, X86_INS_STOSQ},
+          ImplicitStoreRegister);
+  setFlag(Table, {X86_INS_IMUL}, SignedThirdImmediate);
+  setFlag(Table, {X86_INS_FXCH}, ImplicitFirstStackRegister);
+  setFlag(Table, {X86_INS_COMISD, X86_INS_VCOMISD}, Mem64Operand);
+  setFlag(Table, {X86_INS_COMISS, X86_INS_VCOMISS}, Mem32Operand);
+  setFlag(Table, {X86_INS_PUNPCKLWD, X86_INS_PUNPCKLBW, X86_INS_PUNPCKLDQ},
+          Mem32PackedOperand);
+  setFlag(Table,
+          {X86_INS_FXSAVE, X86_INS_XSAVE, X86_INS_XSAVEC, X86_INS_FXRSTOR,
+           X86_INS_XRSTOR},
+          UnsizedOperand);
+  setFlag(Table,
+          {X86_INS_RDRAND, X86_INS_RDSEED, X86_INS_INT1, X86_INS_INT3},
+          RewriteMnemonic);
+
+  // Some instructions don't put commas between their operands, but instead
+  // put it in between {}s. These instructions are always AVX512 instructions
+  // when you use the k registers. Not all AVX512 instructions use the k
+  // registers in this manner, however.
+  // TODO: find an exhaustive list of such instructions, or find a way for
+  // Capstone to tell us this information directly.
+  setFlag(Table,
+          {
+              X86_INS_KANDNB,   X86_INS_KANDNW,   X86_INS_KANDND,
+              X86_INS_KANDNQ,   X86_INS_KMOVB,    X86_INS_KMOVW,
+              X86_INS_KMOVD,    X86_INS_KMOVQ,    X86_INS_KUNPCKBW,
+              X86_INS_KNOTB,    X86_INS_KNOTW,    X86_INS_KNOTD,
+              X86_INS_KNOTQ,    X86_INS_KORB,     X86_INS_KORW,
+              X86_INS_KORD,     X86_INS_KORQ,     X86_INS_KORTESTB,
+              X86_INS_KORTESTW, X86_INS_KORTESTD, X86_INS_KORTESTQ,
+              X86_INS_KSHIFTLB, X86_INS_KSHIFTLW, X86_INS_KSHIFTLD,
+              X86_INS_KSHIFTLQ, X86_INS_KSHIFTRB, X86_INS_KSHIFTRW,
+              X86_INS_KSHIFTRD, X86_INS_KSHIFTRQ, X86_INS_KXNORB,
+              X86_INS_KXNORW,   X86_INS_KXNORD,   X86_INS_KXNORQ,
+              X86_INS_KXORB,    X86_INS_KXORW,    X86_INS_KXORD,
+              X86_INS_KXORQ,
+#if CS_API_MAJOR >= 5
+              X86_INS_KUNPCKDQ, X86_INS_KUNPCKWD, X86_INS_KADDB,
+              X86_INS_KADDW,    X86_INS_KADDD,    X86_INS_KADDQ,
+              X86_INS_KTESTB,   X86_INS_KTESTW,   X86_INS_KTESTD,
+              X86_INS_KTESTQ,   X86_INS_VPCMPESTRI,
+#endif
+          },
+          UnbracketedKMask);
+  setFlag(Table,
+          {
+              X86_INS_VPCMPB,    X86_INS_VPCMPD,    X86_INS_VPCMPQ,
+              X86_INS_VPCMPW,    X86_INS_VPCMPUB,   X86_INS_VPCMPUD,
+              X86_INS_VPCMPUQ,   X86_INS_VPCMPUW,   X86_INS_VPCMPEQB,
+              X86_INS_VPCMPEQD,  X86_INS_VPCMPEQQ,  X86_INS_VPCMPEQW,
+              X86_INS_VPCMPGTB,  X86_INS_VPCMPGTD,  X86_INS_VPCMPGTQ,
+              X86_INS_VPCMPGTW,  X86_INS_VPTEST,    X86_INS_VPTESTMB,
+              X86_INS_VPTESTMD,  X86_INS_VPTESTMQ,  X86_INS_VPTESTMW,
+              X86_INS_VPTESTNMB, X86_INS_VPTESTNMD, X86_INS_VPTESTNMQ,
+              X86_INS_VPTESTNMW,
+          },
+          BracketedSecondKMask);
+  return Table;
+}
+
+} // namespace detail
+
+/// Flags of every x86_insn, built at compile time.
+inline constexpr InsnFlagTable InsnFlags = detail::makeInsnFlagTable();
+
+/// Get the flags of an instruction from its Capstone id.
+constexpr uint16_t getInsnFlags(unsigned int Id) {
+  return Id < InsnFlags.size() ? InsnFlags[Id] : 0;
+}
+
+/// Apply the fixups shared by every x86 syntax to an instruction decoded by
+/// Capstone. Instructions without any of the FixupFlags are left untouched
+/// after a single table lookup.
+DEBLOAT_PRETTYPRINTER_EXPORT_API void fixupInstruction(cs_insn& Insn);
+
+} // namespace x86
+} // namespace gtirb_pprint
+
+#endif /* GTIRB_PP_X86_INSTRUCTION_TABLE_H */
@@ -0,0 +1,540 @@
+// Native extension of the gtirb_pprinter Python package: prints modules of
+// IRs held in memory without running the gtirb-pprinter executable.
+//
+// IRs are loaded once from a serialized buffer and can then be printed any
+// number of times, from any number of threads. The GIL is released while
+// loading and printing.
+//
+// Printing rewrites a module first (layout, binary type and fixups), and the
+// rewrite depends on some of the printer options. So that the output of a
+// call never depends on earlier calls, each set of those options gets its own
+// copy of the IR, loaded from the serialized buffer on first use. At most
+// MaxCopies copies are kept: the least recently used one is unloaded once the
+// calls using it return, and loaded again when needed.
+//
+// A module of a copy is rewritten once, under an exclusive lock of the copy,
+// since the rewrite inserts nodes into its Context; printing holds the lock
+// shared, and is serialized per module, as printing a module loads its
+// AuxData.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <gtirb/gtirb.hpp>
+#include <gtirb_layout/gtirb_layout.hpp>
+#include <gtirb_pprinter/ElfBinaryPrinter.hpp>
+#include <gtirb_pprinter/Fixup.hpp>
+#include <gtirb_pprinter/PeBinaryPrinter.hpp>
+#include <gtirb_pprinter/PrettyPrinter.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A copy of a resident IR, rewritten for one set of rewrite options.
+struct IRCopy {
+  gtirb::Context Context;
+  gtirb::IR* IR = nullptr;
+  std::shared_mutex Lock;
+  std::set<size_t> Rewritten;
+  std::map<size_t, std::mutex> ModuleMutexes;
+  // When the copy was last used, counted in calls.
+  uint64_t LastUse = 0;
+
+  gtirb::Module& module(size_t Index) {
+    return *std::next(IR->modules().begin(), Index);
+  }
+};
+
+struct ResidentIR {
+  std::string Data;
+  std::vector<std::string> ModuleNames;
+  // The copy loaded to validate the data, until the first options use it.
+  std::unique_ptr<IRCopy> Spare;
+  std::mutex CopiesMutex;
+  std::map<std::string, std::shared_ptr<IRCopy>> Copies;
+  uint64_t Uses = 0;
+};
+
+// The number of copies of an IR kept loaded, as with the default of the
+// driver's --server-max-irs.
+constexpr size_t MaxCopies = 4;
+
+struct IRObject {
+  PyObject_HEAD ResidentIR* Resident;
+};
+
+struct MemoryBuffer : std::streambuf {
+  MemoryBuffer(const void* Data, size_t Size) {
+    char* Begin = static_cast<char*>(const_cast<void*>(Data));
+    setg(Begin, Begin, Begin + Size);
+  }
+};
+
+std::unique_ptr<IRCopy> loadCopy(const std::string& Data) {
+  auto Copy = std::make_unique<IRCopy>();
+  MemoryBuffer Memory(Data.data(), Data.size());
+  std::istream Stream(&Memory);
+  gtirb::ErrorOr<gtirb::IR*> IR = gtirb::IR::load(Copy->Context, Stream);
+  if (!IR)
+    return nullptr;
+  Copy->IR = *IR;
+  size_t Modules = std::distance(Copy->IR->modules().begin(),
+                                 Copy->IR->modules().end());
+  for (size_t I = 0; I < Modules; ++I)
+    Copy->ModuleMutexes[I];
+  return Copy;
+}
+
+// Printer options, read from the keyword arguments of the Python wrappers
+// while holding the GIL.
+struct PrintOptions {
+  std::string Format;
+  std::string Syntax;
+  std::string Policy;
+  std::string ListingMode;
+  std::string Shared = "auto";
+  bool KeepAll = false;
+  bool IgnoreSymbolVersions = false;
+  std::vector<std::string> KeepFunctions, SkipFunctions;
+  std::vector<std::string> KeepSymbols, SkipSymbols;
+  std::vector<std::string> KeepSections, SkipSections;
+
+  // Binary printing only.
+  std::string Compiler;
+  std::vector<std::string> CompilerArgs;
+  std::vector<std::string> LibraryPaths;
+  bool DummySO = false;
+  bool BuiltinAssembler = false;
+};
+
+bool getString(PyObject* Dict, const char* Key, std::string& Value) {
+  PyObject* Item = PyDict_GetItemString(Dict, Key);
+  if (!Item || Item == Py_None)
+    return true;
+  const char* Text = PyUnicode_AsUTF8(Item);
+  if (!Text)
+    return false;
+  Value = Text;
+  return true;
+}
+
+bool getBool(PyObject* Dict, const char* Key, bool& Value) {
+  PyObject* Item = PyDict_GetItemString(Dict, Key);
+  if (!Item)
+    return true;
+  int Truth = PyObject_IsTrue(Item);
+  if (Truth < 0)
+    return false;
+  Value = Truth;
+  return true;
+}
+
+bool getStrings(PyObject* Dict, const char* Key,
+                std::vector<std::string>& Values) {
+  PyObject* Item = PyDict_GetItemString(Dict, Key);
+  if (!Item || Item == Py_None)
+    return true;
+  PyObject* Sequence = PySequence_Fast(Item, "expected a sequence of str");
+  if (!Sequence)
+    return false;
+  Py_ssize_t Size = PySequence_Fast_GET_SIZE(Sequence);
+  for (Py_ssize_t I = 0; I < Size; ++I) {
+    const char* Text =
+        PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(Sequence, I));
+    if (!Text) {
+      Py_DECREF(Sequence);
+      return false;
+    }
+    Values.emplace_back(Text);
+  }
+  Py_DECREF(Sequence);
+  return true;
+}
+
+bool getOptions(PyObject* Dict, PrintOptions& O) {
+  if (!PyDict_Check(Dict)) {
+    PyErr_SetString(PyExc_TypeError, "options must be a dict");
+    return false;
+  }
+  return getString(Dict, "format", O.Format) &&
+         getString(Dict, "syntax", O.Syntax) &&
+         getString(Dict, "policy", O.Policy) &&
+         getString(Dict, "listing_mode", O.ListingMode) &&
+         getString(Dict, "shared", O.Shared) &&
+         getBool(Dict, "keep_all", O.KeepAll) &&
+         getBool(Dict, "ignore_symbol_versions", O.IgnoreSymbolVersions) &&
+         getStrings(Dict, "keep_functions", O.KeepFunctions) &&
+         getStrings(Dict, "skip_functions", O.SkipFunctions) &&
+         getStrings(Dict, "keep_symbols", O.KeepSymbols) &&
+         getStrings(Dict, "skip_symbols", O.SkipSymbols) &&
+         getStrings(Dict, "keep_sections", O.KeepSections) &&
+         getStrings(Dict, "skip_sections", O.SkipSections) &&
+         getString(Dict, "compiler", O.Compiler) &&
+         getStrings(Dict, "compiler_args", O.CompilerArgs) &&
+         getStrings(Dict, "library_paths", O.LibraryPaths) &&
+         getBool(Dict, "dummy_so", O.DummySO) &&
+         getBool(Dict, "builtin_assembler", O.BuiltinAssembler);
+}
+
+// Configure Printer for Module as the gtirb-pprinter driver does. Returns an
+// error message, or an empty string on success.
+std::string configure(gtirb_pprint::PrettyPrinter& Printer,
+                      const gtirb::Module& Module, const PrintOptions& O) {
+  if (!Printer.setListingMode(O.ListingMode))
+    return "invalid listing mode: " + O.ListingMode;
+  std::string Format =
+      O.Format.empty() ? gtirb_pprint::getModuleFileFormat(Module) : O.Format;
+  std::string ISA = gtirb_pprint::getModuleISA(Module);
+  std::string Syntax =
+      O.Syntax.empty()
+          ? gtirb_pprint::getDefaultSyntax(Format, ISA, O.ListingMode)
+                .value_or("")
+          : O.Syntax;
+  auto Target = std::make_tuple(Format, ISA, Syntax);
+  if (gtirb_pprint::getRegisteredTargets().count(Target) == 0)
+    return "unsupported combination: format \"" + Format + "\" ISA \"" + ISA +
+           "\" and syntax \"" + Syntax + "\"";
+  Printer.setTarget(std::move(Target));
+
+  if (!O.Policy.empty() && O.Policy != "default") {
+    if (!Printer.namedPolicyExists(O.Policy))
+      return "unknown policy: " + O.Policy;
+    Printer.setPolicyName(O.Policy);
+  }
+  if (O.KeepAll) {
+    Printer.functionPolicy().useDefaults(false);
+    Printer.symbolPolicy().useDefaults(false);
+    Printer.sectionPolicy().useDefaults(false);
+    Printer.arraySectionPolicy().useDefaults(false);
+  }
+  for (const auto& S : O.KeepFunctions)
+    Printer.functionPolicy().keep(S);
+  for (const auto& S : O.SkipFunctions)
+    Printer.functionPolicy().skip(S);
+  for (const auto& S : O.KeepSymbols)
+    Printer.symbolPolicy().keep(S);
+  for (const auto& S : O.SkipSymbols)
+    Printer.symbolPolicy().skip(S);
+  for (const auto& S : O.KeepSections)
+    Printer.sectionPolicy().keep(S);
+  for (const auto& S : O.SkipSections)
+    Printer.sectionPolicy().skip(S);
+  if (O.Shared != "yes" && O.Shared != "no" && O.Shared != "auto")
+    return "invalid option for 'shared': " + O.Shared;
+  Printer.setIgnoreSymbolVersions(O.IgnoreSymbolVersions);
+  return "";
+}
+
+// The options that the rewrite of a module depends on.
+std::string rewriteKey(const PrintOptions& O) {
+  std::string Key = O.Format + '\0' + O.Shared + '\0' + O.Policy + '\0' +
+                    (O.KeepAll ? "1" : "0");
+  for (const auto* Sections : {&O.KeepSections, &O.SkipSections}) {
+    Key += '\0';
+    for (const auto& S : *Sections)
+      Key += S + '\n';
+  }
+  return Key;
+}
+
+// Return the copy of the IR for the given rewrite options, loading it on
+// first use, and unload the least recently used copies beyond MaxCopies.
+// Returns nullptr if it could not be loaded.
+std::shared_ptr<IRCopy> getCopy(ResidentIR& Resident, const std::string& Key) {
+  std::lock_guard<std::mutex> Lock(Resident.CopiesMutex);
+  auto& Copy = Resident.Copies[Key];
+  if (!Copy)
+    Copy = Resident.Spare ? std::move(Resident.Spare)
+                          : loadCopy(Resident.Data);
+  if (!Copy) {
+    Resident.Copies.erase(Key);
+    return nullptr;
+  }
+  Copy->LastUse = ++Resident.Uses;
+  std::shared_ptr<IRCopy> Result = Copy;
+  while (Resident.Copies.size() > MaxCopies) {
+    auto Oldest = std::min_element(
+        Resident.Copies.begin(), Resident.Copies.end(),
+        [](const auto& A, const auto& B) {
+          return A.second->LastUse < B.second->LastUse;
+        });
+    // Calls still using the copy keep it alive until they return.
+    Resident.Copies.erase(Oldest);
+  }
+  return Result;
+}
+
+// Lay out and fix up Module for printing, as the driver does.
+void rewriteModule(gtirb::Context& Context, gtirb::Module& Module,
+                   gtirb_pprint::PrettyPrinter& Printer,
+                   const std::string& Shared) {
+  auto SkipSections = Printer.getPolicy(Module).skipSections;
+  Printer.sectionPolicy().apply(SkipSections);
+  if (gtirb_layout::layoutRequired(Module, SkipSections)) {
+    gtirb_layout::layoutModule(Context, Module);
+  } else if (std::any_of(Module.symbols_begin(), Module.symbols_end(),
+                         [](const gtirb::Symbol& Sym) {
+                           return !Sym.hasReferent() && Sym.getAddress();
+                         })) {
+    gtirb_layout::fixIntegralSymbols(Context, Module);
+  }
+  Printer.updateDynMode(Module, Shared);
+  gtirb_pprint::applyFixups(Context, Module, Printer);
+}
+
+// Rewrite a module of Copy for printing unless it already is, and return
+// holding Copy's lock shared, for printing.
+std::shared_lock<std::shared_mutex>
+rewrite(IRCopy& Copy, size_t Index, gtirb_pprint::PrettyPrinter& Printer,
+        const std::string& Shared) {
+  {
+    std::unique_lock<std::shared_mutex> Exclusive(Copy.Lock);
+    if (!Copy.Rewritten.count(Index)) {
+      rewriteModule(Copy.Context, Copy.module(Index), Printer, Shared);
+      Copy.Rewritten.insert(Index);
+    }
+  }
+  return std::shared_lock<std::shared_mutex>(Copy.Lock);
+}
+
+PyObject* IR_new(PyTypeObject* Type, PyObject* Args, PyObject*) {
+  Py_buffer Buffer;
+  if (!PyArg_ParseTuple(Args, "y*", &Buffer))
+    return nullptr;
+  auto Resident = std::make_unique<ResidentIR>();
+  Py_BEGIN_ALLOW_THREADS;
+  Resident->Data.assign(static_cast<const char*>(Buffer.buf),
+                        static_cast<size_t>(Buffer.len));
+  if ((Resident->Spare = loadCopy(Resident->Data))) {
+    for (const auto& Module : Resident->Spare->IR->modules())
+      Resident->ModuleNames.push_back(Module.getName());
+  }
+  Py_END_ALLOW_THREADS;
+  PyBuffer_Release(&Buffer);
+  if (!Resident->Spare) {
+    PyErr_SetString(PyExc_ValueError, "could not load the GTIRB data");
+    return nullptr;
+  }
+  auto* Self = reinterpret_cast<IRObject*>(Type->tp_alloc(Type, 0));
+  if (Self)
+    Self->Resident = Resident.release();
+  return reinterpret_cast<PyObject*>(Self);
+}
+
+void IR_dealloc(IRObject* Self) {
+  PyTypeObject* Type = Py_TYPE(Self);
+  delete Self->Resident;
+  Type->tp_free(reinterpret_cast<PyObject*>(Self));
+  Py_DECREF(Type);
+}
+
+PyObject* IR_module_names(IRObject* Self, PyObject*) {
+  PyObject* Names = PyList_New(0);
+  if (!Names)
+    return nullptr;
+  for (const auto& ModuleName : Self->Resident->ModuleNames) {
+    PyObject* Name =
+        PyUnicode_FromStringAndSize(ModuleName.data(), ModuleName.size());
+    if (!Name || PyList_Append(Names, Name) != 0) {
+      Py_XDECREF(Name);
+      Py_DECREF(Names);
+      return nullptr;
+    }
+    Py_DECREF(Name);
+  }
+  return Names;
+}
+
+PyMethodDef IRMethods[] = {
+    {"module_names", reinterpret_cast<PyCFunction>(IR_module_names),
+     METH_NOARGS, "Return the names of the modules of the IR."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyType_Slot IRSlots[] = {
+    {Py_tp_new, reinterpret_cast<void*>(IR_new)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(IR_dealloc)},
+    {Py_tp_methods, IRMethods},
+    {Py_tp_doc, const_cast<char*>("IR(data: bytes)\n\nAn IR loaded from its "
+                                  "serialized form and kept in memory.")},
+    {0, nullptr}};
+
+PyType_Spec IRSpec = {"gtirb_pprinter._native.IR", sizeof(IRObject), 0,
+                      Py_TPFLAGS_DEFAULT, IRSlots};
+
+PyTypeObject* IRType = nullptr;
+
+// Find the position of a module of an IR object given by its index or name.
+// Returns false, with a Python exception set, if there is none.
+bool getModule(PyObject* Object, PyObject* Selector, ResidentIR*& Resident,
+               size_t& Index) {
+  if (!PyObject_TypeCheck(Object, IRType)) {
+    PyErr_SetString(PyExc_TypeError, "expected a resident IR");
+    return false;
+  }
+  Resident = reinterpret_cast<IRObject*>(Object)->Resident;
+  const auto& Names = Resident->ModuleNames;
+  if (PyLong_Check(Selector)) {
+    Py_ssize_t I = PyLong_AsSsize_t(Selector);
+    if (I >= 0 && static_cast<size_t>(I) < Names.size()) {
+      Index = static_cast<size_t>(I);
+      return true;
+    }
+  } else if (const char* Name = PyUnicode_AsUTF8(Selector)) {
+    auto It = std::find(Names.begin(), Names.end(), Name);
+    if (It != Names.end()) {
+      Index = static_cast<size_t>(It - Names.begin());
+      return true;
+    }
+  } else {
+    return false;
+  }
+  PyErr_SetString(PyExc_KeyError, "no such module");
+  return false;
+}
+
+PyObject* printModule(PyObject*, PyObject* Args) {
+  PyObject *IRArg, *Selector, *Dict;
+  if (!PyArg_ParseTuple(Args, "OOO", &IRArg, &Selector, &Dict))
+    return nullptr;
+  ResidentIR* Resident;
+  size_t Index;
+  PrintOptions Options;
+  if (!getModule(IRArg, Selector, Resident, Index) ||
+      !getOptions(Dict, Options))
+    return nullptr;
+
+  std::string Error, Listing;
+  Py_BEGIN_ALLOW_THREADS;
+  try {
+    std::shared_ptr<IRCopy> Copy = getCopy(*Resident, rewriteKey(Options));
+    gtirb_pprint::PrettyPrinter Printer;
+    if (!Copy)
+      Error = "could not load the GTIRB data";
+    else
+      Error = configure(Printer, Copy->module(Index), Options);
+    if (Error.empty()) {
+      auto Lock = rewrite(*Copy, Index, Printer, Options.Shared);
+      std::lock_guard<std::mutex> ModuleLock(Copy->ModuleMutexes.at(Index));
+      gtirb::Module& Module = Copy->module(Index);
+      std::ostringstream Stream;
+      if (Printer.print(Stream, Copy->Context, Module) != 0)
+        Error = "could not print module " + Module.getName();
+      Listing = Stream.str();
+    }
+  } catch (const std::exception& E) {
+    Error = E.what();
+  }
+  Py_END_ALLOW_THREADS;
+  if (!Error.empty()) {
+    PyErr_SetString(PyExc_RuntimeError, Error.c_str());
+    return nullptr;
+  }
+  return PyBytes_FromStringAndSize(Listing.data(), Listing.size());
+}
+
+PyObject* binaryPrintModule(PyObject*, PyObject* Args) {
+  PyObject *IRArg, *Selector, *Dict;
+  const char *Kind, *Output;
+  int Link;
+  if (!PyArg_ParseTuple(Args, "OOOssp", &IRArg, &Selector, &Dict, &Kind,
+                        &Output, &Link))
+    return nullptr;
+  ResidentIR* Resident;
+  size_t Index;
+  PrintOptions Options;
+  if (!getModule(IRArg, Selector, Resident, Index) ||
+      !getOptions(Dict, Options))
+    return nullptr;
+  std::string BinaryKind = Kind, OutputPath = Output;
+
+  std::string Error;
+  Py_BEGIN_ALLOW_THREADS;
+  try {
+    std::shared_ptr<IRCopy> Copy = getCopy(*Resident, rewriteKey(Options));
+    gtirb_pprint::PrettyPrinter Printer;
+    if (!Copy)
+      Error = "could not load the GTIRB data";
+    else
+      Error = configure(Printer, Copy->module(Index), Options);
+    std::unique_ptr<gtirb_bprint::BinaryPrinter> BinaryPrinter;
+    if (BinaryKind == "elf")
+      BinaryPrinter = std::make_unique<gtirb_bprint::ElfBinaryPrinter>(
+          Printer, Options.Compiler, Options.CompilerArgs,
+          Options.LibraryPaths, false, Options.DummySO,
+          Options.BuiltinAssembler);
+    else if (BinaryKind == "pe")
+      BinaryPrinter = std::make_unique<gtirb_bprint::PeBinaryPrinter>(
+          Printer, Options.CompilerArgs, Options.LibraryPaths);
+    else if (Error.empty())
+      Error = "unsupported binary format: " + BinaryKind;
+    if (Error.empty()) {
+      auto Lock = rewrite(*Copy, Index, Printer, Options.Shared);
+      std::lock_guard<std::mutex> ModuleLock(Copy->ModuleMutexes.at(Index));
+      gtirb::Module& Module = Copy->module(Index);
+      int Errc =
+          Link ? BinaryPrinter->link(OutputPath, Copy->Context, Module)
+               : BinaryPrinter->assemble(OutputPath, Copy->Context, Module);
+      if (Errc)
+        Error = "unable to assemble '" + OutputPath + "'";
+    }
+  } catch (const std::exception& E) {
+    Error = E.what();
+  }
+  Py_END_ALLOW_THREADS;
+  if (!Error.empty()) {
+    PyErr_SetString(PyExc_RuntimeError, Error.c_str());
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+PyMethodDef Methods[] = {
+    {"print_module", printModule, METH_VARARGS,
+     "print_module(ir, module, options) -> bytes\n\n"
+     "Print a module of a resident IR and return the listing."},
+    {"binary_print_module", binaryPrintModule, METH_VARARGS,
+     "binary_print_module(ir, module, options, kind, output, link)\n\n"
+     "Assemble, and link if requested, a module of a resident IR."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyModuleDef ModuleDef = {PyModuleDef_HEAD_INIT,
+                         "_native",
+                         "In-process printing of GTIRB modules.",
+                         -1,
+                         Methods,
+                         nullptr,
+                         nullptr,
+                         nullptr,
+                         nullptr};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit__native() {
+  IRType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&IRSpec));
+  if (!IRType)
+    return nullptr;
+
+  gtirb_layout::registerAuxDataTypes();
+  gtirb_pprint::registerAuxDataTypes();
+  gtirb_pprint::registerPrettyPrinters();
+
+  PyObject* Module = PyModule_Create(&ModuleDef);
+  if (!Module)
+    return nullptr;
+  Py_INCREF(IRType);
+  if (PyModule_AddObject(Module, "IR", reinterpret_cast<PyObject*>(IRType))) {
+    Py_DECREF(IRType);
+    Py_DECREF(Module);
+    return nullptr;
+  }
+  return Module;
+}
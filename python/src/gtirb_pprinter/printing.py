@@ -0,0 +1,203 @@
+"""
+In-process printing of GTIRB modules through the native extension.
+
+An IR is deserialized once into a ResidentIR and can then be printed any
+number of times, from several threads at once: the GIL is released while
+loading and printing.
+
+Printing lays out and fixes up the module first, as gtirb-pprinter does, and
+the result depends on the format, shared, policy, keep_all and section
+options. A ResidentIR keeps a separate copy of the IR for each combination
+of these options that is printed with, so the output of a call does not
+depend on earlier calls.
+"""
+
+import io
+from typing import Dict, Iterable, List, Optional, Union
+
+import gtirb
+
+from . import _native  # type: ignore
+
+__all__ = [
+    "ResidentIR",
+    "PrettyPrinter",
+    "ElfBinaryPrinter",
+    "PeBinaryPrinter",
+]
+
+ModuleSelector = Union[int, str]
+
+
+class ResidentIR:
+    """
+    An IR held in native memory.
+    """
+
+    def __init__(self, data: Union[bytes, bytearray, memoryview]):
+        """
+        Load an IR from its serialized (protobuf) form.
+        """
+        self._ir = _native.IR(data)
+
+    @classmethod
+    def from_ir(cls, ir: gtirb.IR) -> "ResidentIR":
+        """
+        Load a copy of a gtirb.IR.
+        """
+        buffer = io.BytesIO()
+        ir.save_protobuf_to_file(buffer)
+        return cls(buffer.getbuffer())
+
+    @property
+    def module_names(self) -> List[str]:
+        return self._ir.module_names()
+
+
+class PrettyPrinter:
+    """
+    Prints modules as assembly, with the options of gtirb-pprinter.
+    """
+
+    def __init__(
+        self,
+        format: Optional[str] = None,
+        syntax: Optional[str] = None,
+        policy: Optional[str] = None,
+        listing_mode: str = "",
+        shared: str = "auto",
+        keep_all: bool = False,
+        ignore_symbol_versions: bool = False,
+    ):
+        """
+        :param format: The file format; defaults to that of each module.
+        :param syntax: The syntax; defaults to the default for the target.
+        :param policy: The name of the printing policy.
+        :param listing_mode: "assembler", "ui" or "debug".
+        :param shared: Print for a shared library: "yes", "no" or "auto".
+        """
+        self.format = format
+        self.syntax = syntax
+        self.policy = policy
+        self.listing_mode = listing_mode
+        self.shared = shared
+        self.keep_all = keep_all
+        self.ignore_symbol_versions = ignore_symbol_versions
+        self.keep_functions: List[str] = []
+        self.skip_functions: List[str] = []
+        self.keep_symbols: List[str] = []
+        self.skip_symbols: List[str] = []
+        self.keep_sections: List[str] = []
+        self.skip_sections: List[str] = []
+
+    def options(self) -> Dict[str, object]:
+        return dict(vars(self))
+
+    def print(
+        self, ir: Union[ResidentIR, gtirb.IR], module: ModuleSelector = 0
+    ) -> bytes:
+        """
+        Print a module, selected by index or name, and return the listing.
+        Printing a gtirb.IR loads a copy of it first; load it once with
+        ResidentIR to print it repeatedly.
+        """
+        return _native.print_module(
+            _resident(ir)._ir, module, self.options()
+        )
+
+
+class _BinaryPrinter:
+    _kind = ""
+
+    def __init__(
+        self,
+        printer: PrettyPrinter,
+        compiler_args: Iterable[str] = (),
+        library_paths: Iterable[str] = (),
+    ):
+        self.printer = printer
+        self.compiler_args = list(compiler_args)
+        self.library_paths = list(library_paths)
+
+    def options(self) -> Dict[str, object]:
+        options = self.printer.options()
+        options.update(
+            compiler_args=self.compiler_args,
+            library_paths=self.library_paths,
+        )
+        return options
+
+    def _print(
+        self,
+        ir: Union[ResidentIR, gtirb.IR],
+        module: ModuleSelector,
+        output: str,
+        link: bool,
+    ) -> None:
+        _native.binary_print_module(
+            _resident(ir)._ir,
+            module,
+            self.options(),
+            self._kind,
+            str(output),
+            link,
+        )
+
+    def assemble(
+        self,
+        ir: Union[ResidentIR, gtirb.IR],
+        output: str,
+        module: ModuleSelector = 0,
+    ) -> None:
+        """
+        Assemble a module into an object file.
+        """
+        self._print(ir, module, output, False)
+
+    def link(
+        self,
+        ir: Union[ResidentIR, gtirb.IR],
+        output: str,
+        module: ModuleSelector = 0,
+    ) -> None:
+        """
+        Assemble and link a module into a binary.
+        """
+        self._print(ir, module, output, True)
+
+
+class ElfBinaryPrinter(_BinaryPrinter):
+    _kind = "elf"
+
+    def __init__(
+        self,
+        printer: PrettyPrinter,
+        compiler: str = "",
+        compiler_args: Iterable[str] = (),
+        library_paths: Iterable[str] = (),
+        dummy_so: bool = False,
+        builtin_assembler: bool = False,
+    ):
+        super().__init__(printer, compiler_args, library_paths)
+        self.compiler = compiler
+        self.dummy_so = dummy_so
+        self.builtin_assembler = builtin_assembler
+
+    def options(self) -> Dict[str, object]:
+        options = super().options()
+        options.update(
+            compiler=self.compiler,
+            dummy_so=self.dummy_so,
+            builtin_assembler=self.builtin_assembler,
+        )
+        return options
+
+
+class PeBinaryPrinter(_BinaryPrinter):
+    _kind = "pe"
+
+
+def _resident(ir: Union[ResidentIR, gtirb.IR]) -> ResidentIR:
+    if isinstance(ir, ResidentIR):
+        return ir
+    return ResidentIR.from_ir(ir)
@@ -34,27 +34,27 @@ Arm64PrettyPrinter::Arm64PrettyPrinter(gtirb::Context& context_,
   [[maybe_unused]] cs_err err =
       cs_open(CS_ARCH_ARM64, CS_MODE_ARM, &this->csHandle);
   assert(err == CS_ERR_OK && "Capstone failure");
-
-  buildSymGotRefTable();
 }
 
-void Arm64PrettyPrinter::buildSymGotRefTable(void) {
+const std::unordered_set<const gtirb::Symbol*>&
+Arm64PrettyPrinter::localGotSyms() {
+  if (LocalGotSyms) {
+    return *LocalGotSyms;
+  }
+  LocalGotSyms.emplace();
   for (auto It : module.symbolic_expressions()) {
     auto SymExpr = It.getSymbolicExpression();
     if (const auto* SymAddr = std::get_if<gtirb::SymAddrConst>(&SymExpr)) {
       if (SymAddr->Attributes.count(gtirb::SymAttribute::GOT)) {
-        if (auto Found = aux_data::getForwardedSymbol(SymAddr->Sym)) {
-          // the SymExpr will reference the got entry itself, so we need to
-          // look up the forwarded symbol.
-          auto ForwardedSymbol = gtirb::dyn_cast_or_null<gtirb::Symbol>(
-              gtirb::Node::getByUUID(context, *Found));
-          if (ForwardedSymbol) {
-            LocalGotSyms.insert(ForwardedSymbol->getUUID());
-          }
+        // the SymExpr will reference the got entry itself, so we need to
+        // look up the forwarded symbol.
+        if (const auto* Forwarded = getForwardedSymbol(SymAddr->Sym)) {
+          LocalGotSyms->insert(Forwarded);
         }
       }
     }
   }
+  return *LocalGotSyms;
 }
 
 void Arm64PrettyPrinter::printHeader(std::ostream& os) {
@@ -130,7 +130,9 @@ void Arm64PrettyPrinter::printInstruction(std::ostream& os,
 
   // Make sure the initial m_accum_comment is empty.
   m_accum_comment.clear();
+  std::streampos OperandsStart = InstructLine.tellp();
   printOperandList(InstructLine, block, inst);
+  recordInstructionTokens(opcode, InstructLine, OperandsStart);
   if (!m_accum_comment.empty()) {
     printCommentableLine(InstructLine, os, ea);
     InstructLine.str(std::string()); // Clear
@@ -458,13 +460,15 @@ void Arm64PrettyPrinter::printOpImmediate(
          "printOpImmediate called without an immediate operand");
 
   if (const gtirb::SymAddrConst* s = this->getSymbolicImmediate(symbolic)) {
-    bool is_jump = cs_insn_group(this->csHandle, &inst, ARM64_GRP_JUMP);
+    // ARM64_GRP_JUMP is the generic CS_GRP_JUMP.
+    bool is_jump = getInsnGroups(inst).isJump();
     if (!is_jump) {
       os << ' ';
     }
     this->printSymbolicExpression(os, s, !is_jump);
   } else {
-    os << "#" << op.imm;
+    os << '#';
+    writeDecimal(os, op.imm);
     if (op.shift.type != ARM64_SFT_INVALID && op.shift.value != 0) {
       os << ",";
       printShift(os, op.shift.type, op.shift.value);
@@ -500,7 +504,8 @@ void Arm64PrettyPrinter::printOpIndirect(
     if (s) {
       printSymbolicExpression(os, s, false);
     } else {
-      os << "#" << op.mem.disp;
+      os << '#';
+      writeDecimal(os, op.mem.disp);
     }
     first = false;
   }
@@ -757,7 +762,7 @@ void Arm64PrettyPrinter::printExtender(std::ostream& os,
 
 void Arm64PrettyPrinter::printSymbolHeader(std::ostream& os,
                                            const gtirb::Symbol& sym) {
-  if (LocalGotSyms.find(sym.getUUID()) != LocalGotSyms.end()) {
+  if (localGotSyms().count(&sym)) {
     if (auto SymbolInfo = aux_data::getElfSymbolInfo(sym)) {
       if (SymbolInfo->Binding == "LOCAL" &&
           SymbolInfo->Visibility == "DEFAULT") {
@@ -772,7 +777,7 @@ void Arm64PrettyPrinter::printSymbolHeader(std::ostream& os,
         // originally appeared in the assembly in an individual object file; to
         // be referenced via the got, the reference would be across compilation
         // units, so it would have to be global in the original object.
-        auto Name = getSymbolName(sym);
+        auto Name = getSymbolSpelling(sym);
         printBar(os, false);
         os << syntax.global() << ' ' << Name << '\n';
         os << elfSyntax.hidden() << ' ' << Name << '\n';
@@ -72,17 +72,17 @@ ArmPrettyPrinter::ArmPrettyPrinter(gtirb::Context& context_,
 }
 
 void ArmPrettyPrinter::printHeader(std::ostream& os) {
-  os << "# ARM " << std::endl;
-  os << ".syntax unified" << std::endl;
-  os << ".arch_extension sec" << std::endl;
+  os << "# ARM \n";
+  os << ".syntax unified\n";
+  os << ".arch_extension sec\n";
 }
 
 void ArmPrettyPrinter::setDecodeMode(std::ostream& Os,
                                      const gtirb::CodeBlock& x) {
   if (x.getDecodeMode() == gtirb::DecodeMode::Thumb) {
-    Os << ".thumb" << std::endl;
+    Os << ".thumb\n";
   } else {
-    Os << ".arm" << std::endl;
+    Os << ".arm\n";
   }
 }
 
@@ -158,6 +158,9 @@ void ArmPrettyPrinter::printBlockContents(std::ostream& Os,
     std::exit(EXIT_FAILURE);
   }
 
+  if (Stats)
+    Stats->add(Statistics::Counter::InstructionsDecoded, InsnCount);
+
   gtirb::Offset BlockOffset(X.getUUID(), Offset);
   for (size_t I = 0; I < InsnCount; I++) {
     fixupInstruction((&(*InsnPtr))[I]);
@@ -318,7 +321,9 @@ void ArmPrettyPrinter::printInstruction(std::ostream& os,
   InstructLine << ' ';
   // Make sure the initial m_accum_comment is empty.
   m_accum_comment.clear();
+  std::streampos OperandsStart = InstructLine.tellp();
   printOperandList(InstructLine, block, inst);
+  recordInstructionTokens(opcode, InstructLine, OperandsStart);
 
   if (inst.detail->arm.cps_flag != ARM_CPSFLAG_NONE &&
       inst.detail->arm.cps_flag != ARM_CPSFLAG_INVALID) {
@@ -376,7 +381,8 @@ void ArmPrettyPrinter::printOperandList(std::ostream& os,
         }
         // The disp is for alignment for VLDn and VSTn instructions.
         if (op.mem.disp != 0) {
-          os << " :" << op.mem.disp;
+          os << " :";
+          writeDecimal(os, op.mem.disp);
         }
         os << "]";
         if (detail.writeback) {
@@ -703,7 +709,7 @@ void ArmPrettyPrinter::printOpImmediate(
     else if (op.type == ARM_OP_CIMM)
       os << "cr";
     // The operand is just a number.
-    os << op.imm;
+    writeDecimal(os, op.imm);
   }
 }
 
@@ -777,8 +783,10 @@ void ArmPrettyPrinter::printOpIndirect(
     os << ", #";
     printSymbolicExpression(os, s, false);
   } else {
-    if (op.mem.disp != 0)
-      os << ", #" << op.mem.disp;
+    if (op.mem.disp != 0) {
+      os << ", #";
+      writeDecimal(os, op.mem.disp);
+    }
   }
   os << ']';
   if (detail.writeback) {
@@ -795,6 +803,7 @@ void ArmPrettyPrinter::printOpIndirect(
 bool ArmPrettyPrinter::printSymbolReference(std::ostream& OS,
                                             const gtirb::Symbol* Symbol) {
   if (Symbol->getName() == "_GLOBAL_OFFSET_TABLE_") {
+    recordSymbolReference(*Symbol);
     OS << Symbol->getName();
     return false;
   }
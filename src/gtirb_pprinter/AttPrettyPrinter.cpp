@@ -77,8 +77,8 @@ void AttPrettyPrinter::printOpRegdirect(std::ostream& os, const cs_insn& inst,
   const cs_x86_op& op = inst.detail->x86.operands[index];
   assert(op.type == X86_OP_REG &&
          "printOpRegdirect called without a register operand");
-  if (cs_insn_group(this->csHandle, &inst, CS_GRP_CALL) ||
-      cs_insn_group(this->csHandle, &inst, CS_GRP_JUMP))
+  const InsnGroups& Groups = getInsnGroups(inst);
+  if (Groups.isCall() || Groups.isJump())
     os << '*';
   os << getRegisterName(op.reg);
 }
@@ -109,10 +109,7 @@ void AttPrettyPrinter::printOpImmediate(
     std::exit(EXIT_FAILURE);
   }
 
-  bool ReferencesCode =
-      cs_insn_group(this->csHandle, &Insn, CS_GRP_JUMP) ||
-      cs_insn_group(this->csHandle, &Insn, CS_GRP_CALL) ||
-      cs_insn_group(this->csHandle, &Insn, CS_GRP_BRANCH_RELATIVE);
+  bool ReferencesCode = getInsnGroups(Insn).referencesCode();
 
   if (!ReferencesCode) {
     Stream << '$';
@@ -128,13 +125,15 @@ void AttPrettyPrinter::printOpImmediate(
     PrettyPrinterBase::printSymbolicExpression(Stream, SymAddrConst,
                                                !ReferencesCode);
   } else {
-    // Print a hex-formatted integer.
-    std::ios_base::fmtflags Flags = Stream.flags();
-    if (ReferencesCode) {
-      Stream << std::setbase(16) << std::showbase;
+    // Print a hex-formatted integer for code references.
+    if (!ReferencesCode) {
+      writeDecimal(Stream, Op.imm);
+    } else if (Op.imm == 0) {
+      // Matches std::showbase, which omits the prefix for zero.
+      Stream << '0';
+    } else {
+      writeHex(Stream, static_cast<uint64_t>(Op.imm), syntax.hexFormat());
     }
-    Stream << Op.imm;
-    Stream.flags(Flags);
   }
 }
 
@@ -150,8 +149,8 @@ void AttPrettyPrinter::printOpIndirect(
   bool has_base = op.mem.base != X86_REG_INVALID;
   bool has_index = op.mem.index != X86_REG_INVALID;
 
-  if (cs_insn_group(this->csHandle, &inst, CS_GRP_CALL) ||
-      cs_insn_group(this->csHandle, &inst, CS_GRP_JUMP))
+  const InsnGroups& Groups = getInsnGroups(inst);
+  if (Groups.isCall() || Groups.isJump())
     os << '*';
 
   if (has_segment) {
@@ -164,11 +163,9 @@ void AttPrettyPrinter::printOpIndirect(
   } else {
     // Displacement is numeric.
     if (!has_segment && !has_base && !has_index) {
-      std::ios_base::fmtflags flags = os.flags();
-      os << "0x" << std::hex << op.mem.disp;
-      os.flags(flags);
+      writeHex(os, static_cast<uint64_t>(op.mem.disp), syntax.hexFormat());
     } else if (op.mem.disp != 0 || has_segment) {
-      os << op.mem.disp;
+      writeDecimal(os, op.mem.disp);
     } else {
       // Print nothing. There is no segment register and the base or index
       // register will be printed, so the zero displacement is implicit.
@@ -86,6 +86,11 @@ std::optional<uint64_t> getSymbolicExpressionSize(const gtirb::Offset& Offset,
   return util::getByOffset<gtirb::schema::SymbolicExpressionSizes>(Offset, Mod);
 }
 
+const gtirb::schema::SymbolicExpressionSizes::Type*
+getSymbolicExpressionSizes(const gtirb::Module& Mod) {
+  return Mod.getAuxData<gtirb::schema::SymbolicExpressionSizes>();
+}
+
 gtirb::schema::Alignment::Type getAlignments(const gtirb::Module& Mod) {
   return util::getOrDefault<gtirb::schema::Alignment>(Mod);
 }
@@ -130,6 +135,26 @@ getSymbolForwarding(const gtirb::Module& Module) {
   return util::getOrDefault<gtirb::schema::SymbolForwarding>(Module);
 }
 
+SymbolForwardingTable::SymbolForwardingTable(const gtirb::Context& Context,
+                                             const gtirb::Module& Module) {
+  const auto* Table = Module.getAuxData<gtirb::schema::SymbolForwarding>();
+  if (!Table) {
+    return;
+  }
+  Targets.reserve(Table->size());
+  Entries.reserve(Table->size());
+  for (const auto& [FromUUID, ToUUID] : *Table) {
+    const auto* From = gtirb::dyn_cast_or_null<gtirb::Symbol>(
+        gtirb::Node::getByUUID(Context, FromUUID));
+    const auto* To = gtirb::dyn_cast_or_null<gtirb::Symbol>(
+        gtirb::Node::getByUUID(Context, ToUUID));
+    if (From && To) {
+      Targets.emplace(From, To);
+      Entries.emplace_back(From, To);
+    }
+  }
+}
+
 const gtirb::schema::Comments::Type* getComments(const gtirb::Module& Module) {
   return Module.getAuxData<gtirb::schema::Comments>();
 }
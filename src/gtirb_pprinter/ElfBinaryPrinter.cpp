@@ -18,16 +18,22 @@
 #include "ArmPrettyPrinter.hpp"
 #include "AuxDataSchema.hpp"
 #include "AuxDataUtils.hpp"
+#include "ElfObjectWriter.hpp"
 #include "ElfPrettyPrinter.hpp"
 #include "ElfVersionScriptPrinter.hpp"
 #include "FileUtils.hpp"
 #include "Mips32PrettyPrinter.hpp"
+#include "ObjectCache.hpp"
+#include "OutputSink.hpp"
 #include "driver/Logger.h"
+#include <atomic>
 #include <boost/filesystem.hpp>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <regex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace gtirb_bprint {
@@ -116,7 +122,7 @@ bool ElfBinaryPrinter::generateDummySO(
   bool EmittedSymvers = false;
 
   {
-    std::ofstream AsmFile(AsmFilePath.string());
+    gtirb_pprint::OutputSinkStream AsmFile(AsmFilePath.string());
     AsmFile << "# Generated dummy file for .so undefined symbols\n";
 
     std::unique_ptr<gtirb_pprint::ElfSyntax> Syntax =
@@ -278,32 +284,13 @@ static bool isCopyRelocation(const gtirb::Symbol* From,
   return SymInfo && SymInfo->Type == "OBJECT";
 }
 
-/**
-Get a copy relocation's symbols given a symbol forwarding entry.
-
-Returns std::nullopt if the given symbol forwarding entry is invalid or is not
-a copy relocation.
-*/
-static std::optional<std::pair<const gtirb::Symbol*, const gtirb::Symbol*>>
-getCopyRelocationSyms(const gtirb::Context& Context,
-                      const std::pair<gtirb::UUID, gtirb::UUID>& Forward) {
-  const gtirb::Symbol* From =
-      gtirb_pprint::getByUUID<gtirb::Symbol>(Context, Forward.first);
-  const gtirb::Symbol* To =
-      gtirb_pprint::getByUUID<gtirb::Symbol>(Context, Forward.second);
-  if (!From || !To || !isCopyRelocation(From, To)) {
-    return std::nullopt;
-  }
-  return std::make_pair(From, To);
-}
-
 /**
  * Group symbols together if they must be printed in the dummy library as
  * referring to the same address. Currently, this is only known to be
  * necessary for COPY-relocated symbols.
  */
 static std::vector<SymbolGroup>
-buildDummySOSymbolGroups(const gtirb::Context& Context,
+buildDummySOSymbolGroups(const aux_data::SymbolForwardingTable& Forwarding,
                          const gtirb::Module& Module) {
   std::vector<SymbolGroup> SymbolGroups;
 
@@ -313,13 +300,9 @@ buildDummySOSymbolGroups(const gtirb::Context& Context,
   // Build symbol groups for COPY-relocated symbols.
   // Collect copy-relocated symbols into groups by address
   std::map<gtirb::Addr, SymbolGroup> CopySymbolsByAddr;
-  const auto& Forwarding = aux_data::getSymbolForwarding(Module);
-  for (const auto& Forward : Forwarding) {
-    if (auto OptPair = getCopyRelocationSyms(Context, Forward)) {
-      auto& [From, To] = *OptPair;
-      if (!isBlackListed(To->getName())) {
-        CopySymbolsByAddr[*From->getAddress()].push_back(To);
-      }
+  for (const auto& [From, To] : Forwarding.entries()) {
+    if (isCopyRelocation(From, To) && !isBlackListed(To->getName())) {
+      CopySymbolsByAddr[*From->getAddress()].push_back(To);
     }
   }
 
@@ -389,7 +372,8 @@ bool ElfBinaryPrinter::prepareDummySOLibs(
   }
   // Get groups of symbols which must be printed together.
   std::vector<SymbolGroup> SymbolGroups =
-      buildDummySOSymbolGroups(Context, Module);
+      buildDummySOSymbolGroups(*Printer.getSymbolForwarding(Context, Module),
+                               Module);
 
   // Now we need to assign imported symbol groups to all the libs.
   // For any group that contains a versioned symbol, we have a mapping of which
@@ -624,8 +608,164 @@ std::vector<std::string> ElfBinaryPrinter::buildCompilerArgs(
   return args;
 }
 
+std::optional<std::string>
+ElfBinaryPrinter::buildObject(gtirb::Context& ctx,
+                              const gtirb::Module& module) const {
+  if (!useBuiltinAssembler) {
+    return std::nullopt;
+  }
+  // The writer asks the printer what the listing would contain.
+  std::unique_ptr<gtirb_pprint::PrettyPrinterBase> ModulePrinter =
+      Printer.createPrinter(ctx, module);
+  if (!ModulePrinter) {
+    return std::nullopt;
+  }
+  std::string Object, Reason;
+  if (!writeElfObject(*ModulePrinter, module,
+                      Printer.getEffectivePolicy(module), Object, Reason)) {
+    LOG_INFO << "Using the external assembler: " << Reason << "\n";
+    return std::nullopt;
+  }
+  return Object;
+}
+
+static bool writeObjectFile(TempFile& ObjectFile, const std::string& Object) {
+  if (!ObjectFile.isOpen()) {
+    return false;
+  }
+  std::ostream& ObjectStream = ObjectFile;
+  ObjectStream.write(Object.data(), Object.size());
+  ObjectFile.close();
+  return !ObjectStream.fail();
+}
+
+static bool saveOutputFile(const std::string& Temporary,
+                           const std::string& Output) {
+  try {
+    copyFile(Temporary, Output);
+  } catch (const boost::filesystem::filesystem_error& Error) {
+    std::cerr << "ERROR: Could not save the output file: " << Error.what()
+              << "\n";
+    return false;
+  }
+  return true;
+}
+
+std::optional<int>
+ElfBinaryPrinter::assembleFile(const std::string& Source,
+                               const std::string& ObjectPath,
+                               const gtirb::Module& module) const {
+  // The key leaves out the names of the source and object files, which are
+  // temporary.
+  std::vector<std::string> Flags{"-c"};
+  Flags.insert(Flags.end(), ExtraCompileArgs.begin(), ExtraCompileArgs.end());
+  addArchBuildArgs(module, Flags);
+
+  gtirb_pprint::Statistics* Stats = Printer.getStatistics();
+  std::optional<std::string> Key;
+  if (Objects) {
+    Key = ObjectCache::key(Source, compiler, Flags);
+    if (Key && Objects->fetch(*Key, ObjectPath)) {
+      LOG_INFO << "Using the cached object for module " << module.getName()
+               << "\n";
+      if (Stats)
+        Stats->add(gtirb_pprint::Statistics::Counter::ObjectCacheHits);
+      return 0;
+    }
+    if (Stats)
+      Stats->add(gtirb_pprint::Statistics::Counter::ObjectCacheMisses);
+  }
+
+  std::vector<std::string> args{"-o", ObjectPath};
+  args.insert(args.end(), Flags.begin(), Flags.end());
+  args.push_back(Source);
+  gtirb_pprint::Statistics::Timer Timer(Stats, "assemble");
+  std::optional<int> ret = execute(compiler, args);
+  if (ret && *ret == 0 && Key && !Objects->store(*Key, ObjectPath)) {
+    LOG_WARNING << "Could not add the object for module " << module.getName()
+                << " to the object cache.\n";
+  }
+  return ret;
+}
+
+bool ElfBinaryPrinter::assembleShards(
+    gtirb::Context& ctx, const gtirb::Module& module,
+    std::vector<TempFile>& ObjectFiles) const {
+  std::unique_ptr<gtirb_pprint::PrettyPrinterBase> ShardPrinter =
+      Printer.createPrinter(ctx, module);
+  if (!ShardPrinter) {
+    LOG_ERROR << "Could not create a printer for module " << module.getName()
+              << ".\n";
+    return false;
+  }
+  std::vector<gtirb_pprint::ListingShard> Shards =
+      ShardPrinter->computeListingShards();
+  std::vector<TempFile> Sources(Shards.size());
+  std::vector<std::ostream*> Streams;
+  for (TempFile& Source : Sources) {
+    if (!Source.isOpen()) {
+      LOG_ERROR << "Could not write assembly into a temporary file.\n";
+      return false;
+    }
+    Streams.push_back(&static_cast<std::ostream&>(Source));
+  }
+  ShardPrinter->printShards(Shards, Streams);
+
+  size_t First = ObjectFiles.size();
+  for (TempFile& Source : Sources) {
+    Source.close();
+    ObjectFiles.emplace_back(".o").close();
+  }
+  LOG_INFO << "Assembling module " << module.getName() << " as "
+           << Shards.size() << " shards\n";
+
+  // Only the shards that missed the cache run the assembler; they do so in
+  // parallel.
+  std::vector<std::optional<int>> Results(Sources.size());
+  std::atomic<size_t> Next{0};
+  auto Work = [&]() {
+    for (size_t I = Next++; I < Sources.size(); I = Next++) {
+      Results[I] = assembleFile(Sources[I].fileName(),
+                                ObjectFiles[First + I].fileName(), module);
+    }
+  };
+  // hardware_concurrency() is 0 when it is not known.
+  size_t Threads = std::min<size_t>(
+      std::max(std::thread::hardware_concurrency(), 1u), Sources.size());
+  std::vector<std::thread> Workers;
+  for (size_t I = 1; I < Threads; ++I) {
+    Workers.emplace_back(Work);
+  }
+  Work();
+  for (std::thread& Worker : Workers) {
+    Worker.join();
+  }
+
+  for (const std::optional<int>& Ret : Results) {
+    if (!Ret) {
+      LOG_ERROR << "could not find the assembler '" << compiler
+                << "' on the PATH.\n";
+      return false;
+    }
+    if (*Ret) {
+      LOG_ERROR << "assembler returned: " << *Ret << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
 int ElfBinaryPrinter::assemble(const std::string& outputFilename,
                                gtirb::Context& ctx, gtirb::Module& mod) const {
+  if (std::optional<std::string> Object = buildObject(ctx, mod)) {
+    TempFile ObjectFile(".o");
+    if (!writeObjectFile(ObjectFile, *Object)) {
+      std::cerr << "ERROR: Could not write the object into a temporary file.\n";
+      return -1;
+    }
+    return saveOutputFile(ObjectFile.fileName(), outputFilename) ? 0 : -1;
+  }
+
   TempFile tempFile;
   if (!prepareSource(ctx, mod, tempFile)) {
     std::cerr << "ERROR: Could not write assembly into a temporary file.\n";
@@ -636,17 +776,12 @@ int ElfBinaryPrinter::assemble(const std::string& outputFilename,
   boost::filesystem::path tmpOutputPath(tempOutputDir.dirName());
   tmpOutputPath /= outputPath.filename();
 
-  std::vector<std::string> args{{"-o", tmpOutputPath.string(), "-c"}};
-  args.insert(args.end(), ExtraCompileArgs.begin(), ExtraCompileArgs.end());
-  args.push_back(tempFile.fileName());
-
-  addArchBuildArgs(mod, args);
-
-  if (std::optional<int> ret = execute(compiler, args)) {
+  if (std::optional<int> ret = assembleFile(tempFile.fileName(),
+                                            tmpOutputPath.string(), mod)) {
     if (*ret) {
       std::cerr << "ERROR: assembler returned: " << *ret << "\n";
-    } else {
-      copyFile(tmpOutputPath.string(), outputFilename);
+    } else if (!saveOutputFile(tmpOutputPath.string(), outputFilename)) {
+      return -1;
     }
     return *ret;
   }
@@ -690,21 +825,25 @@ std::optional<std::string> getDynamicTagArg(const gtirb::Module& Mod,
   return "-Wl,-" + Arg + "=" + Result->getName();
 }
 
-int ElfBinaryPrinter::link(const std::string& outputFilename,
-                           gtirb::Context& ctx, gtirb::Module& module) const {
-  if (debug)
-    std::cout << "Generating binary file" << std::endl;
-  TempFile tempFile;
-  if (!prepareSource(ctx, module, tempFile)) {
-    LOG_ERROR << "Could not write assembly into a temporary file.\n";
-    return -1;
-  }
+// AuxData tables are deserialized on first access, which is not thread-safe.
+// Load the tables read while preparing the link before printing starts.
+static void loadLinkAuxData(const gtirb::Module& Module) {
+  Module.getAuxData<gtirb::schema::Libraries>();
+  Module.getAuxData<gtirb::schema::LibraryPaths>();
+  Module.getAuxData<gtirb::schema::BinaryType>();
+  Module.getAuxData<gtirb::schema::ElfSymbolInfo>();
+  Module.getAuxData<gtirb::schema::ElfSymbolTabIdxInfo>();
+  Module.getAuxData<gtirb::schema::ElfDynamicInit>();
+  Module.getAuxData<gtirb::schema::ElfDynamicFini>();
+  Module.getAuxData<gtirb::provisional_schema::ElfSymbolVersions>();
+}
 
+bool ElfBinaryPrinter::prepareLinkArgs(
+    gtirb::Context& ctx, gtirb::Module& module,
+    const std::string& outputFilename, std::optional<TempDir>& dummySoDir,
+    TempFile& VersionScript, TempFile& DynamicList,
+    std::vector<std::string>& libArgs) const {
   // Prep stuff for dynamic library dependences
-  // Note that this temporary directory has to survive
-  // longer than the call to the compiler.
-  std::optional<TempDir> dummySoDir;
-  std::vector<std::string> libArgs;
   boost::filesystem::path outputPath(outputFilename);
 
   if (useDummySO) {
@@ -713,12 +852,14 @@ int ElfBinaryPrinter::link(const std::string& outputFilename,
     if (!dummySoDir->created()) {
       LOG_ERROR << "Failed to create temp dir for synthetic .so files. Errno: "
                 << dummySoDir->errno_code() << "\n";
-      return -1;
+      return false;
     }
 
+    gtirb_pprint::Statistics::Timer DummySOTimer(Printer.getStatistics(),
+                                                 "dummy-so");
     if (!prepareDummySOLibs(ctx, module, dummySoDir->dirName(), libArgs)) {
       LOG_ERROR << "Could not create dummy so files for linking.\n";
-      return -1;
+      return false;
     }
     // add rpaths from original binary(ies)
     if (const auto* binaryLibraryPaths =
@@ -735,17 +876,18 @@ int ElfBinaryPrinter::link(const std::string& outputFilename,
                        outputPath.parent_path().generic_string());
   }
 
-  TempFile VersionScript(".map");
   if (aux_data::hasVersionedSymDefs(module) &&
       !Printer.getIgnoreSymbolVersions()) {
     // A version script is only needed if we define versioned symbols.
-    if (gtirb_pprint::printVersionScript(ctx, module, VersionScript)) {
+    auto Script = Printer.getVersionScript(ctx, module);
+    if (Script && !Script->empty()) {
+      std::ostream& VersionStream = VersionScript;
+      VersionStream << *Script;
       libArgs.push_back("-Wl,--version-script=" + VersionScript.fileName());
     }
   }
   VersionScript.close();
 
-  TempFile DynamicList(".dynamic_list.txt");
   gtirb_pprint::DynMode DM = Printer.getDynMode(module);
   if (DM != gtirb_pprint::DYN_MODE_SHARED) {
     // Collect all global, visiable, exported symbols to create a
@@ -753,10 +895,10 @@ int ElfBinaryPrinter::link(const std::string& outputFilename,
     std::vector<std::string> ExportedSyms =
         collectGlobalVisibleSymsExported(ctx, module);
     if (!ExportedSyms.empty()) {
-      std::ofstream& DynamicListStream = DynamicList;
+      std::ostream& DynamicListStream = DynamicList;
       DynamicListStream << "{\n";
       for (auto SymName : ExportedSyms) {
-        DynamicListStream << "  " << SymName << ";" << std::endl;
+        DynamicListStream << "  " << SymName << ";\n";
       }
       DynamicListStream << "};\n";
       libArgs.push_back("-Wl,--dynamic-list=" + DynamicList.fileName());
@@ -764,9 +906,6 @@ int ElfBinaryPrinter::link(const std::string& outputFilename,
   }
   DynamicList.close();
 
-  std::vector<TempFile> Files;
-  Files.emplace_back(std::move(tempFile));
-
   // Add -Wl,-init= and -Wl,-fini= arguments if necessary.
   // This recreates DT_INIT and DT_FINI dynamic entries.
   if (auto Arg = getDynamicTagArg(
@@ -781,16 +920,60 @@ int ElfBinaryPrinter::link(const std::string& outputFilename,
           "fini")) {
     libArgs.push_back(*Arg);
   }
+  return true;
+}
+
+int ElfBinaryPrinter::link(const std::string& outputFilename,
+                           gtirb::Context& ctx, gtirb::Module& module) const {
+  if (debug)
+    std::cout << "Generating binary file" << std::endl;
+
+  // The linker arguments do not depend on the printed assembly, so they are
+  // prepared while it is printed. Note that these temporary files have to
+  // survive longer than the call to the compiler.
+  std::optional<TempDir> dummySoDir;
+  TempFile VersionScript(".map");
+  TempFile DynamicList(".dynamic_list.txt");
+  std::vector<std::string> libArgs;
+  loadLinkAuxData(module);
+  // Both threads use the shared symbol forwarding; resolve it before either.
+  Printer.getSymbolForwarding(ctx, module);
+  std::future<bool> LinkArgsReady = std::async(std::launch::async, [&]() {
+    return prepareLinkArgs(ctx, module, outputFilename, dummySoDir,
+                           VersionScript, DynamicList, libArgs);
+  });
+
+  std::vector<TempFile> Files;
+  bool SourceReady = true;
+  if (std::optional<std::string> Object = buildObject(ctx, module)) {
+    if (!writeObjectFile(Files.emplace_back(".o"), *Object)) {
+      LOG_ERROR << "Could not write the object into a temporary file.\n";
+      SourceReady = false;
+    }
+  } else if (Objects) {
+    // Assemble separately from the link, shard by shard, so that the objects
+    // of the shards that did not change are reused by later links.
+    SourceReady = assembleShards(ctx, module, Files);
+  } else if (!prepareSource(ctx, module, Files.emplace_back())) {
+    LOG_ERROR << "Could not write assembly into a temporary file.\n";
+    SourceReady = false;
+  }
+  if (!LinkArgsReady.get() || !SourceReady) {
+    return -1;
+  }
+
+  boost::filesystem::path outputPath(outputFilename);
   TempDir tempOutputDir;
   boost::filesystem::path tmpOutputPath(tempOutputDir.dirName());
   tmpOutputPath /= outputPath.filename();
+  gtirb_pprint::Statistics::Timer Timer(Printer.getStatistics(), "link");
   if (std::optional<int> ret =
           execute(compiler, buildCompilerArgs(tmpOutputPath.string(), Files,
                                               module, libArgs))) {
     if (*ret) {
       LOG_ERROR << "assembler returned: " << *ret << "\n";
-    } else {
-      copyFile(tmpOutputPath.string(), outputFilename);
+    } else if (!saveOutputFile(tmpOutputPath.string(), outputFilename)) {
+      return -1;
     }
     return *ret;
   }
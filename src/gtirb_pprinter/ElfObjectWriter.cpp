@@ -0,0 +1,1173 @@
+//===- ElfObjectWriter.cpp --------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ElfObjectWriter.hpp"
+#include "AuxDataSchema.hpp"
+#include "AuxDataUtils.hpp"
+#include "NumberFormat.hpp"
+
+#include <algorithm>
+#include <capstone/capstone.h>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace gtirb_bprint {
+
+namespace {
+
+constexpr uint16_t ET_REL = 1;
+constexpr uint16_t EM_X86_64 = 62;
+constexpr uint8_t EV_CURRENT = 1;
+
+constexpr uint32_t SHT_PROGBITS = 1;
+constexpr uint32_t SHT_SYMTAB = 2;
+constexpr uint32_t SHT_STRTAB = 3;
+constexpr uint32_t SHT_RELA = 4;
+constexpr uint32_t SHT_NOTE = 7;
+constexpr uint32_t SHT_NOBITS = 8;
+constexpr uint32_t SHT_INIT_ARRAY = 14;
+constexpr uint32_t SHT_FINI_ARRAY = 15;
+constexpr uint32_t SHT_PREINIT_ARRAY = 16;
+
+constexpr uint64_t SHF_WRITE = 1 << 0;
+constexpr uint64_t SHF_ALLOC = 1 << 1;
+constexpr uint64_t SHF_EXECINSTR = 1 << 2;
+constexpr uint64_t SHF_INFO_LINK = 1 << 6;
+constexpr uint64_t SHF_TLS = 1 << 10;
+
+constexpr uint16_t SHN_UNDEF = 0;
+constexpr uint16_t SHN_LORESERVE = 0xff00;
+constexpr uint16_t SHN_ABS = 0xfff1;
+constexpr uint16_t SHN_COMMON = 0xfff2;
+
+constexpr uint8_t STB_LOCAL = 0;
+constexpr uint8_t STB_GLOBAL = 1;
+constexpr uint8_t STB_WEAK = 2;
+
+constexpr uint8_t STT_NOTYPE = 0;
+constexpr uint8_t STT_OBJECT = 1;
+constexpr uint8_t STT_FUNC = 2;
+constexpr uint8_t STT_SECTION = 3;
+constexpr uint8_t STT_GNU_IFUNC = 10;
+
+constexpr uint8_t STV_DEFAULT = 0;
+constexpr uint8_t STV_INTERNAL = 1;
+constexpr uint8_t STV_HIDDEN = 2;
+constexpr uint8_t STV_PROTECTED = 3;
+
+constexpr uint32_t R_X86_64_64 = 1;
+constexpr uint32_t R_X86_64_PC32 = 2;
+constexpr uint32_t R_X86_64_PLT32 = 4;
+constexpr uint32_t R_X86_64_GOTPCREL = 9;
+constexpr uint32_t R_X86_64_32 = 10;
+constexpr uint32_t R_X86_64_32S = 11;
+constexpr uint32_t R_X86_64_16 = 12;
+constexpr uint32_t R_X86_64_PC16 = 13;
+constexpr uint32_t R_X86_64_8 = 14;
+constexpr uint32_t R_X86_64_PC8 = 15;
+constexpr uint32_t R_X86_64_PC64 = 24;
+
+// An immediate or displacement field of a decoded instruction.
+struct CodeField {
+  uint64_t Size;
+  // Distance from the start of the field to the end of the instruction.
+  uint64_t ToInsnEnd;
+  bool PcRelative;
+  bool Branch;
+  bool SignExtended;
+};
+
+// Symbol table entries are numbered within their part of the table until
+// the table is laid out after the section symbols: locals, then globals.
+// Relocations for absolute targets refer to the null symbol.
+enum class SymbolTablePart { Null, Locals, Globals };
+
+struct SymbolRef {
+  SymbolTablePart Part;
+  uint32_t Index;
+};
+
+struct SymbolEntry {
+  std::string Name;
+  uint8_t Info;
+  uint8_t Other;
+  uint16_t SectionIndex;
+  uint64_t Value;
+  uint64_t Size;
+};
+
+struct Relocation {
+  uint64_t Offset;
+  SymbolRef Symbol;
+  uint32_t Type;
+  int64_t Addend;
+};
+
+struct OutputSection {
+  const gtirb::Section* Section;
+  const gtirb::ByteInterval* Interval;
+  uint32_t Type;
+  uint64_t Flags;
+  uint64_t Alignment;
+  uint64_t Size;
+  // The contents, unless the section is SHT_NOBITS.
+  std::string Data;
+  std::vector<Relocation> Relocations;
+};
+
+// Where a printed block starts in its output section. Blocks that overlap
+// the block before them start before the end of the section.
+struct Placement {
+  uint64_t Offset;
+  // Whether the contents of the block are printed, or only its symbols.
+  bool Contents;
+};
+
+// Attributes that need relocations the writer does not produce.
+const gtirb::SymAttribute UnsupportedAttributes[] = {
+    gtirb::SymAttribute::GOTOFF,  gtirb::SymAttribute::GOTPC,
+    gtirb::SymAttribute::TPOFF,   gtirb::SymAttribute::NTPOFF,
+    gtirb::SymAttribute::DTPOFF,  gtirb::SymAttribute::INDNTPOFF,
+    gtirb::SymAttribute::TLSGD,   gtirb::SymAttribute::TLSLD,
+    gtirb::SymAttribute::TLSLDM,  gtirb::SymAttribute::TLSDESC,
+    gtirb::SymAttribute::TLSCALL, gtirb::SymAttribute::HI,
+    gtirb::SymAttribute::LO,      gtirb::SymAttribute::LO12,
+    gtirb::SymAttribute::PAGE,    gtirb::SymAttribute::OFST,
+};
+
+bool hasUnsupportedAttribute(const gtirb::SymAttributeSet& Attributes) {
+  return std::any_of(std::begin(UnsupportedAttributes),
+                     std::end(UnsupportedAttributes),
+                     [&](gtirb::SymAttribute Attribute) {
+                       return Attributes.count(Attribute) != 0;
+                     });
+}
+
+template <typename T> void appendLittleEndian(std::string& Out, T Value) {
+  auto Bits = static_cast<uint64_t>(Value);
+  for (size_t I = 0; I < sizeof(T); ++I) {
+    Out.push_back(static_cast<char>((Bits >> (8 * I)) & 0xff));
+  }
+}
+
+void writeLittleEndian(char* Out, uint64_t Value, uint64_t Size) {
+  for (uint64_t I = 0; I < Size; ++I) {
+    Out[I] = static_cast<char>((Value >> (8 * I)) & 0xff);
+  }
+}
+
+// Whether Value can be stored in a field of Size bytes, as either a signed
+// or an unsigned number.
+bool fitsField(int64_t Value, uint64_t Size) {
+  if (Size >= 8) {
+    return true;
+  }
+  int64_t Bits = 8 * static_cast<int64_t>(Size);
+  return Value >= -(int64_t{1} << (Bits - 1)) && Value < (int64_t{1} << Bits);
+}
+
+void alignTo(std::string& Out, uint64_t Alignment) {
+  if (Alignment > 1) {
+    Out.resize((Out.size() + Alignment - 1) & ~(Alignment - 1), '\0');
+  }
+}
+
+// The no-op instructions that GNU as pads x86-64 code with, by length. Longer
+// padding repeats the longest one and ends with the one for the remainder.
+const char* const CodePadding[] = {
+    "",
+    "\x90",
+    "\x66\x90",
+    "\x0f\x1f\x00",
+    "\x0f\x1f\x40\x00",
+    "\x0f\x1f\x44\x00\x00",
+    "\x66\x0f\x1f\x44\x00\x00",
+    "\x0f\x1f\x80\x00\x00\x00\x00",
+    "\x0f\x1f\x84\x00\x00\x00\x00\x00",
+    "\x66\x0f\x1f\x84\x00\x00\x00\x00\x00",
+    "\x66\x2e\x0f\x1f\x84\x00\x00\x00\x00\x00",
+    "\x66\x66\x2e\x0f\x1f\x84\x00\x00\x00\x00\x00",
+};
+
+// Pad the contents of a section like `.align Alignment` does.
+void padTo(OutputSection& Out, uint64_t Alignment) {
+  uint64_t Padding = (Alignment - Out.Size % Alignment) % Alignment;
+  Out.Size += Padding;
+  if (Out.Type == SHT_NOBITS) {
+    return;
+  }
+  if (!(Out.Flags & SHF_EXECINSTR)) {
+    Out.Data.append(Padding, '\0');
+    return;
+  }
+  constexpr uint64_t Longest = std::size(CodePadding) - 1;
+  for (; Padding > Longest; Padding -= Longest) {
+    Out.Data.append(CodePadding[Longest], Longest);
+  }
+  Out.Data.append(CodePadding[Padding], Padding);
+}
+
+class StringTable {
+public:
+  StringTable() : Data(1, '\0') {}
+
+  uint32_t add(const std::string& String) {
+    if (String.empty()) {
+      return 0;
+    }
+    auto [It, Inserted] =
+        Offsets.emplace(String, static_cast<uint32_t>(Data.size()));
+    if (Inserted) {
+      Data.append(String);
+      Data.push_back('\0');
+    }
+    return It->second;
+  }
+
+  const std::string& data() const { return Data; }
+
+private:
+  std::string Data;
+  std::unordered_map<std::string, uint32_t> Offsets;
+};
+
+// The section a symbol is defined in, if it refers to a block.
+const gtirb::Section* referentSection(const gtirb::Symbol& Symbol) {
+  const gtirb::ByteInterval* Interval = nullptr;
+  if (const auto* CB = Symbol.getReferent<gtirb::CodeBlock>()) {
+    Interval = CB->getByteInterval();
+  } else if (const auto* DB = Symbol.getReferent<gtirb::DataBlock>()) {
+    Interval = DB->getByteInterval();
+  }
+  return Interval ? Interval->getSection() : nullptr;
+}
+
+std::optional<uint8_t> elfBinding(const std::string& Binding) {
+  if (Binding == "LOCAL") {
+    return STB_LOCAL;
+  } else if (Binding == "GLOBAL") {
+    return STB_GLOBAL;
+  } else if (Binding == "WEAK") {
+    return STB_WEAK;
+  }
+  return std::nullopt;
+}
+
+std::optional<uint8_t> elfType(const std::string& Type) {
+  if (Type == "NOTYPE" || Type == "NONE" || Type == "SECTION") {
+    return STT_NOTYPE;
+  } else if (Type == "OBJECT") {
+    return STT_OBJECT;
+  } else if (Type == "FUNC") {
+    return STT_FUNC;
+  } else if (Type == "GNU_IFUNC") {
+    return STT_GNU_IFUNC;
+  }
+  return std::nullopt;
+}
+
+std::optional<uint8_t> elfVisibility(const std::string& Visibility) {
+  if (Visibility == "DEFAULT") {
+    return STV_DEFAULT;
+  } else if (Visibility == "INTERNAL") {
+    return STV_INTERNAL;
+  } else if (Visibility == "HIDDEN") {
+    return STV_HIDDEN;
+  } else if (Visibility == "PROTECTED") {
+    return STV_PROTECTED;
+  }
+  return std::nullopt;
+}
+
+class CapstoneHandle {
+public:
+  CapstoneHandle() {
+    if (cs_open(CS_ARCH_X86, CS_MODE_64, &Handle) == CS_ERR_OK) {
+      cs_option(Handle, CS_OPT_DETAIL, CS_OPT_ON);
+      Opened = true;
+    }
+  }
+  ~CapstoneHandle() {
+    if (Opened) {
+      cs_close(&Handle);
+    }
+  }
+  CapstoneHandle(const CapstoneHandle&) = delete;
+  CapstoneHandle& operator=(const CapstoneHandle&) = delete;
+
+  bool opened() const { return Opened; }
+  csh get() const { return Handle; }
+
+private:
+  csh Handle = 0;
+  bool Opened = false;
+};
+
+class ObjectWriter {
+public:
+  ObjectWriter(gtirb_pprint::PrettyPrinterBase& Pr, const gtirb::Module& M,
+               const gtirb_pprint::PrintingPolicy& P)
+      : Printer(Pr), Module(M), Policy(P) {}
+
+  bool write(std::string& Object);
+  const std::string& reason() const { return Reason; }
+
+private:
+  bool fail(std::string Message) {
+    Reason = std::move(Message);
+    return false;
+  }
+  bool failAt(const std::string& Message, const OutputSection& Out,
+              uint64_t Offset) {
+    std::string Where = Message + " at ";
+    gtirb_pprint::appendHex(
+        Where, static_cast<uint64_t>(*Out.Interval->getAddress()) + Offset);
+    return fail(std::move(Where));
+  }
+
+  bool checkModule();
+  bool collectSections();
+  bool layOutSection(OutputSection& Out);
+  bool collectSymbols();
+  bool relocateSection(OutputSection& Out, uint16_t Index);
+  bool relocateCode(OutputSection& Out, uint16_t Index,
+                    const gtirb::CodeBlock& Block, uint64_t Offset,
+                    uint64_t Target, const gtirb::SymbolicExpression& Expr);
+  bool relocateData(OutputSection& Out, uint16_t Index,
+                    const gtirb::ByteInterval::ConstSymbolicExpressionElement&
+                        SEE,
+                    uint64_t Target);
+  bool decodeBlock(const gtirb::CodeBlock& Block);
+  std::optional<SymbolRef> referenceSymbol(const gtirb::Symbol& Symbol);
+  const SymbolEntry& entry(SymbolRef Ref) const {
+    return Ref.Part == SymbolTablePart::Locals ? Locals[Ref.Index]
+                                               : Globals[Ref.Index];
+  }
+  bool printsContents(const gtirb::Node& Block) const;
+  void serialize(std::string& Object) const;
+
+  gtirb_pprint::PrettyPrinterBase& Printer;
+  const gtirb::Module& Module;
+  const gtirb_pprint::PrintingPolicy& Policy;
+  std::string Reason;
+
+  std::vector<OutputSection> Sections;
+  std::unordered_map<const gtirb::Section*, uint16_t> SectionIndices;
+  std::unordered_map<const gtirb::Node*, Placement> Placements;
+
+  std::vector<SymbolEntry> Locals;
+  std::vector<SymbolEntry> Globals;
+  std::unordered_map<const gtirb::Symbol*, SymbolRef> Symbols;
+  // Symbols that are only added to the table, as undefined globals, if some
+  // expression refers to them; this is what the assembler does for names it
+  // does not see defined.
+  std::unordered_map<const gtirb::Symbol*, SymbolEntry> Deferred;
+
+  CapstoneHandle Capstone;
+  const gtirb::CodeBlock* DecodedBlock = nullptr;
+  std::map<uint64_t, CodeField> DecodedFields;
+};
+
+bool ObjectWriter::write(std::string& Object) {
+  if (!checkModule() || !collectSections() || !collectSymbols()) {
+    return false;
+  }
+  for (size_t I = 0; I < Sections.size(); ++I) {
+    if (!relocateSection(Sections[I], static_cast<uint16_t>(I + 1))) {
+      return false;
+    }
+  }
+  serialize(Object);
+  return true;
+}
+
+bool ObjectWriter::checkModule() {
+  if (Module.getFileFormat() != gtirb::FileFormat::ELF ||
+      Module.getISA() != gtirb::ISA::X64) {
+    return fail("only x86-64 ELF modules are supported");
+  }
+  if (Policy.LstMode != gtirb_pprint::ListingAssembler) {
+    return fail("the listing mode is not 'assembler'");
+  }
+  if (!Capstone.opened()) {
+    return fail("could not initialize the disassembler");
+  }
+  if (!aux_data::getSymbolForwarding(Module).empty()) {
+    return fail("the module forwards symbols");
+  }
+  if (aux_data::hasVersionedSymDefs(Module)) {
+    return fail("the module defines symbol versions");
+  }
+  if (const auto* Cfi = Module.getAuxData<gtirb::schema::CfiDirectives>();
+      Cfi && !Cfi->empty()) {
+    return fail("the module has CFI directives");
+  }
+  return true;
+}
+
+bool ObjectWriter::collectSections() {
+  for (const auto& Section : Module.sections()) {
+    const std::string& Name = Section.getName();
+    if (Section.blocks().empty() || Policy.skipSections.count(Name) ||
+        Name == ".note.GNU-stack") {
+      continue;
+    }
+    if (Section.isFlagSet(gtirb::SectionFlag::ThreadLocal)) {
+      return fail("section " + Name + " is thread-local");
+    }
+    auto Intervals = Section.byte_intervals();
+    if (std::distance(Intervals.begin(), Intervals.end()) != 1 ||
+        !Intervals.begin()->getAddress()) {
+      return fail("section " + Name +
+                  " does not have exactly one byte interval with an address");
+    }
+    const gtirb::ByteInterval& Interval = *Intervals.begin();
+
+    OutputSection Out{&Section, &Interval, SHT_PROGBITS, 0, 1, 0, {}, {}};
+    if (auto Properties = aux_data::getSectionProperties(Section)) {
+      auto [Type, Flags] = *Properties;
+      if (Flags & SHF_TLS) {
+        return fail("section " + Name + " is thread-local");
+      }
+      switch (Type) {
+      case SHT_PROGBITS:
+      case SHT_NOBITS:
+      case SHT_NOTE:
+      case SHT_INIT_ARRAY:
+      case SHT_FINI_ARRAY:
+      case SHT_PREINIT_ARRAY:
+        Out.Type = static_cast<uint32_t>(Type);
+        break;
+      default:
+        return fail("section " + Name + " has an unsupported type");
+      }
+      // The printer only reproduces these flags.
+      Out.Flags = Flags & (SHF_WRITE | SHF_ALLOC | SHF_EXECINSTR);
+    } else {
+      if (Name == ".symtab" || Name == ".strtab" || Name == ".shstrtab" ||
+          Name.rfind(".rela", 0) == 0) {
+        return fail("section " + Name + " has a reserved name");
+      }
+      if (Section.isFlagSet(gtirb::SectionFlag::Loaded)) {
+        Out.Flags |= SHF_ALLOC;
+      }
+      if (Section.isFlagSet(gtirb::SectionFlag::Writable)) {
+        Out.Flags |= SHF_WRITE;
+      }
+      if (Section.isFlagSet(gtirb::SectionFlag::Executable)) {
+        Out.Flags |= SHF_EXECINSTR;
+      }
+      if (!Section.isFlagSet(gtirb::SectionFlag::Initialized)) {
+        Out.Type = SHT_NOBITS;
+      }
+    }
+
+    Sections.push_back(std::move(Out));
+    SectionIndices.emplace(&Section, static_cast<uint16_t>(Sections.size()));
+    if (!layOutSection(Sections.back())) {
+      return false;
+    }
+  }
+
+  // Leave room for the .rela sections, .note.GNU-stack and the symbol and
+  // string tables.
+  if (2 * Sections.size() + 5 >= SHN_LORESERVE) {
+    return fail("the module has too many sections");
+  }
+  return true;
+}
+
+// The printer leaves out the contents of blocks in array sections that
+// start with a reference to a symbol it does not print.
+bool ObjectWriter::printsContents(const gtirb::Node& Block) const {
+  const auto* DB = gtirb::dyn_cast<gtirb::DataBlock>(&Block);
+  if (!DB || !Policy.arraySections.count(
+                 DB->getByteInterval()->getSection()->getName())) {
+    return true;
+  }
+  const auto* Expr = DB->getByteInterval()->getSymbolicExpression(
+      DB->getOffset());
+  const auto* Const = Expr ? std::get_if<gtirb::SymAddrConst>(Expr) : nullptr;
+  return !Const || !Const->Sym || Printer.isPrinted(*Const->Sym);
+}
+
+bool ObjectWriter::layOutSection(OutputSection& Out) {
+  // Place the blocks where the assembler places them in the listing: the
+  // blocks that are not printed and the bytes between blocks are left out,
+  // and each block is aligned as the printer requests.
+  const gtirb::ByteInterval& Interval = *Out.Interval;
+  // Offset in the interval of the end of the blocks placed so far.
+  uint64_t Printed = 0;
+  for (const auto& Block : Out.Section->blocks()) {
+    const auto* CB = gtirb::dyn_cast<gtirb::CodeBlock>(&Block);
+    const auto* DB = gtirb::dyn_cast<gtirb::DataBlock>(&Block);
+    if (CB ? !Printer.isPrinted(*CB) : !Printer.isPrinted(*DB)) {
+      continue;
+    }
+    uint64_t Offset = CB ? CB->getOffset() : DB->getOffset();
+    uint64_t Size = CB ? CB->getSize() : DB->getSize();
+
+    // Overlapping blocks are printed from the end of the blocks before
+    // them, without an alignment.
+    uint64_t Overlap = Offset < Printed ? std::min(Printed - Offset, Size) : 0;
+    if (Offset < Printed) {
+      if (CB) {
+        return failAt("overlapping code block", Out, Offset);
+      }
+    } else if (auto Alignment = CB ? Printer.listingAlignment(*CB)
+                                   : Printer.listingAlignment(*DB)) {
+      if (*Alignment == 0 || (*Alignment & (*Alignment - 1)) != 0) {
+        return failAt("block alignment is not a power of two", Out, Offset);
+      }
+      padTo(Out, *Alignment);
+      Out.Alignment = std::max(Out.Alignment, *Alignment);
+    }
+
+    bool Contents = printsContents(Block);
+    Placements[&Block] = {Out.Size - Overlap, Contents};
+    if (!Contents) {
+      continue;
+    }
+    Out.Size += Size - Overlap;
+    if (Out.Type != SHT_NOBITS) {
+      // Bytes past the initialized part of the interval are zero.
+      uint64_t Begin = Offset + Overlap, End = Offset + Size;
+      uint64_t Initialized =
+          std::clamp(Interval.getInitializedSize(), Begin, End);
+      Out.Data.append(Interval.rawBytes<char>() + Begin, Initialized - Begin);
+      Out.Data.append(End - Initialized, '\0');
+    }
+    Printed = std::max(Printed, Offset + Size);
+  }
+  return true;
+}
+
+bool ObjectWriter::collectSymbols() {
+  const auto& Renamed = Printer.listingNames();
+  for (const auto& Symbol : Module.symbols()) {
+    // References to the symbols the printer leaves out are printed as 0.
+    if (!Printer.isPrinted(Symbol)) {
+      continue;
+    }
+    auto Renaming = Renamed.find(&Symbol);
+    const std::string& Name =
+        Renaming == Renamed.end() ? Symbol.getName() : Renaming->second;
+    if (aux_data::getSymbolVersionString(Symbol)) {
+      return fail("symbol " + Name + " is versioned");
+    }
+
+    uint8_t Binding = STB_LOCAL, Type = STT_NOTYPE, Visibility = STV_DEFAULT;
+    uint64_t Size = 0;
+    if (auto Info = aux_data::getElfSymbolInfo(Symbol)) {
+      // FILE symbols are never printed.
+      if (Info->Type == "FILE") {
+        continue;
+      }
+      auto B = elfBinding(Info->Binding);
+      auto T = elfType(Info->Type);
+      auto V = elfVisibility(Info->Visibility);
+      if (!B || !T || !V) {
+        return fail("symbol " + Name + " has unsupported ELF symbol info");
+      }
+      if (Info->SectionIndex == SHN_COMMON) {
+        return fail("symbol " + Name + " is a common symbol");
+      }
+      Binding = *B;
+      Type = *T;
+      Visibility = *V;
+      // The printer only gives the sizes of objects.
+      if (Type == STT_OBJECT) {
+        Size = Info->Size;
+      }
+    }
+
+    SymbolEntry Entry{Name,
+                      static_cast<uint8_t>((Binding << 4) | Type),
+                      Visibility,
+                      SHN_UNDEF,
+                      0,
+                      Size};
+    const gtirb::Node* Block = Symbol.getReferent<gtirb::CodeBlock>();
+    if (!Block) {
+      Block = Symbol.getReferent<gtirb::DataBlock>();
+    }
+    if (const gtirb::Section* Section = referentSection(Symbol)) {
+      auto It = SectionIndices.find(Section);
+      auto Place = Placements.find(Block);
+      if (It == SectionIndices.end() || Place == Placements.end()) {
+        // Not printed; references become undefined.
+        if (Binding == STB_LOCAL) {
+          Entry.Info = static_cast<uint8_t>((STB_GLOBAL << 4) | Type);
+        }
+        Deferred.emplace(&Symbol, std::move(Entry));
+        continue;
+      }
+      Entry.SectionIndex = It->second;
+      Entry.Value = Place->second.Offset;
+      if (Symbol.getAtEnd()) {
+        const auto* CB = gtirb::dyn_cast<gtirb::CodeBlock>(Block);
+        Entry.Value += CB ? CB->getSize()
+                          : gtirb::cast<gtirb::DataBlock>(Block)->getSize();
+      }
+    } else if (Symbol.getAddress() && !Symbol.hasReferent()) {
+      Entry.SectionIndex = SHN_ABS;
+      Entry.Value = static_cast<uint64_t>(*Symbol.getAddress());
+    } else if (Binding == STB_LOCAL) {
+      // Undefined symbols are only declared if they have a binding.
+      Entry.Info = static_cast<uint8_t>((STB_GLOBAL << 4) | Type);
+      Deferred.emplace(&Symbol, std::move(Entry));
+      continue;
+    }
+
+    if (Binding == STB_LOCAL) {
+      Symbols[&Symbol] = {SymbolTablePart::Locals,
+                          static_cast<uint32_t>(Locals.size())};
+      Locals.push_back(std::move(Entry));
+    } else {
+      Symbols[&Symbol] = {SymbolTablePart::Globals,
+                          static_cast<uint32_t>(Globals.size())};
+      Globals.push_back(std::move(Entry));
+    }
+  }
+  return true;
+}
+
+std::optional<SymbolRef>
+ObjectWriter::referenceSymbol(const gtirb::Symbol& Symbol) {
+  if (auto It = Symbols.find(&Symbol); It != Symbols.end()) {
+    return It->second;
+  }
+  auto It = Deferred.find(&Symbol);
+  if (It == Deferred.end()) {
+    fail("symbol " + Symbol.getName() + " cannot be referenced");
+    return std::nullopt;
+  }
+  SymbolRef Ref{SymbolTablePart::Globals,
+                static_cast<uint32_t>(Globals.size())};
+  Globals.push_back(std::move(It->second));
+  Deferred.erase(It);
+  Symbols[&Symbol] = Ref;
+  return Ref;
+}
+
+bool ObjectWriter::relocateSection(OutputSection& Out, uint16_t Index) {
+  const gtirb::ByteInterval& Interval = *Out.Interval;
+  // Where the bytes at Offset are printed, by the first printed block that
+  // contains them. Expressions outside of any of them are not printed.
+  auto target = [this](auto Blocks, uint64_t Offset)
+      -> std::optional<std::pair<const gtirb::Node*, uint64_t>> {
+    for (const auto& Block : Blocks) {
+      if (auto It = Placements.find(&Block);
+          It != Placements.end() && It->second.Contents) {
+        return std::make_pair(&Block, It->second.Offset + Offset -
+                                          Block.getOffset());
+      }
+    }
+    return std::nullopt;
+  };
+  for (const auto& SEE : Interval.symbolic_expressions()) {
+    uint64_t Offset = SEE.getOffset();
+    if (auto Code = target(Interval.findCodeBlocksOnOffset(Offset), Offset)) {
+      if (Out.Type == SHT_NOBITS) {
+        return failAt("symbolic expression in an uninitialized section", Out,
+                      Offset);
+      }
+      if (!relocateCode(Out, Index,
+                        *gtirb::cast<gtirb::CodeBlock>(Code->first), Offset,
+                        Code->second, SEE.getSymbolicExpression())) {
+        return false;
+      }
+    } else if (auto Data = target(Interval.findDataBlocksOnOffset(Offset),
+                                  Offset)) {
+      if (Out.Type == SHT_NOBITS) {
+        return failAt("symbolic expression in an uninitialized section", Out,
+                      Offset);
+      }
+      if (!relocateData(Out, Index, SEE, Data->second)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool ObjectWriter::decodeBlock(const gtirb::CodeBlock& Block) {
+  DecodedBlock = &Block;
+  DecodedFields.clear();
+
+  const gtirb::ByteInterval* Interval = Block.getByteInterval();
+  uint64_t Start = Block.getOffset();
+  uint64_t End = Start + Block.getSize();
+  if (End > Interval->getInitializedSize()) {
+    return fail("code block is not initialized");
+  }
+
+  cs_insn* Insns = nullptr;
+  size_t Count =
+      cs_disasm(Capstone.get(), Interval->rawBytes<uint8_t>() + Start,
+                Block.getSize(), static_cast<uint64_t>(*Block.getAddress()),
+                0, &Insns);
+  uint64_t InsnOffset = Start;
+  for (size_t I = 0; I < Count; ++I) {
+    const cs_insn& Insn = Insns[I];
+    const cs_x86& X86 = Insn.detail->x86;
+    uint64_t InsnEnd = InsnOffset + Insn.size;
+
+    bool BranchRelative = false;
+    for (uint8_t G = 0; G < Insn.detail->groups_count; ++G) {
+      BranchRelative |= Insn.detail->groups[G] == CS_GRP_BRANCH_RELATIVE;
+    }
+
+    if (X86.encoding.imm_offset != 0 && X86.encoding.imm_size != 0) {
+      bool SignExtended = false;
+      for (uint8_t Op = 0; Op < X86.op_count; ++Op) {
+        if (X86.operands[Op].type == X86_OP_IMM) {
+          SignExtended = X86.operands[Op].size > X86.encoding.imm_size;
+          break;
+        }
+      }
+      uint64_t Field = InsnOffset + X86.encoding.imm_offset;
+      DecodedFields[Field] = {X86.encoding.imm_size, InsnEnd - Field,
+                              BranchRelative, BranchRelative, SignExtended};
+    }
+    if (X86.encoding.disp_offset != 0 && X86.encoding.disp_size != 0) {
+      bool RipRelative = false;
+      for (uint8_t Op = 0; Op < X86.op_count; ++Op) {
+        RipRelative |= X86.operands[Op].type == X86_OP_MEM &&
+                       X86.operands[Op].mem.base == X86_REG_RIP;
+      }
+      uint64_t Field = InsnOffset + X86.encoding.disp_offset;
+      DecodedFields[Field] = {X86.encoding.disp_size, InsnEnd - Field,
+                              RipRelative, false, X86.addr_size == 8};
+    }
+    InsnOffset = InsnEnd;
+  }
+  cs_free(Insns, Count);
+
+  if (InsnOffset != End) {
+    DecodedBlock = nullptr;
+    return fail("code block could not be decoded");
+  }
+  return true;
+}
+
+bool ObjectWriter::relocateCode(OutputSection& Out, uint16_t Index,
+                                const gtirb::CodeBlock& Block,
+                                uint64_t Offset, uint64_t Target,
+                                const gtirb::SymbolicExpression& Expr) {
+  const auto* Const = std::get_if<gtirb::SymAddrConst>(&Expr);
+  if (!Const || !Const->Sym) {
+    return failAt("unsupported symbolic operand", Out, Offset);
+  }
+  if (DecodedBlock != &Block && !decodeBlock(Block)) {
+    return failAt(Reason, Out, Block.getOffset());
+  }
+  auto FieldIt = DecodedFields.find(Offset);
+  if (FieldIt == DecodedFields.end()) {
+    return failAt("symbolic expression is not an instruction field", Out,
+                  Offset);
+  }
+  const CodeField& Field = FieldIt->second;
+
+  if (!Printer.isPrinted(*Const->Sym)) {
+    // The operand is printed as 0. The assembler resolves it in place,
+    // except for branches, which refer to the absolute address 0.
+    std::fill_n(&Out.Data[Target], Field.Size, '\0');
+    if (Field.Branch) {
+      if (Field.Size != 4) {
+        return failAt("short branch to a skipped symbol", Out, Offset);
+      }
+      Out.Relocations.push_back(
+          {Target, {SymbolTablePart::Null, 0}, R_X86_64_PC32,
+           -static_cast<int64_t>(Field.ToInsnEnd)});
+    }
+    return true;
+  }
+
+  const gtirb::SymAttributeSet& Attributes = Const->Attributes;
+  bool Got = Attributes.count(gtirb::SymAttribute::GOT);
+  bool PcRel = Attributes.count(gtirb::SymAttribute::PCREL);
+  if (hasUnsupportedAttribute(Attributes) || Got != PcRel) {
+    return failAt("unsupported symbolic operand attributes", Out, Offset);
+  }
+
+  auto Symbol = referenceSymbol(*Const->Sym);
+  if (!Symbol) {
+    return false;
+  }
+
+  Relocation Reloc{Target, *Symbol, 0, Const->Offset};
+  if (Got) {
+    if (!Field.PcRelative || Field.Branch || Field.Size != 4) {
+      return failAt("GOT reference is not RIP-relative", Out, Offset);
+    }
+    Reloc.Type = R_X86_64_GOTPCREL;
+    Reloc.Addend -= static_cast<int64_t>(Field.ToInsnEnd);
+  } else if (Field.PcRelative) {
+    Reloc.Addend -= static_cast<int64_t>(Field.ToInsnEnd);
+    const SymbolEntry& Entry = entry(*Symbol);
+    if (Symbol->Part == SymbolTablePart::Locals &&
+        Entry.SectionIndex == Index) {
+      // Like the assembler, resolve references to local labels in the same
+      // section without a relocation.
+      int64_t Value = static_cast<int64_t>(Entry.Value - Target) + Reloc.Addend;
+      if (!fitsField(Value, Field.Size)) {
+        return failAt("PC-relative operand is out of range", Out, Offset);
+      }
+      writeLittleEndian(&Out.Data[Target], static_cast<uint64_t>(Value),
+                        Field.Size);
+      return true;
+    }
+    if (Field.Size != 4) {
+      return failAt("short PC-relative operand needs a relocation", Out,
+                    Offset);
+    }
+    Reloc.Type =
+        Field.Branch && Symbol->Part == SymbolTablePart::Globals
+            ? R_X86_64_PLT32
+            : R_X86_64_PC32;
+  } else {
+    switch (Field.Size) {
+    case 8:
+      Reloc.Type = R_X86_64_64;
+      break;
+    case 4:
+      Reloc.Type = Field.SignExtended ? R_X86_64_32S : R_X86_64_32;
+      break;
+    case 2:
+      Reloc.Type = R_X86_64_16;
+      break;
+    default:
+      Reloc.Type = R_X86_64_8;
+      break;
+    }
+  }
+
+  std::fill_n(&Out.Data[Target], Field.Size, '\0');
+  Out.Relocations.push_back(Reloc);
+  return true;
+}
+
+bool ObjectWriter::relocateData(
+    OutputSection& Out, uint16_t Index,
+    const gtirb::ByteInterval::ConstSymbolicExpressionElement& SEE,
+    uint64_t Target) {
+  const gtirb::ByteInterval& Interval = *Out.Interval;
+  uint64_t Offset = SEE.getOffset();
+
+  // The size of the expression, as the printer determines it.
+  uint64_t Size = 0;
+  const auto* Sizes = aux_data::getSymbolicExpressionSizes(Module);
+  if (Sizes) {
+    if (auto It = Sizes->find(gtirb::Offset(Interval.getUUID(), Offset));
+        It != Sizes->end()) {
+      Size = It->second;
+    }
+  }
+  if (Size == 0) {
+    for (const auto& Block : Interval.findDataBlocksAtOffset(Offset)) {
+      uint64_t BlockSize = Block.getSize();
+      if ((BlockSize == 1 || BlockSize == 2 || BlockSize == 4 ||
+           BlockSize == 8) &&
+          BlockSize > Size) {
+        Size = BlockSize;
+      }
+    }
+  }
+  for (const auto& Block : Interval.findDataBlocksOnOffset(Offset)) {
+    auto Type = aux_data::getEncodingType(Block);
+    if (Type == "uleb128" || Type == "sleb128") {
+      return failAt("LEB128 symbolic data", Out, Offset);
+    }
+  }
+  if ((Size != 1 && Size != 2 && Size != 4 && Size != 8) ||
+      Target + Size > Out.Data.size()) {
+    return failAt("symbolic data has an unsupported size", Out, Offset);
+  }
+
+  Relocation Reloc{Target, {}, 0, 0};
+  if (const auto* Const =
+          std::get_if<gtirb::SymAddrConst>(&SEE.getSymbolicExpression())) {
+    if (!Const->Sym || hasUnsupportedAttribute(Const->Attributes) ||
+        Const->Attributes.count(gtirb::SymAttribute::GOT) ||
+        Const->Attributes.count(gtirb::SymAttribute::PCREL) ||
+        Const->Attributes.count(gtirb::SymAttribute::PLT)) {
+      return failAt("unsupported symbolic data", Out, Offset);
+    }
+    if (!Printer.isPrinted(*Const->Sym)) {
+      // Printed as 0.
+      std::fill_n(&Out.Data[Target], Size, '\0');
+      return true;
+    }
+    auto Symbol = referenceSymbol(*Const->Sym);
+    if (!Symbol) {
+      return false;
+    }
+    Reloc.Symbol = *Symbol;
+    Reloc.Addend = Const->Offset;
+    Reloc.Type = Size == 8   ? R_X86_64_64
+                 : Size == 4 ? R_X86_64_32
+                 : Size == 2 ? R_X86_64_16
+                             : R_X86_64_8;
+  } else if (const auto* Addr = std::get_if<gtirb::SymAddrAddr>(
+                 &SEE.getSymbolicExpression())) {
+    if (!Addr->Sym1 || !Addr->Sym2 || Addr->Scale != 1 ||
+        hasUnsupportedAttribute(Addr->Attributes)) {
+      return failAt("unsupported symbolic data", Out, Offset);
+    }
+    if (!Printer.isPrinted(*Addr->Sym1) || !Printer.isPrinted(*Addr->Sym2)) {
+      return failAt("symbol difference with a skipped symbol", Out, Offset);
+    }
+    auto Symbol = referenceSymbol(*Addr->Sym1);
+    auto Base = referenceSymbol(*Addr->Sym2);
+    if (!Symbol || !Base) {
+      return false;
+    }
+    // The assembler can only encode differences with a base in the section
+    // being assembled.
+    const SymbolEntry& BaseEntry = entry(*Base);
+    if (BaseEntry.SectionIndex != Index) {
+      return failAt("symbol difference with a base in another section", Out,
+                    Offset);
+    }
+    const SymbolEntry& TargetEntry = entry(*Symbol);
+    if (TargetEntry.SectionIndex == Index) {
+      int64_t Value =
+          static_cast<int64_t>(TargetEntry.Value - BaseEntry.Value) +
+          Addr->Offset;
+      if (!fitsField(Value, Size)) {
+        return failAt("symbol difference is out of range", Out, Offset);
+      }
+      writeLittleEndian(&Out.Data[Target], static_cast<uint64_t>(Value), Size);
+      return true;
+    }
+    Reloc.Symbol = *Symbol;
+    Reloc.Addend =
+        Addr->Offset + static_cast<int64_t>(Target - BaseEntry.Value);
+    Reloc.Type = Size == 8   ? R_X86_64_PC64
+                 : Size == 4 ? R_X86_64_PC32
+                 : Size == 2 ? R_X86_64_PC16
+                             : R_X86_64_PC8;
+  } else {
+    return failAt("unsupported symbolic data", Out, Offset);
+  }
+
+  std::fill_n(&Out.Data[Target], Size, '\0');
+  Out.Relocations.push_back(Reloc);
+  return true;
+}
+
+void ObjectWriter::serialize(std::string& Object) const {
+  struct SectionHeader {
+    uint32_t Name;
+    uint32_t Type;
+    uint64_t Flags;
+    uint64_t Offset;
+    uint64_t Size;
+    uint32_t Link;
+    uint32_t Info;
+    uint64_t Alignment;
+    uint64_t EntrySize;
+  };
+
+  // Section header table: the null section, the printed sections, one .rela
+  // section for each printed section with relocations, an empty
+  // .note.GNU-stack (so that the object does not request an executable
+  // stack), then the tables.
+  size_t RelaCount = std::count_if(
+      Sections.begin(), Sections.end(),
+      [](const OutputSection& Out) { return !Out.Relocations.empty(); });
+  uint32_t NoteIndex = static_cast<uint32_t>(1 + Sections.size() + RelaCount);
+  uint32_t SymtabIndex = NoteIndex + 1;
+  uint32_t StrtabIndex = SymtabIndex + 1;
+  uint32_t ShstrtabIndex = SymtabIndex + 2;
+  std::vector<SectionHeader> Headers(ShstrtabIndex + 1, SectionHeader{});
+
+  uint32_t FirstLocal = static_cast<uint32_t>(1 + Sections.size());
+  uint32_t FirstGlobal = FirstLocal + static_cast<uint32_t>(Locals.size());
+  auto symbolIndex = [&](SymbolRef Ref) -> uint64_t {
+    switch (Ref.Part) {
+    case SymbolTablePart::Locals:
+      return FirstLocal + Ref.Index;
+    case SymbolTablePart::Globals:
+      return FirstGlobal + Ref.Index;
+    default:
+      return 0;
+    }
+  };
+
+  StringTable SectionNames;
+  Object.assign(64, '\0');
+
+  for (size_t I = 0; I < Sections.size(); ++I) {
+    const OutputSection& Out = Sections[I];
+    alignTo(Object, Out.Alignment);
+    Headers[I + 1] = {SectionNames.add(Out.Section->getName()),
+                      Out.Type,
+                      Out.Flags,
+                      Object.size(),
+                      Out.Size,
+                      0,
+                      0,
+                      Out.Alignment,
+                      0};
+    Object.append(Out.Data);
+  }
+
+  uint32_t RelaIndex = static_cast<uint32_t>(1 + Sections.size());
+  for (size_t I = 0; I < Sections.size(); ++I) {
+    const OutputSection& Out = Sections[I];
+    if (Out.Relocations.empty()) {
+      continue;
+    }
+    alignTo(Object, 8);
+    uint64_t Start = Object.size();
+    for (const Relocation& Reloc : Out.Relocations) {
+      appendLittleEndian<uint64_t>(Object, Reloc.Offset);
+      appendLittleEndian<uint64_t>(Object,
+                                   (symbolIndex(Reloc.Symbol) << 32) |
+                                       Reloc.Type);
+      appendLittleEndian<int64_t>(Object, Reloc.Addend);
+    }
+    Headers[RelaIndex++] = {
+        SectionNames.add(".rela" + Out.Section->getName()),
+        SHT_RELA,
+        SHF_INFO_LINK,
+        Start,
+        Object.size() - Start,
+        SymtabIndex,
+        static_cast<uint32_t>(I + 1),
+        8,
+        24};
+  }
+
+  Headers[NoteIndex] = {SectionNames.add(".note.GNU-stack"),
+                        SHT_PROGBITS,
+                        0,
+                        Object.size(),
+                        0,
+                        0,
+                        0,
+                        1,
+                        0};
+
+  StringTable SymbolNames;
+  auto appendSymbol = [&](const SymbolEntry& Entry) {
+    appendLittleEndian<uint32_t>(Object, SymbolNames.add(Entry.Name));
+    appendLittleEndian<uint8_t>(Object, Entry.Info);
+    appendLittleEndian<uint8_t>(Object, Entry.Other);
+    appendLittleEndian<uint16_t>(Object, Entry.SectionIndex);
+    appendLittleEndian<uint64_t>(Object, Entry.Value);
+    appendLittleEndian<uint64_t>(Object, Entry.Size);
+  };
+  alignTo(Object, 8);
+  uint64_t SymtabStart = Object.size();
+  appendSymbol(SymbolEntry{"", 0, 0, SHN_UNDEF, 0, 0});
+  for (size_t I = 0; I < Sections.size(); ++I) {
+    appendSymbol(SymbolEntry{"", (STB_LOCAL << 4) | STT_SECTION, STV_DEFAULT,
+                             static_cast<uint16_t>(I + 1), 0, 0});
+  }
+  std::for_each(Locals.begin(), Locals.end(), appendSymbol);
+  std::for_each(Globals.begin(), Globals.end(), appendSymbol);
+  Headers[SymtabIndex] = {SectionNames.add(".symtab"),
+                          SHT_SYMTAB,
+                          0,
+                          SymtabStart,
+                          Object.size() - SymtabStart,
+                          StrtabIndex,
+                          FirstGlobal,
+                          8,
+                          24};
+
+  Headers[StrtabIndex] = {SectionNames.add(".strtab"),
+                          SHT_STRTAB,
+                          0,
+                          Object.size(),
+                          SymbolNames.data().size(),
+                          0,
+                          0,
+                          1,
+                          0};
+  Object.append(SymbolNames.data());
+
+  uint32_t ShstrtabName = SectionNames.add(".shstrtab");
+  Headers[ShstrtabIndex] = {ShstrtabName,
+                            SHT_STRTAB,
+                            0,
+                            Object.size(),
+                            SectionNames.data().size(),
+                            0,
+                            0,
+                            1,
+                            0};
+  Object.append(SectionNames.data());
+
+  alignTo(Object, 8);
+  uint64_t HeadersStart = Object.size();
+  for (const SectionHeader& Header : Headers) {
+    appendLittleEndian<uint32_t>(Object, Header.Name);
+    appendLittleEndian<uint32_t>(Object, Header.Type);
+    appendLittleEndian<uint64_t>(Object, Header.Flags);
+    appendLittleEndian<uint64_t>(Object, 0); // sh_addr
+    appendLittleEndian<uint64_t>(Object, Header.Offset);
+    appendLittleEndian<uint64_t>(Object, Header.Size);
+    appendLittleEndian<uint32_t>(Object, Header.Link);
+    appendLittleEndian<uint32_t>(Object, Header.Info);
+    appendLittleEndian<uint64_t>(Object, Header.Alignment);
+    appendLittleEndian<uint64_t>(Object, Header.EntrySize);
+  }
+
+  std::string ElfHeader{'\x7f', 'E', 'L', 'F',
+                        2, // ELFCLASS64
+                        1, // ELFDATA2LSB
+                        EV_CURRENT};
+  ElfHeader.resize(16, '\0');
+  appendLittleEndian<uint16_t>(ElfHeader, ET_REL);
+  appendLittleEndian<uint16_t>(ElfHeader, EM_X86_64);
+  appendLittleEndian<uint32_t>(ElfHeader, EV_CURRENT);
+  appendLittleEndian<uint64_t>(ElfHeader, 0); // e_entry
+  appendLittleEndian<uint64_t>(ElfHeader, 0); // e_phoff
+  appendLittleEndian<uint64_t>(ElfHeader, HeadersStart);
+  appendLittleEndian<uint32_t>(ElfHeader, 0);  // e_flags
+  appendLittleEndian<uint16_t>(ElfHeader, 64); // e_ehsize
+  appendLittleEndian<uint16_t>(ElfHeader, 0);  // e_phentsize
+  appendLittleEndian<uint16_t>(ElfHeader, 0);  // e_phnum
+  appendLittleEndian<uint16_t>(ElfHeader, 64); // e_shentsize
+  appendLittleEndian<uint16_t>(ElfHeader,
+                               static_cast<uint16_t>(Headers.size()));
+  appendLittleEndian<uint16_t>(ElfHeader,
+                               static_cast<uint16_t>(ShstrtabIndex));
+  Object.replace(0, ElfHeader.size(), ElfHeader);
+}
+
+} // namespace
+
+bool writeElfObject(gtirb_pprint::PrettyPrinterBase& Printer,
+                    const gtirb::Module& Module,
+                    const gtirb_pprint::PrintingPolicy& Policy,
+                    std::string& Object, std::string& Reason) {
+  ObjectWriter Writer(Printer, Module, Policy);
+  if (!Writer.write(Object)) {
+    Reason = Writer.reason();
+    return false;
+  }
+  return true;
+}
+
+} // namespace gtirb_bprint
@@ -94,7 +94,6 @@ ElfPrettyPrinter::ElfPrettyPrinter(gtirb::Context& context_,
       elfSyntax(syntax_) {
 
   skipVersionSymbols();
-  computeFunctionAliases();
 }
 
 void ElfPrettyPrinter::skipVersionSymbols() {
@@ -116,8 +115,9 @@ void ElfPrettyPrinter::skipVersionSymbols() {
   }
 }
 
-void ElfPrettyPrinter::computeFunctionAliases() {
-  for (const auto* Symbol : FunctionSymbols) {
+void ElfPrettyPrinter::computeFunctionAliases(
+    FunctionInformation& Info) const {
+  for (const auto* Symbol : Info.FunctionSymbols) {
     if (!Symbol->getAddress()) {
       continue;
     }
@@ -128,7 +128,7 @@ void ElfPrettyPrinter::computeFunctionAliases() {
       auto AliasSymInfo = aux_data::getElfSymbolInfo(Alias);
       if (AliasSymInfo &&
           (AliasSymInfo->Type == "FUNC" || AliasSymInfo->Type == "GNU_IFUNC")) {
-        FunctionAliases[Symbol].insert(&Alias);
+        Info.FunctionAliases[Symbol].insert(&Alias);
       }
     }
   }
@@ -202,9 +202,8 @@ void ElfPrettyPrinter::printSectionFooterDirective(
 }
 
 void ElfPrettyPrinter::printByte(std::ostream& os, std::byte byte) {
-  std::ios_base::fmtflags flags = os.flags();
-  os << syntax.byteData() << " 0x" << std::hex << static_cast<uint32_t>(byte);
-  os.flags(flags);
+  os << syntax.byteData() << ' ';
+  writeHex(os, static_cast<uint64_t>(byte), syntax.hexFormat());
 }
 
 void ElfPrettyPrinter::printFooter(std::ostream& /* os */){};
@@ -224,7 +223,7 @@ void ElfPrettyPrinter::printSymbolHeader(std::ostream& os,
     if (SymbolInfo->Type == "FILE") {
       return;
     }
-    auto Name = getSymbolName(sym);
+    auto Name = getSymbolSpelling(sym);
     printBar(os, false);
 
     if (Version) {
@@ -275,7 +274,7 @@ void ElfPrettyPrinter::printSymbolHeader(std::ostream& os,
 }
 
 void ElfPrettyPrinter::printSymbolType(
-    std::ostream& os, std::string& Name,
+    std::ostream& os, std::string_view Name,
     const aux_data::ElfSymbolInfo& SymbolInfo) {
   static const std::unordered_map<std::string, std::string> TypeNameConversion =
       {
@@ -297,7 +296,7 @@ void ElfPrettyPrinter::printSymbolType(
 }
 
 void ElfPrettyPrinter::printSymbolSize(
-    std::ostream& OS, std::string& Name,
+    std::ostream& OS, std::string_view Name,
     const aux_data::ElfSymbolInfo& SymbolInfo) {
   auto Size = SymbolInfo.Size;
   if (Size != 0) {
@@ -307,7 +306,7 @@ void ElfPrettyPrinter::printSymbolSize(
 
 void ElfPrettyPrinter::printFunctionEnd(std::ostream& OS,
                                         const gtirb::Symbol& FunctionSymbol) {
-  std::string FunctionName = getSymbolName(FunctionSymbol);
+  std::string_view FunctionName = getSymbolSpelling(FunctionSymbol);
   OS << elfSyntax.symSize() << ' ' << FunctionName << ", . - " << FunctionName
      << "\n";
 }
@@ -362,7 +361,7 @@ void ElfPrettyPrinter::printSymbolDefinitionRelativeToPC(
     std::ostream& os, const gtirb::Symbol& sym, gtirb::Addr pc) {
   printSymbolHeader(os, sym);
 
-  os << elfSyntax.set() << ' ' << getSymbolName(sym) << ", "
+  os << elfSyntax.set() << ' ' << getSymbolSpelling(sym) << ", "
      << syntax.programCounter();
   auto symAddr = *sym.getAddress();
   if (symAddr > pc) {
@@ -414,10 +413,24 @@ void ElfPrettyPrinter::printIntegralSymbol(std::ostream& Stream,
 
   printSymbolHeader(Stream, Symbol);
 
-  Stream << elfSyntax.set() << ' ' << getSymbolName(Symbol) << ", "
+  Stream << elfSyntax.set() << ' ' << getSymbolSpelling(Symbol) << ", "
          << *Symbol.getAddress() << '\n';
 }
 
+void ElfPrettyPrinter::printShardExport(std::ostream& Stream,
+                                        const gtirb::Symbol& Symbol) {
+  // Global and weak symbols are already visible outside their shard. Local
+  // ones are made global but hidden, so that they do not leave the module;
+  // the linker makes hidden symbols local again in its output.
+  if (auto SymbolInfo = aux_data::getElfSymbolInfo(Symbol);
+      SymbolInfo && SymbolInfo->Binding != "LOCAL") {
+    return;
+  }
+  std::string_view Name = getSymbolSpelling(Symbol);
+  Stream << syntax.global() << ' ' << Name << '\n'
+         << elfSyntax.hidden() << ' ' << Name << '\n';
+}
+
 void ElfPrettyPrinter::printUndefinedSymbol(std::ostream& Stream,
                                             const gtirb::Symbol& Symbol) {
 
@@ -465,14 +478,19 @@ void ElfPrettyPrinter::printString(std::ostream& Stream,
   Stream << (NullTerminated ? elfSyntax.string() : elfSyntax.ascii()) << " \"";
 
   auto Bytes = Block.bytes<uint8_t>();
-  auto It = boost::make_iterator_range(Bytes.begin() + Offset, Bytes.end());
-  for (auto Byte : It) {
-    if (Byte != 0) {
-      Stream << syntax.escapeByte(Byte);
-    }
+  std::string_view Data(Block.rawBytes<char>() + Offset,
+                        std::distance(Bytes.begin(), Bytes.end()) - Offset);
+
+  // NUL bytes are dropped: .string supplies the terminator itself.
+  std::string Escaped;
+  Escaped.reserve(Data.size());
+  for (size_t Pos = 0; Pos < Data.size();) {
+    size_t Nul = std::min(Data.find('\0', Pos), Data.size());
+    syntax.escapeString(Escaped, Data.substr(Pos, Nul - Pos));
+    Pos = Nul + 1;
   }
 
-  Stream << '"';
+  Stream << Escaped << '"';
 }
 
 std::optional<uint64_t>
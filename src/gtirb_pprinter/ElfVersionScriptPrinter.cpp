@@ -22,26 +22,20 @@
 
 namespace gtirb_pprint {
 
-bool printVersionScript(const gtirb::Context& Context,
-                        const gtirb::Module& Module,
-                        std::ofstream& VersionScript) {
+std::optional<std::string> buildVersionScript(const gtirb::Context& Context,
+                                              const gtirb::Module& Module) {
   LOG_INFO << "Preparing linker version script...\n";
-  if (!VersionScript.is_open()) {
-    LOG_ERROR << "Unable to open version script file \n";
-    return false;
-  }
-
   if (Module.getFileFormat() != gtirb::FileFormat::ELF) {
     LOG_WARNING << "Module: " << Module.getBinaryPath()
                 << "is not ELF; cannot generate symbol versions.\n";
-    return false;
+    return std::nullopt;
   }
 
-  auto SymbolVersions = aux_data::getSymbolVersions(Module);
+  const auto* SymbolVersions = aux_data::getSymbolVersions(Module);
   if (!SymbolVersions) {
     LOG_INFO << "Module: " << Module.getBinaryPath()
              << "contains no symbol versions\n";
-    return true;
+    return std::string{};
   }
   auto& [SymVerDefs, SymVersNeeded, SymVerEntries] = *SymbolVersions;
 
@@ -49,6 +43,7 @@ bool printVersionScript(const gtirb::Context& Context,
   std::unordered_map<gtirb::provisional_schema::SymbolVersionId,
                      std::vector<const gtirb::Symbol*>>
       VerIdToGlobalSymbols;
+  VerIdToGlobalSymbols.reserve(SymVerDefs.size());
   for (auto const& Entry : SymVerEntries) {
     const auto* Symbol = nodeFromUUID<gtirb::Symbol>(Context, Entry.first);
     if (auto SymbolInfo = aux_data::getElfSymbolInfo(*Symbol)) {
@@ -58,6 +53,7 @@ bool printVersionScript(const gtirb::Context& Context,
     }
   }
 
+  std::string Script;
   for (auto& [VerId, VerDef] : SymVerDefs) {
     auto& VerNames = std::get<0>(VerDef);
     uint16_t VerDefFlags = std::get<1>(VerDef);
@@ -70,36 +66,53 @@ bool printVersionScript(const gtirb::Context& Context,
     const std::string& MainVersion = *VerNames.begin();
     auto Predecessors = ++VerNames.begin();
 
-    std::vector<const gtirb::Symbol*> GlobalSymbols =
-        VerIdToGlobalSymbols[VerId];
-
-    VersionScript << MainVersion << " {\n";
-    if (GlobalSymbols.size() > 0) {
-      VersionScript << "  global:\n";
-    }
-    for (const gtirb::Symbol* Sym : GlobalSymbols) {
-      VersionScript << "    " << Sym->getName() << ";\n";
+    Script += MainVersion;
+    Script += " {\n";
+    if (auto It = VerIdToGlobalSymbols.find(VerId);
+        It != VerIdToGlobalSymbols.end()) {
+      Script += "  global:\n";
+      for (const gtirb::Symbol* Sym : It->second) {
+        Script += "    ";
+        Script += Sym->getName();
+        Script += ";\n";
+      }
     }
-    VersionScript << "}";
+    Script += '}';
 
     bool First = true;
     for (; Predecessors != VerNames.end(); Predecessors++) {
       if (!First) {
-        VersionScript << ", ";
+        Script += ", ";
       }
-      VersionScript << *Predecessors;
+      Script += *Predecessors;
     }
-    VersionScript << ";\n\n";
+    Script += ";\n\n";
   }
 
-  return VersionScript.tellp() > 0;
+  return Script;
+}
+
+bool printVersionScript(const gtirb::Context& Context,
+                        const gtirb::Module& Module,
+                        std::ostream& VersionScript) {
+  if (!VersionScript) {
+    LOG_ERROR << "Unable to open version script file \n";
+    return false;
+  }
+
+  std::optional<std::string> Script = buildVersionScript(Context, Module);
+  if (!Script) {
+    return false;
+  }
+  VersionScript << *Script;
+  return !Script->empty() || !aux_data::getSymbolVersions(Module);
 }
 
 bool printVersionScriptForDummySo(const gtirb::Module& Module,
-                                  std::ofstream& VersionScript) {
+                                  std::ostream& VersionScript) {
 
   LOG_INFO << "Preparing linker version script for dummy_so...\n";
-  if (!VersionScript.is_open()) {
+  if (!VersionScript) {
     LOG_ERROR << "Unable to open version script file for dummy_so\n";
     return false;
   }
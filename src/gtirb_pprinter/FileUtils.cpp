@@ -58,7 +58,7 @@ TempFile::TempFile(const std::string extension) {
   ::close(mkstemps(TmpFileName.data(), extension.length())); // Create tmp file
 #endif // _WIN32
   Name = TmpFileName;
-  FileStream.open(Name);
+  FileStream = std::make_unique<gtirb_pprint::OutputSinkStream>(Name);
 }
 
 TempFile::TempFile(TempFile&& Other)
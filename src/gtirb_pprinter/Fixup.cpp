@@ -14,32 +14,102 @@
 //===----------------------------------------------------------------------===//
 
 #include "Fixup.hpp"
+#include "AuxDataSchema.hpp"
 #include "AuxDataUtils.hpp"
 #include "PrettyPrinter.hpp"
 #include "driver/Logger.h"
+#include <algorithm>
 #include <gtirb/gtirb.hpp>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <variant>
+#include <vector>
 
 namespace gtirb_pprint {
 
-void applyFixups(gtirb::Context& Context, gtirb::Module& Module,
-                 const PrettyPrinter& Printer) {
+bool FixupReport::changed() const {
+  return std::any_of(Passes.begin(), Passes.end(),
+                     [](const FixupPassStats& P) { return P.changed(); });
+}
+
+FixupReport applyFixups(gtirb::Context& Context, gtirb::Module& Module,
+                        const PrettyPrinter& Printer,
+                        const FixupOptions& Options) {
+  FixupReport Report;
+  Report.DryRun = Options.DryRun;
+
+  // Passes already applied to the module, as recorded in the printer's
+  // module caches, are skipped. Editing the module takes an invalidation of
+  // those caches, which drops the record.
+  auto runPass = [&](const char* Name, auto Pass) {
+    if (!Options.Force && Printer.isFixupApplied(Context, Module, Name)) {
+      FixupPassStats Stats;
+      Stats.Name = Name;
+      Stats.Cached = true;
+      Report.Passes.push_back(std::move(Stats));
+      return;
+    }
+
+    auto Start = std::chrono::steady_clock::now();
+    FixupPassStats Stats = Pass(Context, Module, Options.DryRun);
+    Stats.WallTime = std::chrono::steady_clock::now() - Start;
+    Stats.Name = Name;
+    if (!Options.DryRun) {
+      Printer.setFixupApplied(Context, Module, Name);
+    }
+    Report.Passes.push_back(std::move(Stats));
+  };
+
   auto format = std::get<0>(Printer.getTarget());
   if (format == "pe") {
-    fixupPESymbols(Context, Module);
+    runPass("pe-symbols", fixupPESymbols);
   }
   if (format == "elf") {
-    fixupELFSymbols(Context, Module);
+    runPass("elf-symbols", fixupELFSymbols);
     if (Printer.getDynMode(Module) == DYN_MODE_SHARED) {
-      fixupSharedObject(Context, Module);
+      runPass("shared-object", fixupSharedObject);
     }
 
     if (Module.getISA() == gtirb::ISA::IA32) {
-      fixupGetPcThunkNames(Context, Module);
+      runPass("get-pc-thunk-names", fixupGetPcThunkNames);
+    }
+  }
+
+  return Report;
+}
+
+void printFixupReport(std::ostream& Stream, const gtirb::Module& Module,
+                      const FixupReport& Report) {
+  Stream << "Fixups " << (Report.DryRun ? "that would be applied" : "applied")
+         << " to module " << Module.getName() << ":\n";
+  if (Report.Passes.empty()) {
+    Stream << "  (none)\n";
+    return;
+  }
+  for (const auto& Pass : Report.Passes) {
+    auto Micros =
+        std::chrono::duration_cast<std::chrono::microseconds>(Pass.WallTime);
+    Stream << "  " << std::left << std::setw(20) << Pass.Name << std::right;
+    if (Pass.Cached) {
+      Stream << "  (already applied)\n";
+      continue;
     }
+    Stream << std::dec << std::setw(10) << Micros.count() << " us"
+           << "  scanned=" << Pass.SymbolsScanned
+           << " modified=" << Pass.SymbolsModified
+           << " created=" << Pass.SymbolsCreated
+           << " rewritten=" << Pass.ExpressionsRewritten
+           << " aliases=" << Pass.AliasesCreated << "\n";
   }
 }
 
-void fixupSharedObject(gtirb::Context& Context, gtirb::Module& Module) {
+FixupPassStats fixupSharedObject(gtirb::Context& Context,
+                                 gtirb::Module& Module, bool DryRun) {
+  FixupPassStats Stats;
+  // Resolved here rather than shared with the printer: the fixups run before
+  // the printer's table is built, and other passes edit the forwarding.
+  const aux_data::SymbolForwardingTable Forwarding(Context, Module);
   std::unordered_set<gtirb::Symbol*> SymbolsToAlias;
   std::vector<gtirb::ByteInterval::SymbolicExpressionElement> SEEsToAlias,
       SEEsToPLT;
@@ -68,6 +138,7 @@ void fixupSharedObject(gtirb::Context& Context, gtirb::Module& Module) {
           SEE.getSymbolicExpression());
 
       for (auto* Symbol : SymsToCheck) {
+        Stats.SymbolsScanned++;
         if (!Symbol->hasReferent() && Symbol->getAddress()) {
           continue; // integral symbols don't need fixed up
         }
@@ -78,7 +149,7 @@ void fixupSharedObject(gtirb::Context& Context, gtirb::Module& Module) {
             // shared objects
             if (!Symbol->hasReferent() ||
                 Symbol->getReferent<gtirb::ProxyBlock>() ||
-                aux_data::getForwardedSymbol(Symbol)) {
+                Forwarding.lookup(Symbol)) {
               if (Info->Type == "FUNC") {
                 // need to turn into a PLT reference
                 SEEsToPLT.push_back(SEE);
@@ -94,6 +165,12 @@ void fixupSharedObject(gtirb::Context& Context, gtirb::Module& Module) {
     }
   }
 
+  Stats.AliasesCreated = SymbolsToAlias.size();
+  Stats.ExpressionsRewritten = SEEsToAlias.size() + SEEsToPLT.size();
+  if (DryRun) {
+    return Stats;
+  }
+
   // make a hidden alias for every global symbol that is called
   // directly by a code block
   using GlobalToHiddenSymsType =
@@ -147,24 +224,25 @@ void fixupSharedObject(gtirb::Context& Context, gtirb::Module& Module) {
   }
 
   // make bad code block references to extern symbols go through the PLT
+  auto Forward = [&Context, &Forwarding](gtirb::Symbol* Symbol) {
+    if (const auto* Target = Forwarding.lookup(Symbol)) {
+      // The table only holds const symbols; get the mutable one.
+      return getByUUID<gtirb::Symbol>(Context, Target->getUUID());
+    }
+    return Symbol;
+  };
   for (auto SEE : SEEsToPLT) {
     auto SEToAdd = std::visit(
-        [&Context](const auto& SE) -> gtirb::SymbolicExpression {
+        [&Forward](const auto& SE) -> gtirb::SymbolicExpression {
           using T = std::decay_t<decltype(SE)>;
           T NewSE{SE};
           NewSE.Attributes.insert(gtirb::SymAttribute::PLT);
 
           if constexpr (std::is_same_v<T, gtirb::SymAddrAddr>) {
-            if (auto Target = aux_data::getForwardedSymbol(SE.Sym1)) {
-              NewSE.Sym1 = getByUUID<gtirb::Symbol>(Context, *Target);
-            }
-            if (auto Target = aux_data::getForwardedSymbol(SE.Sym2)) {
-              NewSE.Sym2 = getByUUID<gtirb::Symbol>(Context, *Target);
-            }
+            NewSE.Sym1 = Forward(SE.Sym1);
+            NewSE.Sym2 = Forward(SE.Sym2);
           } else if constexpr (std::is_same_v<T, gtirb::SymAddrConst>) {
-            if (auto Target = aux_data::getForwardedSymbol(SE.Sym)) {
-              NewSE.Sym = getByUUID<gtirb::Symbol>(Context, *Target);
-            }
+            NewSE.Sym = Forward(SE.Sym);
           }
 
           return {NewSE};
@@ -172,7 +250,8 @@ void fixupSharedObject(gtirb::Context& Context, gtirb::Module& Module) {
         SEE.getSymbolicExpression());
     SEE.getByteInterval()->addSymbolicExpression(SEE.getOffset(), SEToAdd);
   }
-};
+  return Stats;
+}
 
 /**
 Update an ELF symbol's binding/visibility to GLOBAL/HIDDEN
@@ -187,16 +266,26 @@ static void promoteSymbolBinding(gtirb::Symbol& Sym) {
   aux_data::setElfSymbolInfo(Sym, NewSymInfo);
 }
 
-void fixupELFSymbols(gtirb::Context& Context, gtirb::Module& Module) {
+FixupPassStats fixupELFSymbols(gtirb::Context& Context, gtirb::Module& Module,
+                               bool DryRun) {
+  FixupPassStats Stats;
+  auto promote = [&](gtirb::Symbol& Symbol) {
+    Stats.SymbolsModified++;
+    if (!DryRun) {
+      promoteSymbolBinding(Symbol);
+    }
+  };
+
   // Promote main
   // Allows _start to reference main when using --policy=dynamic
   // With --policy=complete, this is unnecessary, but should have no impact on
   // the final binary.
   if (auto It = Module.findSymbols("main"); !It.empty()) {
     auto& Symbol = *It.begin();
+    Stats.SymbolsScanned++;
     if (auto SymInfo = aux_data::getElfSymbolInfo(Symbol)) {
       if (SymInfo->Binding != "GLOBAL") {
-        promoteSymbolBinding(Symbol);
+        promote(Symbol);
       }
     }
   }
@@ -204,9 +293,10 @@ void fixupELFSymbols(gtirb::Context& Context, gtirb::Module& Module) {
   // Promote _start if it is not global
   if (auto It = Module.findSymbols("_start"); !It.empty()) {
     auto& Symbol = *It.begin();
+    Stats.SymbolsScanned++;
     if (auto SymInfo = aux_data::getElfSymbolInfo(Symbol)) {
       if (SymInfo->Binding != "GLOBAL") {
-        promoteSymbolBinding(Symbol);
+        promote(Symbol);
       }
     }
   }
@@ -219,10 +309,15 @@ void fixupELFSymbols(gtirb::Context& Context, gtirb::Module& Module) {
     }
 
     auto Symbols = Module.findSymbols(*Block);
+    Stats.SymbolsScanned += std::distance(Symbols.begin(), Symbols.end());
     if (!aux_data::findSymWithBinding(Symbols, "GLOBAL")) {
       if (auto LocalSym = aux_data::findSymWithBinding(Symbols, "LOCAL")) {
-        promoteSymbolBinding(*LocalSym);
+        promote(*LocalSym);
       } else {
+        Stats.SymbolsCreated++;
+        if (DryRun) {
+          return;
+        }
         std::string Name = DefaultName;
         for (unsigned int Count = 0; !Module.findSymbols(Name).empty();
              Count++) {
@@ -242,28 +337,43 @@ void fixupELFSymbols(gtirb::Context& Context, gtirb::Module& Module) {
   ensureGlobalSymbolAt(
       aux_data::getCodeBlock<gtirb::schema::ElfDynamicFini>(Context, Module),
       "_fini");
-};
+  return Stats;
+}
 
-void fixupPESymbols(gtirb::Context& Context, gtirb::Module& Module) {
+FixupPassStats fixupPESymbols(gtirb::Context& Context, gtirb::Module& Module,
+                              bool DryRun) {
+  FixupPassStats Stats;
   if (auto It = Module.findSymbols("__ImageBase"); !It.empty()) {
     auto ImageBase = &*It.begin();
-    ImageBase->setReferent(Module.addProxyBlock(Context));
-    if (Module.getISA() == gtirb::ISA::IA32) {
-      ImageBase->setName("___ImageBase");
+    Stats.SymbolsScanned++;
+    Stats.SymbolsModified++;
+    if (!DryRun) {
+      ImageBase->setReferent(Module.addProxyBlock(Context));
+      if (Module.getISA() == gtirb::ISA::IA32) {
+        ImageBase->setName("___ImageBase");
+      }
     }
   }
 
   if (auto* Block = Module.getEntryPoint(); Block && Block->getAddress()) {
-    if (auto It = Module.findSymbols(*Block->getAddress()); It.empty()) {
+    auto It = Module.findSymbols(*Block->getAddress());
+    Stats.SymbolsScanned += std::distance(It.begin(), It.end());
+    if (It.empty()) {
+      Stats.SymbolsCreated++;
+    }
+    if (It.empty() && !DryRun) {
       auto* EntryPoint =
           gtirb::Symbol::Create(Context, *Block->getAddress(), "__EntryPoint");
       EntryPoint->setReferent<gtirb::CodeBlock>(Block);
       Module.addSymbol(EntryPoint);
     }
   }
-};
+  return Stats;
+}
 
-void fixupGetPcThunkNames(gtirb::Context& Context, gtirb::Module& Module) {
+FixupPassStats fixupGetPcThunkNames(gtirb::Context& Context,
+                                    gtirb::Module& Module, bool DryRun) {
+  FixupPassStats Stats;
   const std::vector<std::string> ThunkSymbols = {
       "__x86.get_pc_thunk.ax", "__x86.get_pc_thunk.bp", "__x86.get_pc_thunk.bx",
       "__x86.get_pc_thunk.cx", "__x86.get_pc_thunk.di", "__x86.get_pc_thunk.dx",
@@ -273,7 +383,7 @@ void fixupGetPcThunkNames(gtirb::Context& Context, gtirb::Module& Module) {
       Module.getAuxData<gtirb::schema::SymbolForwarding>();
   if (!Forwarding) {
     // Only find forwarded symbols - without the table, none are forwarded.
-    return;
+    return Stats;
   }
 
   int RenamedSymbolCount = 0;
@@ -286,6 +396,7 @@ void fixupGetPcThunkNames(gtirb::Context& Context, gtirb::Module& Module) {
     }
 
     for (gtirb::Symbol* Symbol : CopySymbols) {
+      Stats.SymbolsScanned++;
       auto It = Forwarding->find(Symbol->getUUID());
       if (It == Forwarding->end()) {
         // ddisasm forwards the renamed symbol to a new symbol of the original
@@ -294,6 +405,11 @@ void fixupGetPcThunkNames(gtirb::Context& Context, gtirb::Module& Module) {
         continue;
       }
 
+      RenamedSymbolCount++;
+      if (DryRun) {
+        continue;
+      }
+
       // Delete the synthetic symbol.
       Module.removeSymbol(
           gtirb_pprint::getByUUID<gtirb::Symbol>(Context, It->second));
@@ -303,12 +419,11 @@ void fixupGetPcThunkNames(gtirb::Context& Context, gtirb::Module& Module) {
 
       // Restore the name of the original symbol.
       Symbol->setName(Name);
-
-      RenamedSymbolCount++;
     }
   }
 
-  if (RenamedSymbolCount) {
+  Stats.SymbolsModified = RenamedSymbolCount;
+  if (RenamedSymbolCount && !DryRun) {
     LOG_WARNING << "Removed \"_copy\" suffix from " << std::dec
                 << RenamedSymbolCount << " x86.get_pc_thunk.* symbols.\n"
                 << "\"_copy\" was appended to these symbols in ddisasm 1.8.0 "
@@ -317,6 +432,7 @@ void fixupGetPcThunkNames(gtirb::Context& Context, gtirb::Module& Module) {
                 << "Upgrade to a newer ddisasm and recreate this GTIRB to "
                    "resolve this warning.\n";
   }
+  return Stats;
 }
 
 } // namespace gtirb_pprint
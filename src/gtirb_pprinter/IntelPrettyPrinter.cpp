@@ -86,10 +86,7 @@ void IntelPrettyPrinter::printOpImmediate(
   assert(op.type == X86_OP_IMM &&
          "printOpImmediate called without an immediate operand");
 
-  bool IsNotBranch =
-      !cs_insn_group(this->csHandle, &inst, CS_GRP_CALL) &&
-      !cs_insn_group(this->csHandle, &inst, CS_GRP_JUMP) &&
-      !cs_insn_group(this->csHandle, &inst, CS_GRP_BRANCH_RELATIVE);
+  bool IsNotBranch = !getInsnGroups(inst).referencesCode();
 
   if (const auto* SAA = std::get_if<gtirb::SymAddrAddr>(symbolic)) {
     printSymbolicExpression(os, SAA, false);
@@ -101,7 +98,7 @@ void IntelPrettyPrinter::printOpImmediate(
     PrettyPrinterBase::printSymbolicExpression(os, s, IsNotBranch);
   } else {
     // The operand is just a number.
-    os << op.imm;
+    writeDecimal(os, op.imm);
   }
 }
 
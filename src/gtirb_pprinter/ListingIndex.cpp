@@ -0,0 +1,146 @@
+//===- ListingIndex.cpp -----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "ListingIndex.hpp"
+#include "NumberFormat.hpp"
+#include <algorithm>
+#include <boost/uuid/uuid_io.hpp>
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+namespace gtirb_pprint {
+
+namespace {
+const char* kindName(ListingIndexEntry::Kind Kind) {
+  switch (Kind) {
+  case ListingIndexEntry::Kind::Section:
+    return "section";
+  case ListingIndexEntry::Kind::Function:
+    return "function";
+  case ListingIndexEntry::Kind::Block:
+    return "block";
+  }
+  return "";
+}
+
+std::optional<ListingIndexEntry::Kind> kindFromName(const std::string& Name) {
+  for (auto Kind :
+       {ListingIndexEntry::Kind::Section, ListingIndexEntry::Kind::Function,
+        ListingIndexEntry::Kind::Block}) {
+    if (Name == kindName(Kind))
+      return Kind;
+  }
+  return std::nullopt;
+}
+} // namespace
+
+size_t ListingIndex::add(ListingIndexEntry Entry) {
+  Lookup.Valid = false;
+  Entries.push_back(std::move(Entry));
+  return Entries.size() - 1;
+}
+
+std::vector<const ListingIndexEntry*>
+ListingIndex::find(ListingIndexEntry::Kind Kind, uint64_t Begin,
+                   uint64_t End) const {
+  std::lock_guard<std::mutex> Lock(Lookup.Mutex);
+  if (!Lookup.Valid) {
+    for (size_t K = 0; K < LookupTable::NumKinds; ++K) {
+      Lookup.Sorted[K].clear();
+      Lookup.MaxEnd[K].clear();
+    }
+    for (size_t I = 0; I < Entries.size(); ++I)
+      Lookup.Sorted[size_t(Entries[I].EntryKind)].push_back(I);
+    for (size_t K = 0; K < LookupTable::NumKinds; ++K) {
+      std::vector<size_t>& Sorted = Lookup.Sorted[K];
+      std::stable_sort(Sorted.begin(), Sorted.end(), [&](size_t A, size_t B) {
+        return Entries[A].Begin < Entries[B].Begin;
+      });
+      uint64_t Max = 0;
+      for (size_t I : Sorted) {
+        Max = std::max(Max, Entries[I].End);
+        Lookup.MaxEnd[K].push_back(Max);
+      }
+    }
+    Lookup.Valid = true;
+  }
+
+  // Entries that begin before End, past those that all end by Begin.
+  const std::vector<size_t>& Sorted = Lookup.Sorted[size_t(Kind)];
+  const std::vector<uint64_t>& MaxEnd = Lookup.MaxEnd[size_t(Kind)];
+  size_t Last = std::partition_point(Sorted.begin(), Sorted.end(),
+                                     [&](size_t I) {
+                                       return Entries[I].Begin < End;
+                                     }) -
+                Sorted.begin();
+  size_t First = std::partition_point(MaxEnd.begin(), MaxEnd.begin() + Last,
+                                      [&](uint64_t E) { return E <= Begin; }) -
+                 MaxEnd.begin();
+  std::vector<const ListingIndexEntry*> Found;
+  for (size_t I = First; I < Last; ++I) {
+    const ListingIndexEntry& Entry = Entries[Sorted[I]];
+    if (Begin < Entry.End)
+      Found.push_back(&Entry);
+  }
+  return Found;
+}
+
+void ListingIndex::write(std::ostream& Stream) const {
+  std::string Line;
+  for (const auto& Entry : Entries) {
+    Line = kindName(Entry.EntryKind);
+    Line += ' ';
+    Line += boost::uuids::to_string(Entry.Id);
+    Line += ' ';
+    appendHex(Line, Entry.Begin);
+    Line += ' ';
+    appendHex(Line, Entry.End);
+    Line += ' ';
+    appendDecimal(Line, Entry.Offset);
+    Line += ' ';
+    appendDecimal(Line, Entry.Size);
+    if (!Entry.Name.empty()) {
+      Line += ' ';
+      Line += Entry.Name;
+    }
+    Line += '\n';
+    Stream << Line;
+  }
+}
+
+std::optional<ListingIndex> ListingIndex::read(std::istream& Stream) {
+  ListingIndex Index;
+  std::string Line;
+  while (std::getline(Stream, Line)) {
+    if (Line.empty())
+      continue;
+    std::istringstream Fields(Line);
+    std::string KindName;
+    ListingIndexEntry Entry;
+    Fields >> KindName >> Entry.Id >> std::hex >> Entry.Begin >> Entry.End >>
+        std::dec >> Entry.Offset >> Entry.Size;
+    auto Kind = kindFromName(KindName);
+    if (!Fields || !Kind)
+      return std::nullopt;
+    Entry.EntryKind = *Kind;
+    // Names may contain spaces; take the rest of the line after one.
+    if (Fields.get() == ' ')
+      std::getline(Fields, Entry.Name);
+    Index.add(std::move(Entry));
+  }
+  return Index;
+}
+
+} // namespace gtirb_pprint
@@ -0,0 +1,96 @@
+//===- ListingTokens.cpp ----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "ListingTokens.hpp"
+#include <ostream>
+
+namespace gtirb_pprint {
+
+namespace {
+const char Magic[4] = {'G', 'T', 'L', 'T'};
+
+template <typename T> void appendLE(std::string& Out, T Value) {
+  for (size_t I = 0; I < sizeof(T); ++I)
+    Out.push_back(static_cast<char>((Value >> (8 * I)) & 0xff));
+}
+
+void appendUUID(std::string& Out, const gtirb::UUID& Id) {
+  Out.append(reinterpret_cast<const char*>(Id.data), Id.size());
+}
+
+// Append a record whose payload is Record to Out.
+void appendRecord(std::string& Out, ListingToken Kind,
+                  const std::string& Record) {
+  Out.push_back(static_cast<char>(Kind));
+  Out.append(3, '\0');
+  appendLE<uint32_t>(Out, static_cast<uint32_t>(Record.size()));
+  Out.append(Record);
+  Out.append((8 - Record.size() % 8) % 8, '\0');
+}
+} // namespace
+
+ListingTokenWriter::ListingTokenWriter(std::ostream& S) : Stream(S) {
+  std::string Header(Magic, sizeof(Magic));
+  appendLE<uint32_t>(Header, Version);
+  Stream.write(Header.data(), Header.size());
+}
+
+ListingTokenWriter::~ListingTokenWriter() { flush(); }
+
+void ListingTokenWriter::label(uint64_t EA, const gtirb::UUID& Symbol,
+                               std::string_view Name) {
+  Record.clear();
+  appendLE<uint64_t>(Record, EA);
+  appendUUID(Record, Symbol);
+  Record.append(Name);
+  std::string Out;
+  appendRecord(Out, ListingToken::Label, Record);
+  Stream.write(Out.data(), Out.size());
+}
+
+void ListingTokenWriter::instruction(std::string_view Mnemonic,
+                                     std::string_view Operands) {
+  Record.clear();
+  appendLE<uint32_t>(Record, static_cast<uint32_t>(Mnemonic.size()));
+  Record.append(Mnemonic);
+  Record.append(Operands);
+  appendRecord(Pending, ListingToken::Instruction, Record);
+}
+
+void ListingTokenWriter::symbolReference(const gtirb::UUID& Symbol) {
+  Record.clear();
+  appendUUID(Record, Symbol);
+  appendRecord(Pending, ListingToken::SymbolRef, Record);
+}
+
+void ListingTokenWriter::line(uint64_t EA, const gtirb::UUID& Block,
+                              std::string_view Text) {
+  Record.clear();
+  appendLE<uint64_t>(Record, EA);
+  appendUUID(Record, Block);
+  Record.append(Text);
+  std::string Out;
+  appendRecord(Out, ListingToken::Line, Record);
+  Out.append(Pending);
+  Pending.clear();
+  Stream.write(Out.data(), Out.size());
+}
+
+void ListingTokenWriter::flush() {
+  Stream.write(Pending.data(), Pending.size());
+  Pending.clear();
+  Stream.flush();
+}
+
+} // namespace gtirb_pprint
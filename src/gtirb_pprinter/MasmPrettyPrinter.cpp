@@ -20,7 +20,7 @@
 #include "FileUtils.hpp"
 #include "StringUtils.hpp"
 #include "regex"
-#include <boost/algorithm/string/replace.hpp>
+#include <algorithm>
 
 namespace gtirb_pprint {
 
@@ -88,6 +88,18 @@ std::string MasmSyntax::formatSymbolName(const std::string& x) const {
   return name;
 }
 
+void MasmSyntax::escapeString(std::string& Buf, std::string_view Bytes) const {
+  // MASM strings are quoted with ' and the only escape is a doubled quote.
+  for (size_t Pos = 0;;) {
+    size_t Quote = Bytes.find('\'', Pos);
+    Buf.append(Bytes.substr(Pos, Quote - Pos));
+    if (Quote == std::string_view::npos)
+      break;
+    Buf += "''";
+    Pos = Quote + 1;
+  }
+}
+
 MasmPrettyPrinter::MasmPrettyPrinter(gtirb::Context& context_,
                                      const gtirb::Module& module_,
                                      const MasmSyntax& syntax_,
@@ -171,17 +183,13 @@ MasmPrettyPrinter::getSymbolName(const gtirb::Symbol& Symbol) const {
 void MasmPrettyPrinter::printExterns(std::ostream& os) {
   // Declare EXTERN symbols
   std::set<std::string> Externs;
-  auto Forwarding = aux_data::getSymbolForwarding(module);
+  const auto& Forwarding = symbolForwarding();
   if (Forwarding.empty()) {
     return;
   }
 
-  for (auto& Forward : Forwarding) {
-    if (const auto* Symbol = gtirb::dyn_cast_or_null<gtirb::Symbol>(
-            gtirb::Node::getByUUID(context, Forward.second))) {
-      std::string Name = getSymbolName(*Symbol);
-      Externs.insert(Name);
-    }
+  for (const auto& Forward : Forwarding.entries()) {
+    Externs.insert(getSymbolName(*Forward.second));
   }
 
   for (auto& Name : Externs) {
@@ -525,7 +533,7 @@ std::string MasmPrettyPrinter::getRegisterName(unsigned int Reg) const {
 
 void MasmPrettyPrinter::printSymbolDefinition(std::ostream& Stream,
                                               const gtirb::Symbol& Symbol) {
-  std::string Name = getSymbolName(Symbol);
+  std::string_view Name = getSymbolSpelling(Symbol);
   // In MASM procedures can be exported by declaring "PROC EXPORT"
   // Non-procedures (data) need to be declared "PUBLIC" AND
   // be specified in the .def file.
@@ -539,7 +547,7 @@ void MasmPrettyPrinter::printSymbolDefinition(std::ostream& Stream,
     const gtirb::CodeBlock* Block = Symbol.getReferent<gtirb::CodeBlock>();
     bool SafeSeh = aux_data::getPeSafeExceptionHandlers(module).count(
                        Block->getUUID()) > 0;
-    bool FunctionSymbol = FunctionSymbols.count(&Symbol) > 0;
+    bool FunctionSymbol = functions().FunctionSymbols.count(&Symbol) > 0;
     if (FunctionSymbol) {
       Stream << Name << ' ' << masmSyntax.proc();
       if (Exported) {
@@ -561,14 +569,15 @@ void MasmPrettyPrinter::printSymbolDefinition(std::ostream& Stream,
 
 void MasmPrettyPrinter::printFunctionEnd(std::ostream& OS,
                                          const gtirb::Symbol& FunctionSymbol) {
-  OS << getSymbolName(FunctionSymbol) << ' ' << masmSyntax.endp() << '\n';
+  OS << getSymbolSpelling(FunctionSymbol) << ' ' << masmSyntax.endp()
+     << '\n';
 }
 
 void MasmPrettyPrinter::printSymbolDefinitionRelativeToPC(
     std::ostream& os, const gtirb::Symbol& symbol, gtirb::Addr pc) {
   auto symAddr = *symbol.getAddress();
 
-  os << getSymbolName(symbol) << " = " << syntax.programCounter();
+  os << getSymbolSpelling(symbol) << " = " << syntax.programCounter();
   if (symAddr > pc) {
     os << " + " << (symAddr - pc);
   } else if (symAddr < pc) {
@@ -582,8 +591,9 @@ void MasmPrettyPrinter::printIntegralSymbol(std::ostream& os,
   if (*symbol.getAddress() == gtirb::Addr(0)) {
     return;
   }
-  os << getSymbolName(symbol) << " = " << std::hex
-     << static_cast<uint64_t>(*symbol.getAddress()) << "H\n";
+  os << getSymbolSpelling(symbol) << " = ";
+  writeHex(os, static_cast<uint64_t>(*symbol.getAddress()), syntax.hexFormat());
+  os << '\n';
 }
 
 void MasmPrettyPrinter::printOpRegdirect(std::ostream& os, const cs_insn& inst,
@@ -603,8 +613,9 @@ void MasmPrettyPrinter::printOpImmediate(
   assert(op.type == X86_OP_IMM &&
          "printOpImmediate called without an immediate operand");
 
-  bool is_call = cs_insn_group(this->csHandle, &inst, CS_GRP_CALL);
-  bool is_jump = cs_insn_group(this->csHandle, &inst, CS_GRP_JUMP);
+  const InsnGroups& Groups = getInsnGroups(inst);
+  bool is_call = Groups.isCall();
+  bool is_jump = Groups.isJump();
 
   if (const gtirb::SymAddrConst* s = this->getSymbolicImmediate(symbolic)) {
     // The operand is symbolic.
@@ -637,7 +648,7 @@ void MasmPrettyPrinter::printOpImmediate(
     printSymbolicExpression(os, s, !is_call && !is_jump);
   } else {
     // The operand is just a number.
-    os << op.imm;
+    writeDecimal(os, op.imm);
   }
 }
 
@@ -732,8 +743,8 @@ void MasmPrettyPrinter::printOpIndirect(
     printSymbolicExpression(os, s, false);
   } else if (const auto* rel = std::get_if<gtirb::SymAddrAddr>(symbolic)) {
     if (std::optional<gtirb::Addr> Addr = rel->Sym1->getAddress(); Addr) {
-      os << "+(" << masmSyntax.imagerel() << ' ' << getSymbolName(*rel->Sym1)
-         << ")";
+      os << "+(" << masmSyntax.imagerel() << ' '
+         << getSymbolSpelling(*rel->Sym1) << ")";
       printAddend(os, rel->Offset, false);
     }
   } else {
@@ -760,22 +771,27 @@ void MasmPrettyPrinter::printSymbolicExpression(std::ostream& os,
 }
 
 void MasmPrettyPrinter::printByte(std::ostream& os, std::byte byte) {
-  // Byte constants must start with a number for the MASM assembler.
-  os << syntax.byteData() << " 0" << std::hex << std::setfill('0')
-     << std::setw(2) << static_cast<uint32_t>(byte) << 'H' << std::dec;
+  os << syntax.byteData() << ' ';
+  writeHex(os, static_cast<uint64_t>(byte), syntax.hexFormat(), 2);
 }
 
 void MasmPrettyPrinter::printZeroDataBlock(std::ostream& os,
                                            const gtirb::DataBlock& dataObject,
                                            uint64_t offset) {
   os << syntax.tab();
-  os << "DB " << (dataObject.getSize() - offset) << " DUP(0)" << '\n';
+  printZeros(os, dataObject.getSize() - offset);
+  os << '\n';
+}
+
+void MasmPrettyPrinter::printZeros(std::ostream& os, uint64_t Count) {
+  os << "DB " << Count << " DUP(0)";
 }
 
 bool MasmPrettyPrinter::printSymbolReference(std::ostream& Stream,
                                              const gtirb::Symbol* Symbol) {
   if (Symbol && Symbol->getReferent<gtirb::DataBlock>()) {
     if (std::optional<std::string> Name = getForwardedSymbolName(Symbol)) {
+      recordSymbolReference(*Symbol);
       Stream << "__imp_" << *Name;
       return true;
     }
@@ -787,40 +803,43 @@ bool MasmPrettyPrinter::printSymbolReference(std::ostream& Stream,
 void MasmPrettyPrinter::printString(std::ostream& Stream,
                                     const gtirb::DataBlock& Block,
                                     uint64_t Offset, bool NullTerminated) {
-  std::string Chunk{""};
-
   auto Bytes = Block.bytes<uint8_t>();
-  auto It = boost::make_iterator_range(Bytes.begin() + Offset, Bytes.end());
-  for (uint8_t Byte : It) {
+  const char* It = Block.rawBytes<char>() + Offset;
+  const char* End = It + (std::distance(Bytes.begin(), Bytes.end()) - Offset);
+
+  std::string Chunk;
+  auto PrintChunk = [&](const char* First, const char* Last) {
+    Chunk.clear();
+    masmSyntax.escapeString(Chunk, std::string_view(First, Last - First));
+    Stream << syntax.tab() << syntax.string() << " '" << Chunk << "'\n";
+  };
+  auto IsPrint = [](char C) {
+    return std::isprint(static_cast<unsigned char>(C)) != 0;
+  };
+
+  while (It != End) {
+    // Aggegrate printable characters
+    const char* RunEnd = std::find_if_not(It, End, IsPrint);
+
     // NOTE: MASM only supports strings smaller than 256 bytes.
     //  and  MASM only supports statements with 50 comma-separated items.
-    if (Chunk.size() >= 64) {
-      boost::replace_all(Chunk, "'", "''");
-      Stream << syntax.tab() << syntax.string() << " '" << Chunk << "'\n";
-      Chunk.clear();
+    static constexpr ptrdiff_t MaxChunk = 64;
+    for (; RunEnd - It > MaxChunk; It += MaxChunk) {
+      PrintChunk(It, It + MaxChunk);
     }
-
-    // Aggegrate printable characters
-    if (std::isprint(Byte)) {
-      Chunk.append(1, Byte);
-      continue;
+    if (It != RunEnd && (RunEnd != End || !NullTerminated)) {
+      PrintChunk(It, RunEnd);
     }
-
-    // Found non-printable character, output previous chunk and print byte
-    if (!Chunk.empty()) {
-      boost::replace_all(Chunk, "'", "''");
-      Stream << syntax.tab() << syntax.string() << " '" << Chunk << "'\n";
-      Chunk.clear();
+    It = RunEnd;
+    if (It == End) {
+      break;
     }
+
+    // Found non-printable character, print byte
     Stream << syntax.tab();
-    printByte(Stream, static_cast<std::byte>(Byte));
+    printByte(Stream, static_cast<std::byte>(*It++));
     Stream << "\n";
   }
-  if (!NullTerminated && !Chunk.empty()) {
-    boost::replace_all(Chunk, "'", "''");
-    Stream << syntax.tab() << syntax.string() << " '" << Chunk << "'\n";
-    Chunk.clear();
-  }
 }
 
 void MasmPrettyPrinter::printFooter(std::ostream& os) {
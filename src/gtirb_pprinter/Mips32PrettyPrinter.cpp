@@ -82,7 +82,7 @@ Mips32PrettyPrinter::Mips32PrettyPrinter(gtirb::Context& context_,
 
 void Mips32PrettyPrinter::printHeader(std::ostream& os) {
   // we already account for delay slots; don't let the assembler insert them
-  os << ".set noreorder" << std::endl;
+  os << ".set noreorder\n";
 }
 
 // Workaround for correct printing of the following instructions:
@@ -140,7 +140,7 @@ void Mips32PrettyPrinter::printOpImmediate(
     }
   } else {
     const cs_mips_op& op = inst.detail->mips.operands[index];
-    os << op.imm;
+    writeDecimal(os, op.imm);
   }
 }
 
@@ -158,7 +158,7 @@ void Mips32PrettyPrinter::printOpIndirect(
       assert(!"Unknown sym expr type in printOpImmediate!");
     }
   } else {
-    os << op.mem.disp;
+    writeDecimal(os, op.mem.disp);
   }
 
   os << '(' << getRegisterName(op.mem.base) << ')';
@@ -207,7 +207,9 @@ void Mips32PrettyPrinter::printInstruction(std::ostream& os,
   InstructLine << "  " << inst.mnemonic << ' ';
   // Make sure the initial m_accum_comment is empty.
   m_accum_comment.clear();
+  std::streampos OperandsStart = InstructLine.tellp();
   printOperandList(InstructLine, block, inst);
+  recordInstructionTokens(inst.mnemonic, InstructLine, OperandsStart);
   if (!m_accum_comment.empty()) {
     InstructLine << " " << syntax.comment() << " " << m_accum_comment;
     m_accum_comment.clear();
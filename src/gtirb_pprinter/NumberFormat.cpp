@@ -0,0 +1,63 @@
+//===- NumberFormat.cpp -----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "NumberFormat.hpp"
+#include <algorithm>
+
+namespace gtirb_pprint {
+
+namespace {
+// Large enough for any 64-bit value in base 16.
+constexpr size_t MaxDigits = 16;
+
+// Format Value into [Begin, End), right-aligned at End, and return the first
+// character written.
+char* formatHexDigits(char* Begin, char* End, uint64_t Value, bool UpperCase,
+                      unsigned MinDigits) {
+  auto Result = std::to_chars(Begin, End, Value, 16);
+  char* First = std::copy_backward(Begin, Result.ptr, End);
+  if (UpperCase)
+    std::transform(First, End, First, [](char C) {
+      return (C >= 'a' && C <= 'f') ? static_cast<char>(C - 'a' + 'A') : C;
+    });
+  char* Padded = End - std::min<ptrdiff_t>(MinDigits, End - Begin);
+  if (Padded < First) {
+    std::fill(Padded, First, '0');
+    First = Padded;
+  }
+  return First;
+}
+} // namespace
+
+void appendHex(std::string& Buf, uint64_t Value, const HexFormat& Format,
+               unsigned MinDigits) {
+  char Digits[MaxDigits];
+  char* First = formatHexDigits(std::begin(Digits), std::end(Digits), Value,
+                                Format.UpperCase, MinDigits);
+  Buf.append(Format.Prefix);
+  Buf.append(First, std::end(Digits));
+  Buf.append(Format.Suffix);
+}
+
+void writeHex(std::ostream& Stream, uint64_t Value, const HexFormat& Format,
+              unsigned MinDigits) {
+  char Digits[MaxDigits];
+  char* First = formatHexDigits(std::begin(Digits), std::end(Digits), Value,
+                                Format.UpperCase, MinDigits);
+  Stream.write(Format.Prefix.data(), Format.Prefix.size());
+  Stream.write(First, std::end(Digits) - First);
+  Stream.write(Format.Suffix.data(), Format.Suffix.size());
+}
+
+} // namespace gtirb_pprint
@@ -0,0 +1,135 @@
+//===- ObjectCache.cpp ------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "ObjectCache.hpp"
+#include "Sha256.hpp"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <boost/version.hpp>
+#include <ctime>
+#include <fstream>
+#include <tuple>
+
+namespace fs = boost::filesystem;
+
+namespace gtirb_bprint {
+
+ObjectCache::ObjectCache(std::string D, uint64_t Max)
+    : Dir(std::move(D)), MaxSize(Max) {}
+
+std::optional<std::string>
+ObjectCache::key(const std::string& Source, const std::string& Tool,
+                 const std::vector<std::string>& Args) {
+  std::ifstream Stream(Source, std::ios::binary);
+  if (!Stream) {
+    return std::nullopt;
+  }
+  // Strings are hashed with their terminating null, so that the boundaries
+  // between the tool and its arguments are part of the key.
+  gtirb_pprint::Sha256 Hash;
+  Hash.update(Tool.c_str(), Tool.size() + 1);
+  for (const std::string& Arg : Args) {
+    Hash.update(Arg.c_str(), Arg.size() + 1);
+  }
+  std::vector<char> Buffer(1 << 20);
+  while (Stream) {
+    Stream.read(Buffer.data(), Buffer.size());
+    Hash.update(Buffer.data(), static_cast<size_t>(Stream.gcount()));
+  }
+  if (Stream.bad()) {
+    return std::nullopt;
+  }
+  return Hash.hexDigest();
+}
+
+std::string ObjectCache::objectPath(const std::string& Key) const {
+  // Spread the objects over subdirectories named by the first two digits.
+  fs::path Path(Dir);
+  Path /= Key.substr(0, 2);
+  Path /= Key.substr(2) + ".o";
+  return Path.string();
+}
+
+bool ObjectCache::fetch(const std::string& Key, const std::string& Path) {
+  boost::system::error_code Ec;
+  fs::path Object(objectPath(Key));
+  if (!fs::is_regular_file(Object, Ec)) {
+    ++Misses;
+    return false;
+  }
+#if BOOST_VERSION >= 107400
+  fs::copy_file(Object, Path, fs::copy_options::overwrite_existing, Ec);
+#else
+  fs::copy_file(Object, Path, fs::copy_option::overwrite_if_exists, Ec);
+#endif
+  if (Ec) {
+    ++Misses;
+    return false;
+  }
+  // The modification time orders the objects for eviction.
+  fs::last_write_time(Object, std::time(nullptr), Ec);
+  ++Hits;
+  return true;
+}
+
+bool ObjectCache::store(const std::string& Key, const std::string& Path) {
+  boost::system::error_code Ec;
+  fs::path Object(objectPath(Key));
+  fs::create_directories(Object.parent_path(), Ec);
+  // Copy under a unique name and rename, so that concurrent printers never
+  // see a partially written object.
+  fs::path Partial = Object.parent_path() / fs::unique_path("%%%%%%%%.tmp");
+  fs::copy_file(Path, Partial, Ec);
+  if (!Ec) {
+    fs::rename(Partial, Object, Ec);
+  }
+  if (Ec) {
+    fs::remove(Partial, Ec);
+    return false;
+  }
+  trim();
+  return true;
+}
+
+void ObjectCache::trim() {
+  if (MaxSize == 0) {
+    return;
+  }
+  boost::system::error_code Ec;
+  std::vector<std::tuple<std::time_t, uint64_t, fs::path>> Objects;
+  uint64_t Total = 0;
+  for (fs::recursive_directory_iterator It(Dir, Ec), End; !Ec && It != End;
+       It.increment(Ec)) {
+    if (It->path().extension() != ".o" || !fs::is_regular_file(It->path()))
+      continue;
+    uint64_t Size = fs::file_size(It->path(), Ec);
+    std::time_t Time = fs::last_write_time(It->path(), Ec);
+    if (!Ec) {
+      Objects.emplace_back(Time, Size, It->path());
+      Total += Size;
+    }
+  }
+  std::sort(Objects.begin(), Objects.end());
+  for (const auto& [Time, Size, Object] : Objects) {
+    if (Total <= MaxSize) {
+      break;
+    }
+    if (fs::remove(Object, Ec)) {
+      Total -= Size;
+    }
+  }
+}
+
+} // namespace gtirb_bprint
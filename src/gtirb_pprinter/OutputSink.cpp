@@ -0,0 +1,193 @@
+//===- OutputSink.cpp -------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "OutputSink.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#if defined(_WIN32)
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace gtirb_pprint {
+
+namespace {
+#if defined(_WIN32)
+int openFile(const std::string& Path) {
+  int FD = -1;
+  _sopen_s(&FD, Path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+           _SH_DENYNO, _S_IREAD | _S_IWRITE);
+  return FD;
+}
+
+bool writeAll(int FD, const char* Data, std::size_t Size) {
+  while (Size > 0) {
+    unsigned Chunk = Size > (1u << 30) ? (1u << 30) : unsigned(Size);
+    int Written = _write(FD, Data, Chunk);
+    if (Written <= 0)
+      return false;
+    Data += Written;
+    Size -= Written;
+  }
+  return true;
+}
+
+bool writeAll(int FD, const char* First, std::size_t FirstSize,
+              const char* Second, std::size_t SecondSize) {
+  return writeAll(FD, First, FirstSize) && writeAll(FD, Second, SecondSize);
+}
+
+int closeFile(int FD) { return _close(FD); }
+#else
+int openFile(const std::string& Path) {
+  int FD;
+  do {
+    FD = ::open(Path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+  } while (FD < 0 && errno == EINTR);
+  return FD;
+}
+
+bool writeAll(int FD, const char* First, std::size_t FirstSize,
+              const char* Second, std::size_t SecondSize) {
+  iovec Parts[2] = {{const_cast<char*>(First), FirstSize},
+                    {const_cast<char*>(Second), SecondSize}};
+  iovec* Next = Parts;
+  int Count = 2;
+  while (Count > 0) {
+    if (Next->iov_len == 0) {
+      ++Next;
+      --Count;
+      continue;
+    }
+    ssize_t Written = ::writev(FD, Next, Count);
+    if (Written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    // Skip the fully written parts and advance into a partial one.
+    size_t Remaining = static_cast<size_t>(Written);
+    while (Count > 0 && Remaining >= Next->iov_len) {
+      Remaining -= Next->iov_len;
+      ++Next;
+      --Count;
+    }
+    if (Count > 0) {
+      Next->iov_base = static_cast<char*>(Next->iov_base) + Remaining;
+      Next->iov_len -= Remaining;
+    }
+  }
+  return true;
+}
+
+int closeFile(int FD) { return ::close(FD); }
+#endif
+} // namespace
+
+OutputSink::OutputSink(std::size_t BufferSize)
+    : Buffer(BufferSize > 0 ? BufferSize : 1) {
+  setp(Buffer.data(), Buffer.data() + Buffer.size());
+}
+
+OutputSink::~OutputSink() { close(); }
+
+bool OutputSink::open(const std::string& Path) {
+  close();
+  FD = openFile(Path);
+  Failed = FD < 0;
+  Drained = 0;
+  setp(Buffer.data(), Buffer.data() + Buffer.size());
+  return !Failed;
+}
+
+bool OutputSink::close() {
+  if (FD < 0)
+    return false;
+  bool Ok = drain(nullptr, 0);
+  Ok = closeFile(FD) == 0 && Ok;
+  FD = -1;
+  return Ok && !Failed;
+}
+
+bool OutputSink::drain(const char* Data, std::size_t Size) {
+  std::size_t Pending = pptr() - pbase();
+  if (FD < 0 || Failed ||
+      !writeAll(FD, pbase(), Pending, Data, Data ? Size : 0)) {
+    Failed = true;
+  }
+  Drained += Pending + (Data ? Size : 0);
+  setp(Buffer.data(), Buffer.data() + Buffer.size());
+  return !Failed;
+}
+
+OutputSink::int_type OutputSink::overflow(int_type C) {
+  if (!drain(nullptr, 0))
+    return traits_type::eof();
+  if (!traits_type::eq_int_type(C, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(C);
+    pbump(1);
+  }
+  return traits_type::not_eof(C);
+}
+
+std::streamsize OutputSink::xsputn(const char* Data, std::streamsize Size) {
+  if (Size <= epptr() - pptr()) {
+    traits_type::copy(pptr(), Data, static_cast<std::size_t>(Size));
+    pbump(static_cast<int>(Size));
+    return Size;
+  }
+  return drain(Data, static_cast<std::size_t>(Size)) ? Size : 0;
+}
+
+int OutputSink::sync() { return drain(nullptr, 0) ? 0 : -1; }
+
+OutputSink::pos_type OutputSink::seekoff(off_type Off,
+                                         std::ios_base::seekdir Dir,
+                                         std::ios_base::openmode Which) {
+  // Only the current position can be queried.
+  if (Off != 0 || Dir != std::ios_base::cur || !(Which & std::ios_base::out) ||
+      FD < 0 || Failed) {
+    return pos_type(off_type(-1));
+  }
+  return pos_type(off_type(Drained + (pptr() - pbase())));
+}
+
+OutputSinkStream::OutputSinkStream(std::size_t BufferSize)
+    : std::ostream(nullptr), Sink(BufferSize) {
+  rdbuf(&Sink);
+}
+
+OutputSinkStream::OutputSinkStream(const std::string& Path,
+                                   std::size_t BufferSize)
+    : OutputSinkStream(BufferSize) {
+  open(Path);
+}
+
+void OutputSinkStream::open(const std::string& Path) {
+  if (Sink.open(Path))
+    clear();
+  else
+    setstate(std::ios_base::failbit);
+}
+
+void OutputSinkStream::close() {
+  if (!Sink.close())
+    setstate(std::ios_base::failbit);
+}
+
+} // namespace gtirb_pprint
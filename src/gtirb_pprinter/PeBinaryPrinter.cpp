@@ -633,6 +633,7 @@ int PeBinaryPrinter::assemble(const std::string& Path, gtirb::Context& Context,
   std::optional<std::string> Machine = getPeMachine(Module);
   TempFile tempOutput(".bin");
   tempOutput.close();
+  gtirb_pprint::Statistics::Timer Timer(Printer.getStatistics(), "assemble");
   auto retc = executeCommands(
       assembleCommands({Asm.fileName(), tempOutput.fileName(), Machine,
                         ExtraCompileArgs, LibraryPaths}));
@@ -722,6 +723,7 @@ int PeBinaryPrinter::link(const std::string& OutputFile,
        Subsystem, Machine, Dll, ExtraCompileArgs, LibraryPaths});
   appendCommands(Commands, LinkCommands);
   // Execute the assemble-link command list.
+  gtirb_pprint::Statistics::Timer Timer(Printer.getStatistics(), "link");
   auto retc = executeCommands(Commands);
   if (retc == 0) {
     copyFile(tempOutput.fileName(), OutputFile);
@@ -752,6 +754,7 @@ int PeBinaryPrinter::libs(const gtirb::Module& Module) const {
     appendCommands(Commands, LibCommands);
   }
 
+  gtirb_pprint::Statistics::Timer Timer(Printer.getStatistics(), "libs");
   return executeCommands(Commands);
 }
 
@@ -17,15 +17,23 @@
 #include "driver/Logger.h"
 
 #include "AuxDataSchema.hpp"
+#include "ElfVersionScriptPrinter.hpp"
 #include "StringUtils.hpp"
+#include "X86InstructionTable.hpp"
 #include <boost/lexical_cast.hpp>
 #include <boost/range/algorithm/find_if.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <capstone/capstone.h>
+#include <cstring>
 #include <fstream>
 #include <gtirb/gtirb.hpp>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <numeric>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <variant>
 
@@ -250,27 +258,91 @@ PrettyPrinter::getPolicy(const gtirb::Module& Module) const {
 
 int PrettyPrinter::print(std::ostream& Stream, gtirb::Context& Context,
                          const gtirb::Module& Module) const {
-  // Find pretty printer factory.
-  PrettyPrinterFactory& Factory = getFactory(Module);
-
-  // Configure printing policy.
-  PrintingPolicy policy(getPolicy(Module));
-  policy.LstMode = LstMode;
-  policy.IgnoreSymbolVersions = IgnoreSymbolVersions;
-  FunctionPolicy.apply(policy.skipFunctions);
-  SymbolPolicy.apply(policy.skipSymbols);
-  SectionPolicy.apply(policy.skipSections);
-  ArraySectionPolicy.apply(policy.arraySections);
-
   // Create the pretty printer and print the IR.
-  if (aux_data::validateAuxData(Module, m_format)) {
-    if (Factory.create(Context, Module, policy)->print(Stream)) {
+  if (auto Printer = createPrinter(Context, Module)) {
+    if (Printer->print(Stream)) {
+      return 0;
+    }
+  }
+  return -1;
+}
+
+int PrettyPrinter::print(std::ostream& Stream, ListingTokenWriter& Tokens,
+                         gtirb::Context& Context,
+                         const gtirb::Module& Module) const {
+  if (auto Printer = createPrinter(Context, Module)) {
+    Printer->setListingTokens(&Tokens);
+    if (Printer->print(Stream)) {
+      Tokens.flush();
       return 0;
     }
   }
   return -1;
 }
 
+int PrettyPrinter::print(const std::vector<PrintTarget>& Targets,
+                         gtirb::Context& Context,
+                         const gtirb::Module& Module) const {
+  std::string Format =
+      m_format.empty() ? getModuleFileFormat(Module) : m_format;
+  std::string Isa = m_isa.empty() ? getModuleISA(Module) : m_isa;
+
+  std::vector<std::unique_ptr<PrettyPrinterBase>> Printers;
+  std::vector<PrettyPrinterBase::Output> Outputs;
+  // Targets with the same syntax configure Capstone the same way.
+  std::map<std::string, DecodeCache> Caches;
+  // Resolve the symbol forwarding once; the copies made for each target
+  // share it.
+  getSymbolForwarding(Context, Module);
+  for (const PrintTarget& T : Targets) {
+    auto Target = std::make_tuple(Format, Isa, T.Syntax);
+    if (!T.Stream || getFactories().count(Target) == 0) {
+      return -1;
+    }
+    PrettyPrinter TargetPrinter(*this);
+    TargetPrinter.setTarget(Target);
+    if (!TargetPrinter.setListingMode(T.ListingMode) ||
+        (PolicyName != "default" &&
+         !TargetPrinter.namedPolicyExists(PolicyName))) {
+      return -1;
+    }
+    auto Printer = TargetPrinter.createPrinter(Context, Module);
+    if (!Printer) {
+      return -1;
+    }
+    Printer->setDecodeCache(&Caches[T.Syntax]);
+    Outputs.emplace_back(Printer.get(), T.Stream);
+    Printers.push_back(std::move(Printer));
+  }
+  PrettyPrinterBase::printTogether(Outputs);
+  return 0;
+}
+
+std::unique_ptr<PrettyPrinterBase>
+PrettyPrinter::createPrinter(gtirb::Context& Context,
+                             const gtirb::Module& Module) const {
+  PrettyPrinterFactory& Factory = getFactory(Module);
+  if (!aux_data::validateAuxData(Module, m_format)) {
+    return nullptr;
+  }
+  auto Printer = Factory.create(Context, Module, getEffectivePolicy(Module));
+  Printer->setStatistics(Stats);
+  Printer->setSymbolForwarding(getSymbolForwarding(Context, Module));
+  return Printer;
+}
+
+PrintingPolicy
+PrettyPrinter::getEffectivePolicy(const gtirb::Module& Module) const {
+  PrintingPolicy Policy(getPolicy(Module));
+  Policy.LstMode = LstMode;
+  Policy.IgnoreSymbolVersions = IgnoreSymbolVersions;
+  FunctionPolicy.apply(Policy.skipFunctions);
+  SymbolPolicy.apply(Policy.skipSymbols);
+  SectionPolicy.apply(Policy.skipSections);
+  ArraySectionPolicy.apply(Policy.arraySections);
+  return Policy;
+}
+
 boost::iterator_range<NamedPolicyMap::const_iterator>
 PrettyPrinterFactory::namedPolicies() const {
   return boost::make_iterator_range(NamedPolicies.begin(), NamedPolicies.end());
@@ -313,22 +385,39 @@ PrettyPrinterBase::PrettyPrinterBase(gtirb::Context& context_,
                                      const PrintingPolicy& policy_)
     : syntax(syntax_), policy(policy_), LstMode(policy.LstMode),
       context(context_), module(module_),
-      PreferredEOLCommentPos(64), type_printer{module_, context_} {
-  computeFunctionInformation();
-}
+      PreferredEOLCommentPos(64), type_printer{module_, context_} {}
 
 PrettyPrinterBase::~PrettyPrinterBase() { cs_close(&this->csHandle); }
 
 __END_DEPRECATED_DECL__()
 
-void PrettyPrinterBase::computeFunctionInformation() {
+const FunctionInformation& PrettyPrinterBase::functions() const {
+  if (!Functions) {
+    auto Info = std::make_shared<FunctionInformation>();
+    computeFunctionInformation(*Info);
+    computeFunctionAliases(*Info);
+    Functions = std::move(Info);
+  }
+  return *Functions;
+}
+
+std::shared_ptr<const FunctionInformation>
+PrettyPrinterBase::functionInformation() const {
+  functions();
+  return Functions;
+}
+
+void PrettyPrinterBase::computeFunctionAliases(FunctionInformation&) const {}
+
+void PrettyPrinterBase::computeFunctionInformation(
+    FunctionInformation& Info) const {
   auto FunctionNameMap = aux_data::getFunctionNames(module);
   // Compute function names
   for (const auto& Pair : FunctionNameMap) {
     const auto* Symbol = nodeFromUUID<gtirb::Symbol>(context, Pair.second);
     if (Symbol) {
-      FunctionSymbols.insert(Symbol);
-      FunctionToSymbols[Pair.first] = Symbol;
+      Info.FunctionSymbols.insert(Symbol);
+      Info.FunctionToSymbols[Pair.first] = Symbol;
     } else {
       LOG_ERROR << "Value entry UUID " << boost::uuids::to_string(Pair.second)
                 << " in the functionNames Auxdata is not a valid symbol\n";
@@ -361,11 +450,10 @@ void PrettyPrinterBase::computeFunctionInformation() {
     if (Function.second.size() == 0) {
       continue;
     }
-    gtirb::Addr FirstAddr{std::numeric_limits<uint64_t>::max()}, LastBlockAddr,
-        LastAddr{0};
+    gtirb::Addr FirstAddr{std::numeric_limits<uint64_t>::max()}, LastAddr{0};
     gtirb::UUID FirstBlock, LastBlock;
     for (auto& BlockUuid : Function.second) {
-      BlockToFunction[BlockUuid] = Function.first;
+      Info.BlockToFunction[BlockUuid] = Function.first;
       auto BlockRange = getUUIDAddrRange(BlockUuid);
       if (!BlockRange) {
         LOG_WARNING << "UUID " << boost::uuids::to_string(BlockUuid)
@@ -380,66 +468,118 @@ void PrettyPrinterBase::computeFunctionInformation() {
       }
       if (End > LastAddr) {
         LastAddr = End;
-        LastBlockAddr = Beg;
         LastBlock = BlockUuid;
       }
     }
-    FunctionFirstBlocks.insert(FirstBlock);
-    FunctionLastBlocks.insert(LastBlock);
-
-    __BEGIN_DEPRECATED_DECL__()
-    // These are deprecated
-    functionEntry.insert(FirstAddr);
-    functionLastBlock.insert(LastBlockAddr);
-
-    __END_DEPRECATED_DECL__()
+    Info.FunctionFirstBlocks.insert(FirstBlock);
+    Info.FunctionLastBlocks.insert(LastBlock);
   }
 }
 
 void PrettyPrinterBase::computeAmbiguousSymbols() {
   // Collect all ambiguous symbols in the module and give them
   // unique names
-  std::map<const std::string, std::multimap<gtirb::Addr, const gtirb::Symbol*>>
-      SymbolsByNameAddr;
+  AmbiguousSymbols.clear();
+  // Spellings depend on the renamings computed here.
+  SymbolSpellings.clear();
+  using NameGroup = std::vector<std::pair<gtirb::Addr, const gtirb::Symbol*>>;
+  // Keys view the names owned by the symbols; the key set doubles as the set
+  // of names that are already taken in the module.
+  std::unordered_map<std::string_view, NameGroup> SymbolsByName;
   for (auto& S : module.symbols()) {
     auto Addr = S.getAddress().value_or(gtirb::Addr(0));
-    SymbolsByNameAddr[S.getName()].emplace(Addr, &S);
+    SymbolsByName[S.getName()].emplace_back(Addr, &S);
   }
-  for (auto& [Name, Group] : SymbolsByNameAddr) {
+
+  struct AmbiguousGroup {
+    std::string_view Name;
+    NameGroup* Symbols;
+    const gtirb::Symbol* SymbolToKeepOrigName;
+    std::vector<std::pair<const gtirb::Symbol*, std::string>> NewNames;
+  };
+  std::vector<AmbiguousGroup> Groups;
+  for (auto& [Name, Group] : SymbolsByName) {
     if (Group.size() > 1) {
+      // Names are assigned in address order; symbols at the same address
+      // keep the order in which the module lists them.
+      std::stable_sort(Group.begin(), Group.end(),
+                       [](const auto& A, const auto& B) {
+                         return A.first < B.first;
+                       });
       std::set<const gtirb::Symbol*, CmpSymPtr> Symbols;
       for (auto& [Addr, Sym] : Group) {
         Symbols.insert(Sym);
       }
-      const gtirb::Symbol* SymbolToKeepOrigName = getBestSymbol(Symbols);
-      int Index = 0;
-      gtirb::Addr PrevAddress{0};
-      for (auto& [Addr, Sym] : Group) {
-        if (Sym == SymbolToKeepOrigName) {
-          continue;
-        }
-        std::stringstream NewName;
-        NewName << Name << "_disambig_" << Addr;
-        if (Addr != PrevAddress) {
-          Index = 0;
-          PrevAddress = Addr;
-        }
-        std::stringstream Suffix;
-        Suffix << "_" << Index++;
-        while (!module.findSymbols(NewName.str() + Suffix.str()).empty()) {
-          Suffix.seekp(0);
-          Suffix << "_" << Index++;
-        }
-        NewName << Suffix.str();
-        AmbiguousSymbols.insert({Sym, NewName.str()});
+      Groups.push_back({Name, &Group, getBestSymbol(Symbols), {}});
+    }
+  }
+
+  // Naming a group only reads the table of taken names, so groups are
+  // independent of each other.
+  auto renameGroup = [&SymbolsByName](AmbiguousGroup& G) {
+    std::string NewName;
+    uint64_t Index = 0;
+    gtirb::Addr PrevAddress{0};
+    for (auto& [Addr, Sym] : *G.Symbols) {
+      if (Sym == G.SymbolToKeepOrigName) {
+        continue;
+      }
+      if (Addr != PrevAddress) {
+        Index = 0;
+        PrevAddress = Addr;
       }
+      NewName.assign(G.Name);
+      NewName += "_disambig_";
+      // Zero has no 0x prefix, as in gtirb::Addr's showbase output.
+      if (Addr == gtirb::Addr(0)) {
+        NewName += '0';
+      } else {
+        appendHex(NewName, static_cast<uint64_t>(Addr));
+      }
+      NewName += '_';
+      size_t PrefixSize = NewName.size();
+      do {
+        NewName.resize(PrefixSize);
+        appendDecimal(NewName, Index++);
+      } while (SymbolsByName.count(NewName) != 0);
+      G.NewNames.emplace_back(Sym, NewName);
+    }
+  };
+
+  // Only worth spawning threads for modules with very many duplicate names.
+  static constexpr size_t MinGroupsPerThread = 4096;
+  // hardware_concurrency() is 0 when it is not known.
+  size_t Threads =
+      std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+                       Groups.size() / MinGroupsPerThread);
+  if (Threads > 1) {
+    std::vector<std::thread> Workers;
+    for (size_t T = 0; T < Threads; ++T) {
+      Workers.emplace_back([&, T] {
+        for (size_t I = T; I < Groups.size(); I += Threads) {
+          renameGroup(Groups[I]);
+        }
+      });
+    }
+    for (auto& Worker : Workers) {
+      Worker.join();
+    }
+  } else {
+    for (auto& G : Groups) {
+      renameGroup(G);
+    }
+  }
+
+  for (auto& G : Groups) {
+    for (auto& [Sym, NewName] : G.NewNames) {
+      AmbiguousSymbols.emplace(Sym, std::move(NewName));
     }
   }
 }
 
 bool PrettyPrinterBase::isFunctionEntry(gtirb::Addr Addr) const {
   for (auto& Block : module.findBlocksAt(Addr)) {
-    if (FunctionFirstBlocks.count(Block.getUUID()) > 0) {
+    if (functions().FunctionFirstBlocks.count(Block.getUUID()) > 0) {
       return true;
     }
   }
@@ -448,13 +588,38 @@ bool PrettyPrinterBase::isFunctionEntry(gtirb::Addr Addr) const {
 
 bool PrettyPrinterBase::isFunctionLastBlock(gtirb::Addr Addr) const {
   for (auto& Block : module.findBlocksAt(Addr)) {
-    if (FunctionLastBlocks.count(Block.getUUID()) > 0) {
+    if (functions().FunctionLastBlocks.count(Block.getUUID()) > 0) {
       return true;
     }
   }
   return false;
 }
 
+const InsnGroups& PrettyPrinterBase::getInsnGroups(const cs_insn& Insn) {
+  if (CachedGroupsInsn == &Insn && CachedGroupsAddress == Insn.address) {
+    return CachedInsnGroups;
+  }
+  CachedGroupsInsn = &Insn;
+  CachedGroupsAddress = Insn.address;
+  CachedInsnGroups = InsnGroups();
+  if (Insn.detail) {
+    for (uint8_t I = 0; I < Insn.detail->groups_count; ++I) {
+      switch (Insn.detail->groups[I]) {
+      case CS_GRP_CALL:
+        CachedInsnGroups.Flags |= InsnGroups::Call;
+        break;
+      case CS_GRP_JUMP:
+        CachedInsnGroups.Flags |= InsnGroups::Jump;
+        break;
+      case CS_GRP_BRANCH_RELATIVE:
+        CachedInsnGroups.Flags |= InsnGroups::BranchRelative;
+        break;
+      }
+    }
+  }
+  return CachedInsnGroups;
+}
+
 const gtirb::SymAddrConst* PrettyPrinterBase::getSymbolicImmediate(
     const gtirb::SymbolicExpression* symex) {
   if (symex) {
@@ -468,8 +633,9 @@ const gtirb::SymAddrConst* PrettyPrinterBase::getSymbolicImmediate(
 void PrettyPrinterBase::printIntegralSymbols(std::ostream& os) {
   // print integral symbols
   for (const auto& sym : module.symbols_by_name()) {
-    if (auto addr = sym.getAddress();
-        addr && !sym.hasReferent() && !shouldSkip(policy, sym)) {
+    if (auto addr = sym.getAddress(); addr && !sym.hasReferent() &&
+                                      DefineIntegralSymbols &&
+                                      !shouldSkip(policy, sym)) {
       os << syntax.comment() << " WARNING: integral symbol " << sym.getName()
          << " may not have been correctly relocated\n";
       printIntegralSymbol(os, sym);
@@ -483,23 +649,394 @@ void PrettyPrinterBase::printIntegralSymbols(std::ostream& os) {
   }
 }
 
-std::ostream& PrettyPrinterBase::print(std::ostream& os) {
-  computeAmbiguousSymbols();
+void PrettyPrinterBase::printShardExport(std::ostream& os,
+                                         const gtirb::Symbol& symbol) {
+  os << syntax.global() << ' ' << getSymbolSpelling(symbol) << '\n';
+}
 
+void PrettyPrinterBase::startListing(std::ostream& os) {
+  FunctionIndexEntries.clear();
+  CFIStartProc = std::nullopt;
   printHeader(os);
+}
+
+void PrettyPrinterBase::finishListing(std::ostream& os) {
+  printIntegralSymbols(os);
+  printFooter(os);
+}
+
+std::ostream& PrettyPrinterBase::print(std::ostream& os) {
+  printTogether({{this, &os}});
+  return os;
+}
+
+void PrettyPrinterBase::printTogether(const std::vector<Output>& Outputs) {
+  if (Outputs.empty()) {
+    return;
+  }
+  PrettyPrinterBase& First = *Outputs.front().first;
+  Statistics::Timer Timer(First.Stats, "print");
+  std::vector<std::streampos> Starts;
+
+  // Symbol names and functions are taken from the module and its file format
+  // alone, so they are computed once and shared by every printer.
+  First.computeAmbiguousSymbols();
+  auto Functions = First.functionInformation();
+  for (auto& [Printer, OS] : Outputs) {
+    Starts.push_back(Printer->Stats ? OS->tellp() : std::streampos(-1));
+    if (Printer != &First) {
+      Printer->AmbiguousSymbols = First.AmbiguousSymbols;
+      Printer->SymbolSpellings.clear();
+      Printer->setFunctionInformation(Functions);
+    }
+    Printer->startListing(*OS);
+  }
 
-  // print every section
-  for (const auto& section : module.sections()) {
-    printSection(os, section);
+  if (Outputs.size() == 1) {
+    for (const auto& Section : First.module.sections()) {
+      First.printSection(*Outputs.front().second, Section);
+    }
+  } else {
+    // Each block is printed by every printer in turn, so a printer that
+    // shares a DecodeCache finds the block already decoded by the one before
+    // it.
+    std::vector<SectionProgress> Progress(Outputs.size());
+    std::vector<bool> Printing(Outputs.size());
+    for (const auto& Section : First.module.sections()) {
+      for (size_t I = 0; I < Outputs.size(); ++I) {
+        auto& [Printer, OS] = Outputs[I];
+        Progress[I] = SectionProgress{};
+        Printing[I] = Printer->beginSection(*OS, Section, Progress[I]);
+      }
+      for (const auto& Block : Section.blocks()) {
+        for (size_t I = 0; I < Outputs.size(); ++I) {
+          if (Printing[I]) {
+            auto& [Printer, OS] = Outputs[I];
+            Printer->printSectionBlock(*OS, Section, Block, Progress[I]);
+          }
+        }
+      }
+      for (size_t I = 0; I < Outputs.size(); ++I) {
+        if (Printing[I]) {
+          auto& [Printer, OS] = Outputs[I];
+          Printer->endSection(*OS, Section, Progress[I]);
+        }
+      }
+    }
   }
 
-  printIntegralSymbols(os);
+  for (size_t I = 0; I < Outputs.size(); ++I) {
+    auto& [Printer, OS] = Outputs[I];
+    Printer->finishListing(*OS);
+    if (Starts[I] != std::streampos(-1)) {
+      if (std::streampos End = OS->tellp(); End != std::streampos(-1))
+        Printer->Stats->add(Statistics::Counter::BytesWritten,
+                            static_cast<uint64_t>(End - Starts[I]));
+    }
+  }
+}
 
-  // print footer
-  printFooter(os);
+std::vector<ListingShard> PrettyPrinterBase::computeListingShards() {
+  std::vector<const gtirb::Section*> Sections;
+  std::unordered_map<const gtirb::Section*, size_t> SectionIndex;
+  for (const auto& Section : module.sections()) {
+    if (!shouldSkip(policy, Section)) {
+      SectionIndex.emplace(&Section, Sections.size());
+      Sections.push_back(&Section);
+    }
+  }
+
+  // Sections that must be assembled together are merged into one set.
+  std::vector<size_t> Parent(Sections.size());
+  std::iota(Parent.begin(), Parent.end(), 0);
+  auto findSet = [&Parent](size_t I) {
+    while (Parent[I] != I) {
+      I = Parent[I] = Parent[Parent[I]];
+    }
+    return I;
+  };
+  auto merge = [&](size_t A, size_t B) {
+    A = findSet(A);
+    B = findSet(B);
+    Parent[std::max(A, B)] = std::min(A, B);
+  };
+  auto sectionOf = [&](const gtirb::Node* Block) -> std::optional<size_t> {
+    const gtirb::ByteInterval* BI = nullptr;
+    if (auto* CB = gtirb::dyn_cast_or_null<gtirb::CodeBlock>(Block)) {
+      BI = CB->getByteInterval();
+    } else if (auto* DB = gtirb::dyn_cast_or_null<gtirb::DataBlock>(Block)) {
+      BI = DB->getByteInterval();
+    }
+    if (BI) {
+      if (auto It = SectionIndex.find(BI->getSection());
+          It != SectionIndex.end()) {
+        return It->second;
+      }
+    }
+    return std::nullopt;
+  };
+  // The section whose listing defines Symbol, if it is printed.
+  auto definingSection =
+      [&](const gtirb::Symbol* Symbol) -> std::optional<size_t> {
+    if (!Symbol || shouldSkip(policy, *Symbol)) {
+      return std::nullopt;
+    }
+    if (auto* CB = Symbol->getReferent<gtirb::CodeBlock>()) {
+      if (!shouldSkip(policy, *CB))
+        return sectionOf(CB);
+    } else if (auto* DB = Symbol->getReferent<gtirb::DataBlock>()) {
+      if (!shouldSkip(policy, *DB))
+        return sectionOf(DB);
+    }
+    return std::nullopt;
+  };
+
+  // A function's .size and CFI procedure span all of its blocks.
+  std::map<gtirb::UUID, size_t> FunctionSections;
+  for (const auto& [Block, Function] : functions().BlockToFunction) {
+    if (auto Section =
+            sectionOf(nodeFromUUID<gtirb::CodeBlock>(context, Block))) {
+      auto [It, Inserted] = FunctionSections.emplace(Function, *Section);
+      if (!Inserted) {
+        merge(It->second, *Section);
+      }
+    }
+  }
+
+  // The symbols each section refers to. A symbol difference can only be
+  // resolved by the assembler when both symbols are defined in the same
+  // object as the expression.
+  std::vector<std::pair<size_t, const gtirb::Symbol*>> References;
+  auto addReference = [&](size_t Section, const gtirb::Symbol* Symbol) {
+    if (Symbol) {
+      References.emplace_back(Section, Symbol);
+      if (const gtirb::Symbol* Forwarded = getForwardedSymbol(Symbol)) {
+        References.emplace_back(Section, Forwarded);
+      }
+    }
+  };
+  for (size_t I = 0; I < Sections.size(); ++I) {
+    for (const auto& BI : Sections[I]->byte_intervals()) {
+      for (const auto& SEE : BI.symbolic_expressions()) {
+        const auto& Expr = SEE.getSymbolicExpression();
+        if (const auto* SAC = std::get_if<gtirb::SymAddrConst>(&Expr)) {
+          addReference(I, SAC->Sym);
+        } else if (const auto* SAA = std::get_if<gtirb::SymAddrAddr>(&Expr)) {
+          addReference(I, SAA->Sym1);
+          addReference(I, SAA->Sym2);
+          for (const gtirb::Symbol* Sym : {SAA->Sym1, SAA->Sym2}) {
+            if (auto Section = definingSection(Sym)) {
+              merge(I, *Section);
+            }
+          }
+        }
+      }
+    }
+  }
+  if (const auto* Directives =
+          module.getAuxData<gtirb::schema::CfiDirectives>()) {
+    for (const auto& [Offset, List] : *Directives) {
+      auto Section = sectionOf(
+          nodeFromUUID<gtirb::CodeBlock>(context, Offset.ElementId));
+      if (!Section) {
+        continue;
+      }
+      for (const auto& Directive : List) {
+        addReference(*Section, nodeFromUUID<gtirb::Symbol>(
+                                   context, std::get<2>(Directive)));
+      }
+    }
+  }
+
+  std::vector<ListingShard> Shards;
+  std::vector<size_t> ShardOfSet(Sections.size(), Sections.size());
+  for (size_t I = 0; I < Sections.size(); ++I) {
+    size_t& Shard = ShardOfSet[findSet(I)];
+    if (Shard == Sections.size()) {
+      Shard = Shards.size();
+      Shards.emplace_back();
+    }
+    Shards[Shard].Sections.push_back(Sections[I]);
+  }
+  if (Shards.empty()) {
+    Shards.emplace_back();
+  }
+  Shards.front().Primary = true;
+
+  // Integral symbols are defined in the primary shard.
+  std::unordered_set<const gtirb::Symbol*> Exported;
+  for (const auto& [Section, Symbol] : References) {
+    std::optional<size_t> Home;
+    if (auto Defining = definingSection(Symbol)) {
+      Home = ShardOfSet[findSet(*Defining)];
+    } else if (Symbol->getAddress() && !Symbol->hasReferent() &&
+               !shouldSkip(policy, *Symbol)) {
+      Home = 0;
+    }
+    if (Home && *Home != ShardOfSet[findSet(Section)] &&
+        Exported.insert(Symbol).second) {
+      Shards[*Home].Exports.push_back(Symbol);
+    }
+  }
+  // Keep each shard's listing independent of the order of the references.
+  for (ListingShard& Shard : Shards) {
+    std::stable_sort(Shard.Exports.begin(), Shard.Exports.end(),
+                     [](const gtirb::Symbol* A, const gtirb::Symbol* B) {
+                       return std::make_pair(A->getName(), A->getAddress()) <
+                              std::make_pair(B->getName(), B->getAddress());
+                     });
+  }
+  return Shards;
+}
+
+void PrettyPrinterBase::printShards(const std::vector<ListingShard>& Shards,
+                                    const std::vector<std::ostream*>& Streams) {
+  assert(Shards.size() == Streams.size() && "one stream per shard");
+  Statistics::Timer Timer(Stats, "print");
+  computeAmbiguousSymbols();
+  for (size_t I = 0; I < Shards.size(); ++I) {
+    std::ostream& OS = *Streams[I];
+    std::streampos Start = Stats ? OS.tellp() : std::streampos(-1);
+    startListing(OS);
+    for (const gtirb::Section* Section : Shards[I].Sections) {
+      printSection(OS, *Section);
+    }
+    for (const gtirb::Symbol* Symbol : Shards[I].Exports) {
+      printShardExport(OS, *Symbol);
+    }
+    DefineIntegralSymbols = Shards[I].Primary;
+    finishListing(OS);
+    DefineIntegralSymbols = true;
+    if (Start != std::streampos(-1)) {
+      if (std::streampos End = OS.tellp(); End != std::streampos(-1))
+        Stats->add(Statistics::Counter::BytesWritten,
+                   static_cast<uint64_t>(End - Start));
+    }
+  }
+}
+
+std::ostream& PrettyPrinterBase::printRange(std::ostream& os,
+                                            gtirb::Addr Begin,
+                                            gtirb::Addr End) {
+  return printBlocksIf(
+      os, [&](const gtirb::Node&, gtirb::Addr Addr, uint64_t Size) {
+        return Addr < End && Begin < Addr + Size;
+      });
+}
+
+std::ostream& PrettyPrinterBase::printFunction(std::ostream& os,
+                                               const gtirb::UUID& Function) {
+  return printBlocksIf(os, [&](const gtirb::Node& Block, gtirb::Addr,
+                               uint64_t) {
+    auto It = functions().BlockToFunction.find(Block.getUUID());
+    return It != functions().BlockToFunction.end() && It->second == Function;
+  });
+}
+
+std::ostream& PrettyPrinterBase::printBlocksIf(std::ostream& os,
+                                               BlockPredicate Selected) {
+  computeAmbiguousSymbols();
+  SelectedBlocks = std::move(Selected);
+
+  startListing(os);
+  for (const auto& Section : module.sections()) {
+    printSection(os, Section);
+  }
+  finishListing(os);
+
+  SelectedBlocks = nullptr;
   return os;
 }
 
+void PrettyPrinterBase::skipBlock(const gtirb::Node& Block, gtirb::Addr Addr,
+                                  uint64_t Size) {
+  auto* CB = gtirb::dyn_cast<gtirb::CodeBlock>(&Block);
+  auto* DB = gtirb::dyn_cast<gtirb::DataBlock>(&Block);
+  if ((CB && shouldSkip(policy, *CB)) || (DB && shouldSkip(policy, *DB))) {
+    return;
+  }
+  programCounter = std::max(programCounter, Addr + Size);
+
+  // Replay the procedure boundaries that printCFIDirectives would have seen.
+  const auto* Directives = module.getAuxData<gtirb::schema::CfiDirectives>();
+  if (!CB || !Directives || LstMode == ListingUI) {
+    return;
+  }
+  for (auto It = Directives->lower_bound(gtirb::Offset(CB->getUUID(), 0));
+       It != Directives->end() && It->first.ElementId == CB->getUUID();
+       ++It) {
+    for (const auto& Directive : It->second) {
+      const std::string& Name = std::get<0>(Directive);
+      if (Name == ".cfi_startproc") {
+        CFIStartProc = Addr;
+      } else if (Name == ".cfi_endproc") {
+        CFIStartProc = std::nullopt;
+      }
+    }
+  }
+}
+
+std::optional<uint64_t>
+PrettyPrinterBase::listingOffset(std::ostream& os) const {
+  if (!Index) {
+    return std::nullopt;
+  }
+  std::streampos Pos = os.tellp();
+  if (Pos == std::streampos(-1)) {
+    return std::nullopt;
+  }
+  return static_cast<uint64_t>(Pos);
+}
+
+template <typename BlockType>
+void PrettyPrinterBase::indexBlock(std::ostream& os, const BlockType& Block,
+                                   std::optional<uint64_t> Start) {
+  std::optional<uint64_t> End = listingOffset(os);
+  if (!Start || !End) {
+    return;
+  }
+  uint64_t Begin = static_cast<uint64_t>(*Block.getAddress());
+  uint64_t Last = Begin + Block.getSize();
+  Index->add({ListingIndexEntry::Kind::Block, Block.getUUID(), Begin, Last,
+              *Start, *End - *Start, ""});
+
+  // A function covers all of its blocks.
+  auto Function = functions().BlockToFunction.find(Block.getUUID());
+  if (Function == functions().BlockToFunction.end()) {
+    return;
+  }
+  auto [It, Inserted] = FunctionIndexEntries.try_emplace(Function->second, 0);
+  if (Inserted) {
+    std::string Name;
+    if (const gtirb::Symbol* Sym = getContainerFunctionSymbol(Block.getUUID()))
+      Name = getSymbolSpelling(*Sym);
+    It->second = Index->add({ListingIndexEntry::Kind::Function,
+                             Function->second, Begin, Last, *Start,
+                             *End - *Start, std::move(Name)});
+    return;
+  }
+  ListingIndexEntry& Entry = (*Index)[It->second];
+  uint64_t EntryEnd = std::max(Entry.Offset + Entry.Size, *End);
+  Entry.Begin = std::min(Entry.Begin, Begin);
+  Entry.End = std::max(Entry.End, Last);
+  Entry.Offset = std::min(Entry.Offset, *Start);
+  Entry.Size = EntryEnd - Entry.Offset;
+}
+
+void PrettyPrinterBase::indexSection(std::ostream& os,
+                                     const gtirb::Section& Section,
+                                     std::optional<uint64_t> Start) {
+  std::optional<uint64_t> End = listingOffset(os);
+  if (!Start || !End) {
+    return;
+  }
+  uint64_t Begin = static_cast<uint64_t>(
+      Section.getAddress().value_or(gtirb::Addr{0}));
+  uint64_t Size = Section.getSize().value_or(0);
+  Index->add({ListingIndexEntry::Kind::Section, Section.getUUID(), Begin,
+              Begin + Size, *Start, *End - *Start, Section.getName()});
+}
+
 void PrettyPrinterBase::printOverlapWarning(std::ostream& os,
                                             const gtirb::Addr addr) {
   std::cerr << "WARNING: found overlapping element at address " << std::hex
@@ -507,10 +1044,35 @@ void PrettyPrinterBase::printOverlapWarning(std::ostream& os,
             << "The --layout option to gtirb-pprinter can fix "
                "overlapping elements."
             << std::endl;
-  std::ios_base::fmtflags flags = os.flags();
-  os << syntax.comment() << " WARNING: found overlapping blocks at address "
-     << std::hex << static_cast<uint64_t>(addr) << '\n';
-  os.flags(flags);
+  os << syntax.comment() << " WARNING: found overlapping blocks at address ";
+  writeHex(os, static_cast<uint64_t>(addr), BareHexFormat);
+  os << '\n';
+}
+
+DecodeCache::~DecodeCache() {
+  if (Insns) {
+    cs_free(Insns, Count);
+  }
+}
+
+std::pair<cs_insn*, size_t> DecodeCache::decode(csh Handle,
+                                                const gtirb::CodeBlock& B,
+                                                uint64_t Off,
+                                                Statistics* Stats) {
+  if (Block == &B && Offset == Off) {
+    return {Insns, Count};
+  }
+  if (Insns) {
+    cs_free(Insns, Count);
+    Insns = nullptr;
+  }
+  Block = &B;
+  Offset = Off;
+  Count = cs_disasm(Handle, B.rawBytes<uint8_t>() + Off, B.getSize() - Off,
+                    static_cast<uint64_t>(*B.getAddress()) + Off, 0, &Insns);
+  if (Stats)
+    Stats->add(Statistics::Counter::InstructionsDecoded, Count);
+  return {Insns, Count};
 }
 
 void PrettyPrinterBase::printBlockContents(std::ostream& os,
@@ -520,24 +1082,31 @@ void PrettyPrinterBase::printBlockContents(std::ostream& os,
     return;
   }
 
-  gtirb::Addr addr = *x.getAddress();
   os << '\n';
 
-  cs_insn* insn;
+  DecodeCache Local;
+  DecodeCache& Cache = Decoded ? *Decoded : Local;
   cs_option(this->csHandle, CS_OPT_DETAIL, CS_OPT_ON);
-  size_t count = cs_disasm(this->csHandle, x.rawBytes<uint8_t>() + offset,
-                           x.getSize() - offset,
-                           static_cast<uint64_t>(addr) + offset, 0, &insn);
-
-  // Exception-safe cleanup of instructions
-  std::unique_ptr<cs_insn, std::function<void(cs_insn*)>> freeInsn(
-      insn, [count](cs_insn* i) { cs_free(i, count); });
+  auto [insn, count] = Cache.decode(this->csHandle, x, offset, Stats);
 
   gtirb::Offset blockOffset(x.getUUID(), offset);
   for (size_t i = 0; i < count; i++) {
-    fixupInstruction(insn[i]);
-    printInstruction(os, x, insn[i], blockOffset);
-    blockOffset.Displacement += insn[i].size;
+    // Fixups rewrite the instruction, so shared instructions are fixed up in
+    // a copy.
+    cs_insn* Insn = &insn[i];
+    cs_insn Copy;
+    cs_detail Detail;
+    if (Decoded) {
+      Copy = *Insn;
+      if (Copy.detail) {
+        Detail = *Copy.detail;
+        Copy.detail = &Detail;
+      }
+      Insn = &Copy;
+    }
+    fixupInstruction(*Insn);
+    printInstruction(os, x, *Insn, blockOffset);
+    blockOffset.Displacement += Insn->size;
   }
   // print any CFI directives located at the end of the block
   // e.g. '.cfi_endproc' is usually attached to the end of the block
@@ -561,7 +1130,7 @@ void PrettyPrinterBase::printSectionHeader(std::ostream& os,
   } else {
     printSectionHeaderDirective(os, section);
     printSectionProperties(os, section);
-    os << std::endl;
+    os << '\n';
   }
   printBar(os);
   os << '\n';
@@ -585,14 +1154,14 @@ void PrettyPrinterBase::printBar(std::ostream& os, bool heavy) {
 std::string PrettyPrinterBase::getFunctionName(gtirb::Addr Addr) const {
 
   for (auto& Block : module.findBlocksAt(Addr)) {
-    if (FunctionFirstBlocks.count(Block.getUUID()) > 0) {
+    if (functions().FunctionFirstBlocks.count(Block.getUUID()) > 0) {
       if (auto FunctionSymbol = getContainerFunctionSymbol(Block.getUUID());
           FunctionSymbol) {
         return FunctionSymbol->getName();
       } else {
-        std::stringstream Name;
-        Name << "unknown_function_" << std::hex << static_cast<uint64_t>(Addr);
-        return Name.str();
+        std::string Name{"unknown_function_"};
+        appendHex(Name, static_cast<uint64_t>(Addr), BareHexFormat);
+        return Name;
       }
     }
   }
@@ -604,6 +1173,7 @@ bool PrettyPrinterBase::printSymbolReference(std::ostream& os,
   if (!symbol)
     return false;
 
+  recordSymbolReference(*symbol);
   std::optional<std::string> forwardedName = getForwardedSymbolName(symbol);
   if (forwardedName) {
     if (LstMode == ListingDebug || LstMode == ListingUI) {
@@ -637,13 +1207,18 @@ bool PrettyPrinterBase::printSymbolReference(std::ostream& os,
     }
     return true;
   }
-  os << getSymbolName(*symbol);
+  os << getSymbolSpelling(*symbol);
   return false;
 }
 
+void PrettyPrinterBase::recordSymbolReference(const gtirb::Symbol& Symbol) {
+  if (Tokens)
+    Tokens->symbolReference(Symbol.getUUID());
+}
+
 void PrettyPrinterBase::printSymbolDefinition(std::ostream& os,
                                               const gtirb::Symbol& symbol) {
-  os << getSymbolName(symbol) << ":\n";
+  os << getSymbolSpelling(symbol) << ":\n";
 }
 
 void PrettyPrinterBase::fixupInstruction(cs_insn&) {}
@@ -651,80 +1226,7 @@ void PrettyPrinterBase::fixupInstruction(cs_insn&) {}
 // Helper for x86-specific fixups, called from Att, Intel, and Masm pretty
 // printers (Masm has additional fixups).
 void PrettyPrinterBase::x86FixupInstruction(cs_insn& inst) {
-  cs_x86& detail = inst.detail->x86;
-
-  // Operands are implicit for various MOVS* instructions. But there is also
-  // an SSE2 instruction named MOVSD which has explicit operands.
-  if ((inst.id == X86_INS_MOVSB || inst.id == X86_INS_MOVSW ||
-       inst.id == X86_INS_MOVSD || inst.id == X86_INS_MOVSQ) &&
-      inst.detail->groups[0] != X86_GRP_SSE2) {
-    detail.op_count = 0;
-  }
-
-  // Register operands are implicit for STOS* instructions.
-  if (inst.id == X86_INS_STOSB || inst.id == X86_INS_STOSW ||
-      inst.id == X86_INS_STOSD || inst.id == X86_INS_STOSQ) {
-    detail.op_count = 1;
-  }
-
-  // IMUL: third operand is a signed number, but it is decoded as unsigned.
-  if (inst.id == X86_INS_IMUL && detail.op_count == 3) {
-    cs_x86_op& op = detail.operands[2];
-    op.imm = static_cast<int32_t>(op.imm);
-  }
-
-  // The first operand of fxch  st(0) is implicit
-  if (inst.id == X86_INS_FXCH && detail.op_count == 2) {
-    detail.operands[0] = detail.operands[1];
-    detail.op_count = 1;
-  }
-
-  // Comisd loads 64 bits from memory not 128
-  if (inst.id == X86_INS_COMISD || inst.id == X86_INS_VCOMISD) {
-    if (detail.op_count == 2 && detail.operands[1].type == X86_OP_MEM &&
-        detail.operands[1].size == 16) {
-      detail.operands[1].size = 8;
-    }
-  }
-
-  // Comiss loads 32 bits from memory not 64
-  if (inst.id == X86_INS_COMISS || inst.id == X86_INS_VCOMISS) {
-    if (detail.op_count == 2 && detail.operands[1].type == X86_OP_MEM) {
-      detail.operands[1].size = 4;
-    }
-  }
-
-  // Operands that should not have a size annotation:
-  // FXSAVE, XSAVE, XSAVEC, FXRSTOR, XRSTOR
-  if (detail.op_count == 1 &&
-      (inst.id == X86_INS_FXSAVE || inst.id == X86_INS_XSAVE ||
-       inst.id == X86_INS_XSAVEC || inst.id == X86_INS_FXRSTOR ||
-       inst.id == X86_INS_XRSTOR)) {
-    detail.operands[0].size = 0;
-  }
-
-  // RDRAND and RDSEED should be printed with no suffix:
-  // https://github.com/aquynh/capstone/issues/1603
-  if (inst.id == X86_INS_RDRAND) {
-    strcpy(inst.mnemonic, "rdrand");
-  } else if (inst.id == X86_INS_RDSEED) {
-    strcpy(inst.mnemonic, "rdseed");
-  }
-
-  // PUNPCKL* memory operands are 32 bits
-  if (inst.id == X86_INS_PUNPCKLWD || inst.id == X86_INS_PUNPCKLBW ||
-      inst.id == X86_INS_PUNPCKLDQ) {
-    if (detail.op_count == 2 && detail.operands[1].type == X86_OP_MEM &&
-        detail.operands[1].size == 8) {
-      detail.operands[1].size = 4;
-    }
-  } else if (inst.id == X86_INS_INT1 || inst.id == X86_INS_INT3) {
-    int N = (inst.id == X86_INS_INT1 ? 1 : 3);
-    strcpy(inst.mnemonic, "int");
-    detail.operands[0].type = X86_OP_IMM;
-    detail.operands[0].imm = N;
-    detail.op_count = 1;
-  }
+  x86::fixupInstruction(inst);
 }
 
 void PrettyPrinterBase::printPrototype(std::ostream& os,
@@ -734,9 +1236,9 @@ void PrettyPrinterBase::printPrototype(std::ostream& os,
     return;
   }
   auto Addr = *block.getAddress() + offset.Displacement;
-  if (FunctionFirstBlocks.count(block.getUUID()) > 0 &&
+  if (functions().FunctionFirstBlocks.count(block.getUUID()) > 0 &&
       offset.Displacement == 0) {
-    type_printer.printPrototype(Addr, os, syntax.comment()) << std::endl;
+    type_printer.printPrototype(Addr, os, syntax.comment()) << '\n';
   }
 }
 
@@ -774,7 +1276,9 @@ void PrettyPrinterBase::printInstruction(std::ostream& os,
   InstructLine << "  " << opcode << ' ';
   // Make sure the initial m_accum_comment is empty.
   m_accum_comment.clear();
+  std::streampos OperandsStart = InstructLine.tellp();
   printOperandList(InstructLine, block, inst);
+  recordInstructionTokens(opcode, InstructLine, OperandsStart);
   if (!m_accum_comment.empty()) {
     InstructLine << " " << syntax.comment() << " " << m_accum_comment;
     m_accum_comment.clear();
@@ -783,10 +1287,21 @@ void PrettyPrinterBase::printInstruction(std::ostream& os,
   os << '\n';
 }
 
+void PrettyPrinterBase::recordInstructionTokens(
+    std::string_view Mnemonic, const std::stringstream& Line,
+    std::streampos OperandsStart) {
+  if (!Tokens)
+    return;
+  std::string Text = Line.str();
+  size_t Start = std::min(static_cast<size_t>(OperandsStart), Text.size());
+  Tokens->instruction(Mnemonic, std::string_view(Text).substr(Start));
+}
+
 void PrettyPrinterBase::printEA(std::ostream& os, gtirb::Addr ea) {
   os << syntax.tab();
   if (this->LstMode == ListingDebug) {
-    os << std::hex << static_cast<uint64_t>(ea) << ": " << std::dec;
+    writeHex(os, static_cast<uint64_t>(ea), BareHexFormat);
+    os << ": ";
   }
 }
 
@@ -795,49 +1310,15 @@ void PrettyPrinterBase::printOperandList(std::ostream& os,
                                          const cs_insn& inst) {
   const cs_x86& detail = inst.detail->x86;
 
-  // some instructions don't put commas between their operands, but instead
-  // put it in between {}s. These instructions are always AVX512 instructions
-  // when you use the k registers. Not all AVX512 instructions use the k
-  // registers in this manner, however.
-  // TODO: find an exhaustive list of such instructions, or find a way for
-  // Capstone to tell us this information directly.
-  static const std::unordered_set<x86_insn> UnbracketedAVX512Instructions {
-    X86_INS_KANDNB, X86_INS_KANDNW, X86_INS_KANDND, X86_INS_KANDNQ,
-        X86_INS_KMOVB, X86_INS_KMOVW, X86_INS_KMOVD, X86_INS_KMOVQ,
-        X86_INS_KUNPCKBW, X86_INS_KNOTB, X86_INS_KNOTW, X86_INS_KNOTD,
-        X86_INS_KNOTQ, X86_INS_KORB, X86_INS_KORW, X86_INS_KORD, X86_INS_KORQ,
-        X86_INS_KORTESTB, X86_INS_KORTESTW, X86_INS_KORTESTD, X86_INS_KORTESTQ,
-        X86_INS_KSHIFTLB, X86_INS_KSHIFTLW, X86_INS_KSHIFTLD, X86_INS_KSHIFTLQ,
-        X86_INS_KSHIFTRB, X86_INS_KSHIFTRW, X86_INS_KSHIFTRD, X86_INS_KSHIFTRQ,
-        X86_INS_KXNORB, X86_INS_KXNORW, X86_INS_KXNORD, X86_INS_KXNORQ,
-        X86_INS_KXORB, X86_INS_KXORW, X86_INS_KXORD, X86_INS_KXORQ,
-#if CS_API_MAJOR >= 5
-        X86_INS_KUNPCKDQ, X86_INS_KUNPCKWD, X86_INS_KADDB, X86_INS_KADDW,
-        X86_INS_KADDD, X86_INS_KADDQ, X86_INS_KTESTB, X86_INS_KTESTW,
-        X86_INS_KTESTD, X86_INS_KTESTQ, X86_INS_VPCMPESTRI
-#endif
-  };
-
-  static const std::unordered_set<x86_insn> BracketedSecondKAVX512Instrs{
-      X86_INS_VPCMPB,    X86_INS_VPCMPD,    X86_INS_VPCMPQ,
-      X86_INS_VPCMPW,    X86_INS_VPCMPUB,   X86_INS_VPCMPUD,
-      X86_INS_VPCMPUQ,   X86_INS_VPCMPUW,   X86_INS_VPCMPEQB,
-      X86_INS_VPCMPEQD,  X86_INS_VPCMPEQQ,  X86_INS_VPCMPEQW,
-      X86_INS_VPCMPGTB,  X86_INS_VPCMPGTD,  X86_INS_VPCMPGTQ,
-      X86_INS_VPCMPGTW,  X86_INS_VPTEST,    X86_INS_VPTESTMB,
-      X86_INS_VPTESTMD,  X86_INS_VPTESTMQ,  X86_INS_VPTESTMW,
-      X86_INS_VPTESTNMB, X86_INS_VPTESTNMD, X86_INS_VPTESTNMQ,
-      X86_INS_VPTESTNMW,
-  };
-
-  bool IsBracketedAVX512Instruction =
-      UnbracketedAVX512Instructions.count(static_cast<x86_insn>(inst.id)) == 0;
-
-  bool IsBracketedSecondKAVX512Instr =
-      BracketedSecondKAVX512Instrs.count(static_cast<x86_insn>(inst.id)) != 0;
+  // AVX512 instructions print the k registers in braces instead of
+  // separating them with commas, except for those listed in the
+  // x86::UnbracketedKMask flags.
+  uint16_t InsnFlags = x86::getInsnFlags(inst.id);
+  bool IsBracketedAVX512Instruction = !(InsnFlags & x86::UnbracketedKMask);
+  bool IsBracketedSecondKAVX512Instr = InsnFlags & x86::BracketedSecondKMask;
 
   // For some of the AVX512 instrutions
-  // (listed in BracketedSecondKAVX512Instrs),
+  // (with the x86::BracketedSecondKMask flag),
   // the first K register is not bracketed.
   // E.g., vpcmpnequb (%rdi),%ymm18,%k1{%k2}
   // For such instructions, have BracketedK initially set to false
@@ -930,6 +1411,7 @@ void PrettyPrinterBase::printBlockImpl(std::ostream& os, BlockType& block) {
   if (shouldSkip(policy, block)) {
     return;
   }
+  std::optional<uint64_t> Start = listingOffset(os);
 
   // Print symbols associated with block.
   gtirb::Addr addr = *block.getAddress();
@@ -945,6 +1427,7 @@ void PrettyPrinterBase::printBlockImpl(std::ostream& os, BlockType& block) {
     for (const auto& sym : module.findSymbols(block)) {
       if (!sym.getAtEnd() && !shouldSkip(policy, sym)) {
         printSymbolDefinitionRelativeToPC(os, sym, programCounter);
+        recordLabel(sym, addr);
       }
     }
   } else {
@@ -959,6 +1442,7 @@ void PrettyPrinterBase::printBlockImpl(std::ostream& os, BlockType& block) {
     for (const auto& sym : module.findSymbols(block)) {
       if (!sym.getAtEnd() && !shouldSkip(policy, sym)) {
         printSymbolDefinition(os, sym);
+        recordLabel(sym, addr);
       }
     }
   }
@@ -972,6 +1456,7 @@ void PrettyPrinterBase::printBlockImpl(std::ostream& os, BlockType& block) {
             block.getByteInterval()->getSymbolicExpression(block.getOffset())) {
       if (std::holds_alternative<gtirb::SymAddrConst>(*SymExpr)) {
         if (shouldSkip(policy, *std::get<gtirb::SymAddrConst>(*SymExpr).Sym)) {
+          indexBlock(os, block, Start);
           return;
         }
       } else {
@@ -981,7 +1466,9 @@ void PrettyPrinterBase::printBlockImpl(std::ostream& os, BlockType& block) {
   }
 
   // Print actual block contents.
+  CurrentBlock = block.getUUID();
   printBlockContents(os, block, offset);
+  CurrentBlock = gtirb::UUID{};
 
   // Update the program counter.
   programCounter = std::max(programCounter, addr + block.getSize());
@@ -990,23 +1477,34 @@ void PrettyPrinterBase::printBlockImpl(std::ostream& os, BlockType& block) {
   for (const auto& sym : module.findSymbols(block)) {
     if (sym.getAtEnd() && !shouldSkip(policy, sym)) {
       printSymbolDefinition(os, sym);
+      recordLabel(sym, addr + block.getSize());
     }
   }
   // Print function ends if applicable
-  if (FunctionLastBlocks.count(block.getUUID()) > 0) {
+  if (functions().FunctionLastBlocks.count(block.getUUID()) > 0) {
     const gtirb::Symbol* FunctionSymbol =
         getContainerFunctionSymbol(block.getUUID());
     // A function could have no name associated to it.
     if (FunctionSymbol) {
       printFunctionEnd(os, *FunctionSymbol);
-      if (auto Aliases = FunctionAliases.find(FunctionSymbol);
-          Aliases != FunctionAliases.end()) {
+      if (auto Aliases = functions().FunctionAliases.find(FunctionSymbol);
+          Aliases != functions().FunctionAliases.end()) {
         for (const auto* Alias : Aliases->second) {
           printFunctionEnd(os, *Alias);
         }
       }
     }
   }
+  indexBlock(os, block, Start);
+}
+
+void PrettyPrinterBase::recordLabel(const gtirb::Symbol& Symbol,
+                                    gtirb::Addr BlockAddr) {
+  if (Tokens) {
+    gtirb::Addr EA = Symbol.getAddress().value_or(BlockAddr);
+    Tokens->label(static_cast<uint64_t>(EA), Symbol.getUUID(),
+                  getSymbolSpelling(Symbol));
+  }
 }
 
 void PrettyPrinterBase::printBlock(std::ostream& os,
@@ -1020,6 +1518,20 @@ void PrettyPrinterBase::printBlock(std::ostream& os,
   printBlockImpl(os, block);
 }
 
+// Count the zero bytes at the start of [Begin, End), eight at a time.
+static uint64_t countZeroBytes(const uint8_t* Begin, const uint8_t* End) {
+  const uint8_t* It = Begin;
+  for (; End - It >= 8; It += 8) {
+    uint64_t Word;
+    std::memcpy(&Word, It, sizeof(Word));
+    if (Word != 0)
+      break;
+  }
+  while (It != End && *It == 0)
+    ++It;
+  return It - Begin;
+}
+
 void PrettyPrinterBase::printBlockContents(std::ostream& os,
                                            const gtirb::DataBlock& dataObject,
                                            uint64_t offset) {
@@ -1031,12 +1543,16 @@ void PrettyPrinterBase::printBlockContents(std::ostream& os,
       dataObject.getByteInterval()->getSymbolicExpression(
           dataObject.getOffset() + offset);
   auto dataObjectBytes = dataObject.bytes<uint8_t>();
-  if (std::all_of(dataObjectBytes.begin() + offset, dataObjectBytes.end(),
-                  [](uint8_t x) { return x == 0; }) &&
-      !foundSymbolic)
+  const uint8_t* Data = dataObject.rawBytes<uint8_t>();
+  uint64_t Size = std::distance(dataObjectBytes.begin(), dataObjectBytes.end());
+  uint64_t LinesBefore = LinesPrinted;
+  if (!foundSymbolic &&
+      countZeroBytes(Data + offset, Data + Size) == Size - offset)
     printZeroDataBlock(os, dataObject, offset);
   else
     printNonZeroDataBlock(os, dataObject, offset);
+  if (Stats)
+    Stats->add(Statistics::Counter::DataLines, LinesPrinted - LinesBefore);
 }
 
 void PrettyPrinterBase::printNonZeroDataBlock(
@@ -1062,6 +1578,9 @@ void PrettyPrinterBase::printNonZeroDataBlock(
 
   // Otherwise, print each byte and/or symbolic expression in order.
   auto ByteRange = dataObject.bytes<uint8_t>();
+  const uint8_t* Data = dataObject.rawBytes<uint8_t>();
+  const uint8_t* DataEnd =
+      Data + std::distance(ByteRange.begin(), ByteRange.end());
   uint64_t ByteI = dataObject.getOffset() + offset;
 
   // print comments at the right location efficiently (with a single iterator).
@@ -1088,14 +1607,73 @@ void PrettyPrinterBase::printNonZeroDataBlock(
     }
   };
 
+  // Symbolic expressions in the rest of the block, in offset order. The
+  // cursor follows ByteI instead of searching the byte interval per byte.
+  auto SymExprs = dataObject.getByteInterval()->findSymbolicExpressionsAtOffset(
+      ByteI, dataObject.getOffset() + dataObject.getSize());
+  auto SymExprIt = SymExprs.begin();
+  auto SymExprEnd = SymExprs.end();
+
+  // The size table is keyed by (interval UUID, offset), so this interval's
+  // entries are contiguous and sorted like SymExprs. A second cursor follows
+  // the first one through them.
+  const gtirb::UUID& IntervalId = dataObject.getByteInterval()->getUUID();
+  const auto* Sizes = aux_data::getSymbolicExpressionSizes(module);
+  std::map<gtirb::Offset, uint64_t>::const_iterator SizeIt, SizeEnd;
+  if (Sizes) {
+    SizeIt = Sizes->lower_bound(gtirb::Offset(IntervalId, ByteI));
+    SizeEnd = Sizes->end();
+  }
+  auto symbolicExpressionSize =
+      [&](const gtirb::ByteInterval::ConstSymbolicExpressionElement& SEE) {
+        if (Sizes) {
+          gtirb::Offset Off(IntervalId, SEE.getOffset());
+          while (SizeIt != SizeEnd && SizeIt->first < Off) {
+            ++SizeIt;
+          }
+          if (SizeIt != SizeEnd && SizeIt->first == Off) {
+            return SizeIt->second;
+          }
+        }
+        return inferSymbolicExpressionSize(SEE);
+      };
+
+  // Length of the run of zero bytes at CurrOffset if it is long enough to
+  // print as a single directive, or 0. The run stops at the next symbolic
+  // expression or comment so that those keep their own lines.
+  static constexpr uint64_t MinZeroRun = 16;
+  auto zeroRunLength = [&]() -> uint64_t {
+    const uint8_t* Begin = Data + CurrOffset.Displacement;
+    if (*Begin != 0)
+      return 0;
+    uint64_t Length = countZeroBytes(Begin, DataEnd);
+    if (Length < MinZeroRun)
+      return 0;
+    if (SymExprIt != SymExprEnd) {
+      Length = std::min(Length, (*SymExprIt).getOffset() - ByteI);
+    }
+    if (HasComments) {
+      auto NextComment = CommentsIt;
+      if (NextComment != CommentsEnd && NextComment->first == CurrOffset)
+        ++NextComment;
+      if (NextComment != CommentsEnd &&
+          NextComment->first.ElementId == CurrOffset.ElementId) {
+        Length = std::min(Length, NextComment->first.Displacement -
+                                      CurrOffset.Displacement);
+      }
+    }
+    return Length >= MinZeroRun ? Length : 0;
+  };
+
   for (auto ByteIt = ByteRange.begin() + offset; ByteIt != ByteRange.end();) {
+    // Skip expressions overlapped by a previously printed one.
+    while (SymExprIt != SymExprEnd && (*SymExprIt).getOffset() < ByteI) {
+      ++SymExprIt;
+    }
 
-    if (auto FoundSymExprRange =
-            dataObject.getByteInterval()->findSymbolicExpressionsAtOffset(
-                ByteI);
-        !FoundSymExprRange.empty()) {
-      const auto SEE = FoundSymExprRange.front();
-      auto Size = getSymbolicExpressionSize(SEE);
+    if (SymExprIt != SymExprEnd && (*SymExprIt).getOffset() == ByteI) {
+      const auto SEE = *SymExprIt;
+      auto Size = symbolicExpressionSize(SEE);
       if (HasComments) {
         printCommentsBetween(Size);
       }
@@ -1108,12 +1686,26 @@ void PrettyPrinterBase::printNonZeroDataBlock(
             << "ERROR: " << EA
             << ": Size 0 SymbolicExpression: break infinite loop of printing\n";
       }
-      printCommentableLine(DataLine, os, *dataObject.getAddress() + offset);
+      printCommentableLine(DataLine, os, EA);
       os << '\n';
       printSymbolicDataFollowingComments(os, EA);
       ByteI += Size;
       ByteIt += Size;
       CurrOffset.Displacement += Size;
+    } else if (uint64_t Zeros = zeroRunLength()) {
+      if (HasComments) {
+        printCommentsBetween(Zeros);
+      }
+
+      std::stringstream DataLine;
+      printEA(DataLine, *dataObject.getAddress() + CurrOffset.Displacement);
+      printZeros(DataLine, Zeros);
+      printCommentableLine(DataLine, os,
+                           *dataObject.getAddress() + CurrOffset.Displacement);
+      os << '\n';
+      ByteI += Zeros;
+      ByteIt += Zeros;
+      CurrOffset.Displacement += Zeros;
     } else {
       if (HasComments) {
         printCommentsBetween(1);
@@ -1142,12 +1734,16 @@ void PrettyPrinterBase::printZeroDataBlock(std::ostream& os,
 
     std::stringstream DataLine;
     printEA(DataLine, *dataObject.getAddress() + offset);
-    DataLine << ".zero " << size;
+    printZeros(DataLine, size);
     printCommentableLine(DataLine, os, *dataObject.getAddress() + offset);
     os << '\n';
   }
 }
 
+void PrettyPrinterBase::printZeros(std::ostream& os, uint64_t Count) {
+  os << ".zero " << Count;
+}
+
 void PrettyPrinterBase::printComments(std::ostream& os,
                                       const gtirb::Offset& offset,
                                       uint64_t range) {
@@ -1171,6 +1767,9 @@ void PrettyPrinterBase::printComments(std::ostream& os,
 void PrettyPrinterBase::printCommentableLine(std::stringstream& LineContents,
                                              std::ostream& OutStream,
                                              gtirb::Addr EA) {
+  ++LinesPrinted;
+  if (Tokens)
+    Tokens->line(static_cast<uint64_t>(EA), CurrentBlock, LineContents.str());
   std::copy(std::istreambuf_iterator<char>(LineContents),
             std::istreambuf_iterator<char>(),
             std::ostream_iterator<char>(OutStream));
@@ -1191,7 +1790,8 @@ void PrettyPrinterBase::printCommentableLine(std::stringstream& LineContents,
   std::string Spaces(NumSpaces, ' ');
 
   OutStream << Spaces << syntax.comment();
-  OutStream << " EA: " << std::hex << EA << std::dec;
+  OutStream << " EA: ";
+  writeHex(OutStream, static_cast<uint64_t>(EA));
 }
 
 void PrettyPrinterBase::printCFIDirectives(std::ostream& os,
@@ -1201,6 +1801,16 @@ void PrettyPrinterBase::printCFIDirectives(std::ostream& os,
     return;
 
   if (auto CfiDirectives = aux_data::getCFIDirectives(offset, module)) {
+    // The directives are lines of the token stream at the address of the
+    // offset, so that symbol references are attributed to them.
+    gtirb::Addr EA{0};
+    if (Tokens) {
+      const auto* Block =
+          nodeFromUUID<gtirb::CodeBlock>(context, offset.ElementId);
+      if (Block && Block->getAddress()) {
+        EA = *Block->getAddress() + offset.Displacement;
+      }
+    }
     for (auto& CfiDirective : *CfiDirectives) {
       std::string Directive = CfiDirective.Directive;
 
@@ -1212,23 +1822,25 @@ void PrettyPrinterBase::printCFIDirectives(std::ostream& os,
         continue;
       }
 
-      os << Directive << " ";
+      std::stringstream DirectiveLine;
+      DirectiveLine << Directive << " ";
       const std::vector<int64_t>& Operands = CfiDirective.Operands;
       for (auto It = Operands.begin(); It != Operands.end(); It++) {
         if (It != Operands.begin())
-          os << ", ";
-        os << *It;
+          DirectiveLine << ", ";
+        DirectiveLine << *It;
       }
 
       gtirb::Symbol* Symbol =
           nodeFromUUID<gtirb::Symbol>(context, CfiDirective.Uuid);
       if (Symbol) {
         if (Operands.size() > 0)
-          os << ", ";
-        printSymbolReference(os, Symbol);
+          DirectiveLine << ", ";
+        printSymbolReference(DirectiveLine, Symbol);
       }
 
-      os << std::endl;
+      printCommentableLine(DirectiveLine, os, EA);
+      os << '\n';
 
       if (Directive == ".cfi_endproc") {
         CFIStartProc = std::nullopt;
@@ -1301,13 +1913,16 @@ void PrettyPrinterBase::printSymExprSuffix(
     bool /* IsNotBranch */) {}
 
 std::string PrettyPrinterBase::s_symaddr_0_warning(uint64_t symAddr) {
-  std::stringstream ss;
-  ss << "WARNING:0: no symbol for address 0x" << std::hex << symAddr << " ";
-  return ss.str();
+  std::string Warning{"WARNING:0: no symbol for address "};
+  appendHex(Warning, symAddr);
+  Warning += ' ';
+  return Warning;
 }
 
 void PrettyPrinterBase::printSymbolicExpression(
     std::ostream& os, const gtirb::SymAddrConst* sexpr, bool IsNotBranch) {
+  if (Stats)
+    Stats->add(Statistics::Counter::SymbolicExpressions);
   std::stringstream ss;
   bool skipped = printSymbolReference(ss, sexpr->Sym);
 
@@ -1326,6 +1941,8 @@ void PrettyPrinterBase::printSymbolicExpression(
 void PrettyPrinterBase::printSymbolicExpression(std::ostream& os,
                                                 const gtirb::SymAddrAddr* sexpr,
                                                 bool IsNotBranch) {
+  if (Stats)
+    Stats->add(Statistics::Counter::SymbolicExpressions);
   printSymExprPrefix(os, sexpr->Attributes, IsNotBranch);
 
   if (sexpr->Scale > 1) {
@@ -1362,8 +1979,9 @@ PrettyPrinterBase::getContainerFunctionName(gtirb::Addr Addr) const {
 
 const gtirb::Symbol*
 PrettyPrinterBase::getContainerFunctionSymbol(const gtirb::UUID& Uuid) const {
-  if (auto FunctionEntry = BlockToFunction.find(Uuid);
-      FunctionEntry != BlockToFunction.end()) {
+  if (auto FunctionEntry = functions().BlockToFunction.find(Uuid);
+      FunctionEntry != functions().BlockToFunction.end()) {
+    const auto& FunctionToSymbols = functions().FunctionToSymbols;
     if (auto FunctionNameEntry = FunctionToSymbols.find(FunctionEntry->second);
         FunctionNameEntry != FunctionToSymbols.end()) {
       return FunctionNameEntry->second;
@@ -1377,8 +1995,8 @@ bool PrettyPrinterBase::isFunctionSkipped(
   if (Policy.skipFunctions.count(FunctionSymbol.getName())) {
     return true;
   }
-  auto Aliases = FunctionAliases.find(&FunctionSymbol);
-  if (Aliases == FunctionAliases.end()) {
+  auto Aliases = functions().FunctionAliases.find(&FunctionSymbol);
+  if (Aliases == functions().FunctionAliases.end()) {
     return false;
   }
   for (const auto* Alias : Aliases->second) {
@@ -1487,12 +2105,13 @@ std::string PrettyPrinterBase::getRegisterName(unsigned int reg) const {
 void PrettyPrinterBase::printAddend(std::ostream& os, int64_t number,
                                     bool first) {
   if (number < 0 || first) {
-    os << number;
+    writeDecimal(os, number);
     return;
   }
   if (number == 0)
     return;
-  os << "+" << number;
+  os << '+';
+  writeDecimal(os, number);
 }
 
 template <typename BlockType>
@@ -1590,25 +2209,48 @@ PrettyPrinterBase::getSymbolName(const gtirb::Symbol& Symbol) const {
   }
 }
 
+std::string_view
+PrettyPrinterBase::getSymbolSpelling(const gtirb::Symbol& Symbol) const {
+  auto [It, Inserted] = SymbolSpellings.try_emplace(&Symbol);
+  if (Inserted) {
+    It->second = getSymbolName(Symbol);
+  }
+  return It->second;
+}
+
 std::optional<std::string>
 PrettyPrinterBase::getForwardedSymbolName(const gtirb::Symbol* Symbol) const {
   if (auto* Result = getForwardedSymbol(Symbol)) {
-    return getSymbolName(*Result);
+    return std::string(getSymbolSpelling(*Result));
   } else {
     return std::nullopt;
   }
 }
 
-gtirb::Symbol*
+const gtirb::Symbol*
 PrettyPrinterBase::getForwardedSymbol(const gtirb::Symbol* Symbol) const {
-  if (Symbol) {
-    if (auto Found = aux_data::getForwardedSymbol(Symbol)) {
-      return nodeFromUUID<gtirb::Symbol>(context, *Found);
-    }
+  if (!Symbol) {
+    return nullptr;
+  }
+  if (Symbol->getModule() == &module) {
+    return symbolForwarding().lookup(Symbol);
+  }
+  // Symbols of other modules are not in this module's table.
+  if (auto Found = aux_data::getForwardedSymbol(Symbol)) {
+    return nodeFromUUID<gtirb::Symbol>(context, *Found);
   }
   return nullptr;
 }
 
+const aux_data::SymbolForwardingTable&
+PrettyPrinterBase::symbolForwarding() const {
+  if (!Forwarding) {
+    Forwarding =
+        std::make_shared<aux_data::SymbolForwardingTable>(context, module);
+  }
+  return *Forwarding;
+}
+
 const gtirb::Symbol* PrettyPrinterBase::getBestSymbol(
     const std::set<const gtirb::Symbol*, CmpSymPtr>& Symbols) const {
   // Given a set of gtirb::Symbol* that has the same name associated with
@@ -1624,24 +2266,67 @@ const gtirb::Symbol* PrettyPrinterBase::getBestSymbol(
 
 void PrettyPrinterBase::printSection(std::ostream& os,
                                      const gtirb::Section& section) {
-  if (shouldSkip(policy, section)) {
+  SectionProgress Progress;
+  if (!beginSection(os, section, Progress)) {
     return;
   }
-  programCounter = gtirb::Addr{0};
+  for (const auto& Block : section.blocks()) {
+    printSectionBlock(os, section, Block, Progress);
+  }
+  endSection(os, section, Progress);
+}
 
-  printSectionHeader(os, section);
+bool PrettyPrinterBase::beginSection(std::ostream& os,
+                                     const gtirb::Section& section,
+                                     SectionProgress& Progress) {
+  if (shouldSkip(policy, section)) {
+    return false;
+  }
+  programCounter = gtirb::Addr{0};
+  // When only some blocks are printed, the header waits for the first of
+  // them, so that sections without any are left out.
+  if (!SelectedBlocks) {
+    Progress.Start = listingOffset(os);
+    printSectionHeader(os, section);
+    Progress.Printed = true;
+  }
+  return true;
+}
 
-  for (const auto& Block : section.blocks()) {
-    if (auto* CB = gtirb::dyn_cast<gtirb::CodeBlock>(&Block)) {
-      printBlock(os, *CB);
-    } else if (auto* DB = gtirb::dyn_cast<gtirb::DataBlock>(&Block)) {
-      printBlock(os, *DB);
-    } else {
-      assert(!"non block in block iterator!");
+void PrettyPrinterBase::printSectionBlock(std::ostream& os,
+                                          const gtirb::Section& section,
+                                          const gtirb::Node& Block,
+                                          SectionProgress& Progress) {
+  auto* CB = gtirb::dyn_cast<gtirb::CodeBlock>(&Block);
+  auto* DB = gtirb::dyn_cast<gtirb::DataBlock>(&Block);
+  assert((CB || DB) && "non block in block iterator!");
+  if (SelectedBlocks) {
+    gtirb::Addr Addr = CB ? *CB->getAddress() : *DB->getAddress();
+    uint64_t Size = CB ? CB->getSize() : DB->getSize();
+    if (!SelectedBlocks(Block, Addr, Size)) {
+      skipBlock(Block, Addr, Size);
+      return;
+    }
+    if (!Progress.Printed) {
+      Progress.Start = listingOffset(os);
+      printSectionHeader(os, section);
+      Progress.Printed = true;
     }
   }
+  if (CB) {
+    printBlock(os, *CB);
+  } else {
+    printBlock(os, *DB);
+  }
+}
 
-  printSectionFooter(os, section);
+void PrettyPrinterBase::endSection(std::ostream& os,
+                                   const gtirb::Section& section,
+                                   const SectionProgress& Progress) {
+  if (Progress.Printed) {
+    printSectionFooter(os, section);
+    indexSection(os, section, Progress.Start);
+  }
 }
 
 uint64_t PrettyPrinterBase::getSymbolicExpressionSize(
@@ -1651,8 +2336,12 @@ uint64_t PrettyPrinterBase::getSymbolicExpressionSize(
   if (auto Size = aux_data::getSymbolicExpressionSize(Off, module)) {
     return *Size;
   }
+  return inferSymbolicExpressionSize(SEE);
+}
 
-  // If not, it's the size of that largest data block at this address that is:
+uint64_t PrettyPrinterBase::inferSymbolicExpressionSize(
+    const gtirb::ByteInterval::ConstSymbolicExpressionElement& SEE) const {
+  // The size is that of the largest data block at this address that is:
   // (a) a power of 2
   // (b) a pointer-width or smaller
   const gtirb::DataBlock* LargestBlock = nullptr;
@@ -1739,6 +2428,56 @@ DynMode PrettyPrinter::getDynMode(const gtirb::Module& Module) const {
   }
 }
 
+std::shared_ptr<const std::string>
+PrettyPrinter::getVersionScript(const gtirb::Context& Context,
+                                const gtirb::Module& Module) const {
+  std::lock_guard<std::mutex> Lock(Caches->Mutex);
+  auto [It, Inserted] =
+      Caches->VersionScripts.try_emplace({&Context, Module.getUUID()});
+  if (Inserted) {
+    if (auto Script = buildVersionScript(Context, Module)) {
+      It->second = std::make_shared<const std::string>(std::move(*Script));
+    }
+  }
+  return It->second;
+}
+
+void PrettyPrinter::invalidateModuleCaches(const gtirb::Context& Context,
+                                           const gtirb::Module& Module) const {
+  std::lock_guard<std::mutex> Lock(Caches->Mutex);
+  Caches->VersionScripts.erase({&Context, Module.getUUID()});
+  Caches->SymbolForwardings.erase({&Context, Module.getUUID()});
+  Caches->AppliedFixups.erase({&Context, Module.getUUID()});
+}
+
+std::shared_ptr<const aux_data::SymbolForwardingTable>
+PrettyPrinter::getSymbolForwarding(const gtirb::Context& Context,
+                                   const gtirb::Module& Module) const {
+  std::lock_guard<std::mutex> Lock(Caches->Mutex);
+  auto [It, Inserted] =
+      Caches->SymbolForwardings.try_emplace({&Context, Module.getUUID()});
+  if (Inserted) {
+    It->second =
+        std::make_shared<aux_data::SymbolForwardingTable>(Context, Module);
+  }
+  return It->second;
+}
+
+bool PrettyPrinter::isFixupApplied(const gtirb::Context& Context,
+                                   const gtirb::Module& Module,
+                                   const std::string& Pass) const {
+  std::lock_guard<std::mutex> Lock(Caches->Mutex);
+  auto It = Caches->AppliedFixups.find({&Context, Module.getUUID()});
+  return It != Caches->AppliedFixups.end() && It->second.count(Pass);
+}
+
+void PrettyPrinter::setFixupApplied(const gtirb::Context& Context,
+                                    const gtirb::Module& Module,
+                                    const std::string& Pass) const {
+  std::lock_guard<std::mutex> Lock(Caches->Mutex);
+  Caches->AppliedFixups[{&Context, Module.getUUID()}].insert(Pass);
+}
+
 // This is to have a deterministic order in a set of gtirb::Symbol*:
 // std::set<const gtirb::Symbol*, CmpSymPtr>
 bool CmpSymPtr::operator()(const gtirb::Symbol* A,
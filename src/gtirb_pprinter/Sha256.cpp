@@ -0,0 +1,114 @@
+//===- Sha256.cpp -----------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "Sha256.hpp"
+
+#include <algorithm>
+
+namespace gtirb_pprint {
+
+static uint32_t rotr(uint32_t X, int N) { return (X >> N) | (X << (32 - N)); }
+
+void Sha256::update(const void* Data, size_t Size) {
+  const auto* Bytes = static_cast<const uint8_t*>(Data);
+  Length += Size;
+  while (Size > 0) {
+    size_t N = std::min(Size, Block.size() - Used);
+    std::copy(Bytes, Bytes + N, Block.begin() + Used);
+    Used += N;
+    Bytes += N;
+    Size -= N;
+    if (Used == Block.size()) {
+      compress();
+      Used = 0;
+    }
+  }
+}
+
+std::string Sha256::hexDigest() {
+  uint64_t Bits = Length * 8;
+  uint8_t Pad = 0x80;
+  update(&Pad, 1);
+  Pad = 0;
+  while (Used != 56) {
+    update(&Pad, 1);
+  }
+  for (int I = 7; I >= 0; --I) {
+    Block[Used++] = static_cast<uint8_t>(Bits >> (I * 8));
+  }
+  compress();
+
+  static const char Digits[] = "0123456789abcdef";
+  std::string Hex;
+  for (uint32_t Word : State) {
+    for (int I = 28; I >= 0; I -= 4) {
+      Hex += Digits[(Word >> I) & 0xf];
+    }
+  }
+  return Hex;
+}
+
+void Sha256::compress() {
+  static const uint32_t K[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b,
+      0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01,
+      0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7,
+      0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+      0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152,
+      0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+      0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+      0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+      0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819,
+      0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08,
+      0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f,
+      0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+      0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+  uint32_t W[64];
+  for (int I = 0; I < 16; ++I) {
+    W[I] = uint32_t(Block[I * 4]) << 24 | uint32_t(Block[I * 4 + 1]) << 16 |
+           uint32_t(Block[I * 4 + 2]) << 8 | uint32_t(Block[I * 4 + 3]);
+  }
+  for (int I = 16; I < 64; ++I) {
+    uint32_t S0 =
+        rotr(W[I - 15], 7) ^ rotr(W[I - 15], 18) ^ (W[I - 15] >> 3);
+    uint32_t S1 = rotr(W[I - 2], 17) ^ rotr(W[I - 2], 19) ^ (W[I - 2] >> 10);
+    W[I] = W[I - 16] + S0 + W[I - 7] + S1;
+  }
+  uint32_t A = State[0], B = State[1], C = State[2], D = State[3],
+           E = State[4], F = State[5], G = State[6], H = State[7];
+  for (int I = 0; I < 64; ++I) {
+    uint32_t S1 = rotr(E, 6) ^ rotr(E, 11) ^ rotr(E, 25);
+    uint32_t T1 = H + S1 + ((E & F) ^ (~E & G)) + K[I] + W[I];
+    uint32_t S0 = rotr(A, 2) ^ rotr(A, 13) ^ rotr(A, 22);
+    uint32_t T2 = S0 + ((A & B) ^ (A & C) ^ (B & C));
+    H = G;
+    G = F;
+    F = E;
+    E = D + T1;
+    D = C;
+    C = B;
+    B = A;
+    A = T1 + T2;
+  }
+  State[0] += A;
+  State[1] += B;
+  State[2] += C;
+  State[3] += D;
+  State[4] += E;
+  State[5] += F;
+  State[6] += G;
+  State[7] += H;
+}
+
+} // namespace gtirb_pprint
@@ -0,0 +1,125 @@
+//===- Statistics.cpp -------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "Statistics.hpp"
+#include <ostream>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace gtirb_pprint {
+
+namespace {
+const char* CounterNames[Statistics::NumCounters] = {
+    "instructions_decoded",
+    "data_lines",
+    "symbolic_expressions",
+    "bytes_written",
+    "object_cache_hits",
+    "object_cache_misses",
+};
+
+void writeJSONString(std::ostream& Stream, const std::string& S) {
+  static const char Digits[] = "0123456789abcdef";
+  Stream << '"';
+  for (char C : S) {
+    auto U = static_cast<unsigned char>(C);
+    if (C == '"' || C == '\\') {
+      Stream << '\\' << C;
+    } else if (U < 0x20) {
+      Stream << "\\u00" << Digits[U >> 4] << Digits[U & 0xf];
+    } else {
+      Stream << C;
+    }
+  }
+  Stream << '"';
+}
+
+/// CPU time used by the calling thread, in seconds.
+double threadCpuSeconds() {
+#if defined(_WIN32)
+  FILETIME Creation, Exit, Kernel, User;
+  if (!GetThreadTimes(GetCurrentThread(), &Creation, &Exit, &Kernel, &User))
+    return 0;
+  auto ticks = [](const FILETIME& T) {
+    return (static_cast<uint64_t>(T.dwHighDateTime) << 32) | T.dwLowDateTime;
+  };
+  // FILETIME counts 100ns intervals.
+  return static_cast<double>(ticks(Kernel) + ticks(User)) / 1e7;
+#else
+  timespec Time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Time) != 0)
+    return 0;
+  return static_cast<double>(Time.tv_sec) +
+         static_cast<double>(Time.tv_nsec) / 1e9;
+#endif
+}
+} // namespace
+
+Statistics::Timer::Timer(Statistics* S, std::string P)
+    : Stats(S), Phase(std::move(P)) {
+  if (Stats) {
+    Module = Stats->Module;
+    WallStart = std::chrono::steady_clock::now();
+    CpuStart = threadCpuSeconds();
+  }
+}
+
+Statistics::Timer::~Timer() {
+  if (!Stats)
+    return;
+  std::chrono::duration<double> Wall =
+      std::chrono::steady_clock::now() - WallStart;
+  double Cpu = threadCpuSeconds() - CpuStart;
+  std::lock_guard<std::mutex> Lock(Stats->PhasesMutex);
+  Stats->Phases.push_back({Phase, Module, Wall.count(), Cpu});
+}
+
+void Statistics::setModule(const std::string& Name) {
+  Module = Name;
+  CurrentCounts = &Counts[Name];
+}
+
+void Statistics::writeJSON(std::ostream& Stream) const {
+  Stream << "{\n  \"phases\": [";
+  for (size_t I = 0; I < Phases.size(); ++I) {
+    const PhaseRecord& P = Phases[I];
+    Stream << (I ? ",\n" : "\n") << "    {\"phase\": ";
+    writeJSONString(Stream, P.Name);
+    Stream << ", \"module\": ";
+    writeJSONString(Stream, P.Module);
+    Stream << ", \"wall_seconds\": " << P.WallSeconds
+           << ", \"cpu_seconds\": " << P.CpuSeconds << "}";
+  }
+  Stream << (Phases.empty() ? "],\n" : "\n  ],\n");
+
+  Stream << "  \"modules\": {";
+  bool First = true;
+  for (const auto& [Name, Values] : Counts) {
+    Stream << (First ? "\n" : ",\n") << "    ";
+    First = false;
+    writeJSONString(Stream, Name);
+    Stream << ": {";
+    for (size_t I = 0; I < NumCounters; ++I) {
+      Stream << (I ? ", " : "") << '"' << CounterNames[I]
+             << "\": " << Values[I].load(std::memory_order_relaxed);
+    }
+    Stream << "}";
+  }
+  Stream << "\n  }\n}\n";
+}
+
+} // namespace gtirb_pprint
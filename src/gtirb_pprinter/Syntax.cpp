@@ -16,11 +16,50 @@
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/range/algorithm/find_if.hpp>
+#include <array>
+#include <cstring>
 #include <map>
 #include <vector>
 
 namespace gtirb_pprint {
 
+namespace {
+// Bytes that Syntax::escapeByte does not print verbatim.
+constexpr std::array<bool, 256> makeEscapeTable() {
+  std::array<bool, 256> Table{};
+  for (uint8_t B : {'\\', '\"', '\n', '\t', '\b', '\f', '\r', '\a'})
+    Table[B] = true;
+  return Table;
+}
+constexpr std::array<bool, 256> NeedsEscape = makeEscapeTable();
+
+bool needsEscape(char C) { return NeedsEscape[static_cast<uint8_t>(C)]; }
+
+// Return the first byte in [It, End) that needs escaping, or End.
+//
+// Whole 8-byte words are screened at once: a word can only hold such a byte
+// if one of its bytes is below 0x0e or equal to '"' or '\\'. Only words that
+// pass the screen are searched byte by byte.
+const char* findEscape(const char* It, const char* End) {
+  constexpr uint64_t Ones = 0x0101010101010101;
+  constexpr uint64_t Highs = 0x8080808080808080;
+  auto HasLess = [&](uint64_t X, uint8_t N) {
+    return ((X - Ones * N) & ~X & Highs) != 0;
+  };
+  for (; End - It >= 8; It += 8) {
+    uint64_t Word;
+    std::memcpy(&Word, It, sizeof(Word));
+    if (HasLess(Word, 0x0e) || HasLess(Word ^ (Ones * '"'), 1) ||
+        HasLess(Word ^ (Ones * '\\'), 1)) {
+      const char* Found = std::find_if(It, It + 8, needsEscape);
+      if (Found != It + 8)
+        return Found;
+    }
+  }
+  return std::find_if(It, End, needsEscape);
+}
+} // namespace
+
 std::optional<std::string> Syntax::getSizeName(uint64_t bits) const {
   switch (bits) {
   case 256:
@@ -89,4 +128,17 @@ std::string Syntax::escapeByte(uint8_t b) const {
   }
 }
 
+void Syntax::escapeString(std::string& Buf, std::string_view Bytes) const {
+  const char* It = Bytes.data();
+  const char* End = It + Bytes.size();
+  while (It != End) {
+    const char* Special = findEscape(It, End);
+    Buf.append(It, Special);
+    if (Special == End)
+      break;
+    Buf += escapeByte(static_cast<uint8_t>(*Special));
+    It = Special + 1;
+  }
+}
+
 } // namespace gtirb_pprint
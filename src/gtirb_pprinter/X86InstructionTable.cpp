@@ -0,0 +1,99 @@
+//===- X86InstructionTable.cpp ----------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "X86InstructionTable.hpp"
+
+#include <cstring>
+
+namespace gtirb_pprint {
+namespace x86 {
+
+void fixupInstruction(cs_insn& Insn) {
+  uint16_t Flags = getInsnFlags(Insn.id);
+  if ((Flags & FixupFlags) == 0) {
+    return;
+  }
+  cs_x86& Detail = Insn.detail->x86;
+
+  // Operands are implicit for various MOVS* instructions. But there is also
+  // an SSE2 instruction named MOVSD which has explicit operands.
+  if ((Flags & ImplicitStringOperands) &&
+      Insn.detail->groups[0] != X86_GRP_SSE2) {
+    Detail.op_count = 0;
+  }
+
+  // Register operands are implicit for STOS* instructions.
+  if (Flags & ImplicitStoreRegister) {
+    Detail.op_count = 1;
+  }
+
+  // IMUL: third operand is a signed number, but it is decoded as unsigned.
+  if ((Flags & SignedThirdImmediate) && Detail.op_count == 3) {
+    cs_x86_op& Op = Detail.operands[2];
+    Op.imm = static_cast<int32_t>(Op.imm);
+  }
+
+  // The first operand of fxch  st(0) is implicit
+  if ((Flags & ImplicitFirstStackRegister) && Detail.op_count == 2) {
+    Detail.operands[0] = Detail.operands[1];
+    Detail.op_count = 1;
+  }
+
+  // Comisd loads 64 bits from memory not 128
+  if ((Flags & Mem64Operand) && Detail.op_count == 2 &&
+      Detail.operands[1].type == X86_OP_MEM && Detail.operands[1].size == 16) {
+    Detail.operands[1].size = 8;
+  }
+
+  // Comiss loads 32 bits from memory not 64
+  if ((Flags & Mem32Operand) && Detail.op_count == 2 &&
+      Detail.operands[1].type == X86_OP_MEM) {
+    Detail.operands[1].size = 4;
+  }
+
+  // PUNPCKL* memory operands are 32 bits
+  if ((Flags & Mem32PackedOperand) && Detail.op_count == 2 &&
+      Detail.operands[1].type == X86_OP_MEM && Detail.operands[1].size == 8) {
+    Detail.operands[1].size = 4;
+  }
+
+  // Operands that should not have a size annotation:
+  // FXSAVE, XSAVE, XSAVEC, FXRSTOR, XRSTOR
+  if ((Flags & UnsizedOperand) && Detail.op_count == 1) {
+    Detail.operands[0].size = 0;
+  }
+
+  if (Flags & RewriteMnemonic) {
+    switch (Insn.id) {
+    // RDRAND and RDSEED should be printed with no suffix:
+    // https://github.com/aquynh/capstone/issues/1603
+    case X86_INS_RDRAND:
+      strcpy(Insn.mnemonic, "rdrand");
+      break;
+    case X86_INS_RDSEED:
+      strcpy(Insn.mnemonic, "rdseed");
+      break;
+    case X86_INS_INT1:
+    case X86_INS_INT3:
+      Detail.operands[0].type = X86_OP_IMM;
+      Detail.operands[0].imm = (Insn.id == X86_INS_INT1 ? 1 : 3);
+      Detail.op_count = 1;
+      strcpy(Insn.mnemonic, "int");
+      break;
+    }
+  }
+}
+
+} // namespace x86
+} // namespace gtirb_pprint
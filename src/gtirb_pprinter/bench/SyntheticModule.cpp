@@ -0,0 +1,273 @@
+//===- SyntheticModule.cpp --------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "SyntheticModule.hpp"
+
+#include <gtirb_pprinter/AuxDataSchema.hpp>
+
+#include <random>
+#include <set>
+#include <vector>
+
+namespace gtirb_bench {
+
+namespace {
+// Instruction encodings. The 32-bit operand of lea and call is left zero:
+// the printer prints the symbolic expression that covers it instead.
+const uint8_t MovRaxRbx[] = {0x48, 0x89, 0xc3};          // mov %rax,%rbx
+const uint8_t AddRax1[] = {0x48, 0x83, 0xc0, 0x01};      // add $1,%rax
+const uint8_t LeaRipRax[] = {0x48, 0x8d, 0x05, 0, 0, 0, 0}; // lea X(%rip)
+const uint8_t Call[] = {0xe8, 0, 0, 0, 0};                  // call X
+const uint8_t Ret[] = {0xc3};
+
+enum class RefKind { Function, Table, String };
+
+struct Reference {
+  uint64_t Offset;
+  RefKind Kind;
+  size_t Target;
+};
+
+struct BlockExtent {
+  uint64_t Offset;
+  uint64_t Size;
+};
+
+template <size_t N>
+uint64_t append(std::vector<uint8_t>& Bytes, const uint8_t (&Insn)[N]) {
+  uint64_t Offset = Bytes.size();
+  Bytes.insert(Bytes.end(), Insn, Insn + N);
+  return Offset;
+}
+
+uint64_t alignTo(uint64_t Value, uint64_t Alignment) {
+  return (Value + Alignment - 1) / Alignment * Alignment;
+}
+
+gtirb::ByteInterval& addSection(gtirb::Context& Context, gtirb::Module& Module,
+                                const std::string& Name, uint64_t Address,
+                                const std::vector<uint8_t>& Bytes,
+                                bool Executable, bool Writable) {
+  gtirb::Section* Section = Module.addSection(Context, Name);
+  Section->addFlag(gtirb::SectionFlag::Readable);
+  Section->addFlag(gtirb::SectionFlag::Loaded);
+  Section->addFlag(gtirb::SectionFlag::Initialized);
+  if (Executable)
+    Section->addFlag(gtirb::SectionFlag::Executable);
+  if (Writable)
+    Section->addFlag(gtirb::SectionFlag::Writable);
+  return *Section->addByteInterval(Context, gtirb::Addr(Address),
+                                   Bytes.begin(), Bytes.end());
+}
+} // namespace
+
+gtirb::Module& generateSyntheticModule(gtirb::Context& Context,
+                                       const SyntheticModuleOptions& Options) {
+  std::mt19937 Random(Options.Seed);
+  std::uniform_real_distribution<double> Uniform(0.0, 1.0);
+  auto Pick = [&](size_t N) {
+    return std::uniform_int_distribution<size_t>(0, N - 1)(Random);
+  };
+  bool Elf = Options.Format == gtirb::FileFormat::ELF;
+
+  gtirb::IR* IR = gtirb::IR::Create(Context);
+  gtirb::Module& Module = *IR->addModule(Context, "synthetic");
+  Module.setFileFormat(Options.Format);
+  Module.setISA(Options.ISA);
+  Module.setByteOrder(gtirb::ByteOrder::Little);
+
+  // Code: every function is a run of fall-through blocks ending in ret.
+  std::vector<uint8_t> Code;
+  std::vector<std::vector<BlockExtent>> FunctionBlocks(Options.Functions);
+  std::vector<Reference> CodeRefs;
+  std::vector<std::pair<uint64_t, uint64_t>> Comments; // {Block, Offset}
+  std::vector<BlockExtent> AllBlocks;
+  size_t InsnCount = 0;
+  for (size_t F = 0; F < Options.Functions; ++F) {
+    for (size_t B = 0; B < Options.BlocksPerFunction; ++B) {
+      uint64_t Start = Code.size();
+      for (size_t I = 0; I < Options.InstructionsPerBlock; ++I) {
+        uint64_t Offset;
+        if (Uniform(Random) < Options.SymbolicDensity) {
+          if (Random() % 2 && Options.Functions > 0) {
+            Offset = append(Code, Call);
+            CodeRefs.push_back(
+                {Offset + 1, RefKind::Function, Pick(Options.Functions)});
+          } else {
+            Offset = append(Code, LeaRipRax);
+            if (Options.DataTables && (Random() % 2 || !Options.Strings))
+              CodeRefs.push_back(
+                  {Offset + 3, RefKind::Table, Pick(Options.DataTables)});
+            else if (Options.Strings)
+              CodeRefs.push_back(
+                  {Offset + 3, RefKind::String, Pick(Options.Strings)});
+          }
+        } else {
+          Offset = I % 2 ? append(Code, AddRax1) : append(Code, MovRaxRbx);
+        }
+        if (Options.CommentEvery && ++InsnCount % Options.CommentEvery == 0)
+          Comments.emplace_back(AllBlocks.size(), Offset - Start);
+      }
+      if (B + 1 == Options.BlocksPerFunction)
+        append(Code, Ret);
+      FunctionBlocks[F].push_back({Start, Code.size() - Start});
+      AllBlocks.push_back({Start, Code.size() - Start});
+    }
+  }
+
+  // Data: zero-initialized pointer tables, filled in with symbolic
+  // expressions below, and a pool of strings.
+  std::vector<uint8_t> Tables(Options.DataTables * Options.TableEntries * 8);
+  std::vector<uint8_t> Strings;
+  std::vector<BlockExtent> StringBlocks;
+  for (size_t S = 0; S < Options.Strings; ++S) {
+    std::string Text = "synthetic string " + std::to_string(S);
+    Text.append(Pick(24), 'a' + static_cast<char>(S % 26));
+    StringBlocks.push_back({Strings.size(), Text.size() + 1});
+    Strings.insert(Strings.end(), Text.begin(), Text.end());
+    Strings.push_back(0);
+  }
+
+  uint64_t TextAddr = 0x401000;
+  uint64_t DataAddr = alignTo(TextAddr + Code.size(), 0x1000);
+  uint64_t RodataAddr = alignTo(DataAddr + Tables.size(), 0x1000);
+
+  gtirb::ByteInterval& Text = addSection(Context, Module, ".text", TextAddr,
+                                         Code, true, false);
+  gtirb::ByteInterval& Data = addSection(Context, Module, ".data", DataAddr,
+                                         Tables, false, true);
+  gtirb::ByteInterval& Rodata =
+      addSection(Context, Module, Elf ? ".rodata" : ".rdata", RodataAddr,
+                 Strings, false, false);
+
+  gtirb::schema::FunctionEntries::Type FunctionEntries;
+  gtirb::schema::FunctionBlocks::Type FunctionBlocksAux;
+  gtirb::schema::FunctionNames::Type FunctionNames;
+  gtirb::schema::ElfSymbolInfo::Type SymbolInfo;
+  gtirb::schema::Encodings::Type Encodings;
+  gtirb::schema::CfiDirectives::Type CFI;
+  gtirb::schema::Comments::Type CommentsAux;
+  gtirb::schema::SymbolicExpressionSizes::Type Sizes;
+
+  auto AddSymbolInfo = [&](const gtirb::Symbol& Symbol, uint64_t Size,
+                           const char* Type, const char* Binding) {
+    if (Elf)
+      SymbolInfo[Symbol.getUUID()] = {Size, Type, Binding, "DEFAULT", 0};
+  };
+
+  std::vector<gtirb::CodeBlock*> CodeBlocks;
+  for (const auto& Extent : AllBlocks)
+    CodeBlocks.push_back(
+        Text.addBlock<gtirb::CodeBlock>(Context, Extent.Offset, Extent.Size));
+
+  std::vector<gtirb::Symbol*> FunctionSymbols;
+  size_t BlockIndex = 0;
+  for (size_t F = 0; F < Options.Functions; ++F) {
+    gtirb::CodeBlock* Entry = CodeBlocks[BlockIndex];
+    gtirb::Symbol* Symbol =
+        Module.addSymbol(Context, Entry, "fun_" + std::to_string(F));
+    FunctionSymbols.push_back(Symbol);
+    uint64_t Size = 0;
+    std::set<gtirb::UUID> Blocks;
+    for (size_t B = 0; B < FunctionBlocks[F].size(); ++B) {
+      Blocks.insert(CodeBlocks[BlockIndex + B]->getUUID());
+      Size += FunctionBlocks[F][B].Size;
+    }
+    gtirb::UUID FunctionId = Entry->getUUID();
+    FunctionEntries[FunctionId] = {Entry->getUUID()};
+    FunctionBlocksAux[FunctionId] = std::move(Blocks);
+    FunctionNames[FunctionId] = Symbol->getUUID();
+    AddSymbolInfo(*Symbol, Size, "FUNC", "GLOBAL");
+
+    if (Options.CFI) {
+      gtirb::CodeBlock* Last =
+          CodeBlocks[BlockIndex + FunctionBlocks[F].size() - 1];
+      CFI[gtirb::Offset(Entry->getUUID(), 0)].push_back(
+          {".cfi_startproc", {}, gtirb::UUID()});
+      CFI[gtirb::Offset(Last->getUUID(), Last->getSize())].push_back(
+          {".cfi_endproc", {}, gtirb::UUID()});
+    }
+    BlockIndex += FunctionBlocks[F].size();
+  }
+
+  for (const auto& [Block, Offset] : Comments)
+    CommentsAux[gtirb::Offset(CodeBlocks[Block]->getUUID(), Offset)] =
+        "synthetic comment";
+
+  std::vector<gtirb::Symbol*> TableSymbols;
+  uint64_t TableSize = Options.TableEntries * 8;
+  for (size_t T = 0; T < Options.DataTables; ++T) {
+    auto* Block =
+        Data.addBlock<gtirb::DataBlock>(Context, T * TableSize, TableSize);
+    gtirb::Symbol* Symbol =
+        Module.addSymbol(Context, Block, "table_" + std::to_string(T));
+    TableSymbols.push_back(Symbol);
+    AddSymbolInfo(*Symbol, TableSize, "OBJECT", "GLOBAL");
+    for (size_t E = 0; E < Options.TableEntries && Options.Functions; ++E) {
+      if (Uniform(Random) >= Options.SymbolicDensity)
+        continue;
+      uint64_t Offset = T * TableSize + E * 8;
+      Data.addSymbolicExpression(
+          Offset, gtirb::SymAddrConst{
+                      0, FunctionSymbols[Pick(Options.Functions)], {}});
+      Sizes[gtirb::Offset(Data.getUUID(), Offset)] = 8;
+    }
+  }
+
+  std::vector<gtirb::Symbol*> StringSymbols;
+  for (size_t S = 0; S < Options.Strings; ++S) {
+    auto* Block = Rodata.addBlock<gtirb::DataBlock>(
+        Context, StringBlocks[S].Offset, StringBlocks[S].Size);
+    Encodings[Block->getUUID()] = "string";
+    std::string Name =
+        Options.AmbiguousEvery && S % Options.AmbiguousEvery == 0
+            ? std::string("str_shared")
+            : "str_" + std::to_string(S);
+    gtirb::Symbol* Symbol = Module.addSymbol(Context, Block, Name);
+    StringSymbols.push_back(Symbol);
+    AddSymbolInfo(*Symbol, StringBlocks[S].Size, "OBJECT", "LOCAL");
+  }
+
+  for (const auto& Ref : CodeRefs) {
+    gtirb::Symbol* Target = Ref.Kind == RefKind::Function
+                                ? FunctionSymbols[Ref.Target]
+                            : Ref.Kind == RefKind::Table
+                                ? TableSymbols[Ref.Target]
+                                : StringSymbols[Ref.Target];
+    Text.addSymbolicExpression(Ref.Offset,
+                               gtirb::SymAddrConst{0, Target, {}});
+  }
+
+  Module.addAuxData<gtirb::schema::FunctionEntries>(std::move(FunctionEntries));
+  Module.addAuxData<gtirb::schema::FunctionBlocks>(
+      std::move(FunctionBlocksAux));
+  Module.addAuxData<gtirb::schema::FunctionNames>(std::move(FunctionNames));
+  Module.addAuxData<gtirb::schema::Encodings>(std::move(Encodings));
+  Module.addAuxData<gtirb::schema::CfiDirectives>(std::move(CFI));
+  Module.addAuxData<gtirb::schema::Comments>(std::move(CommentsAux));
+  Module.addAuxData<gtirb::schema::SymbolicExpressionSizes>(std::move(Sizes));
+  if (Elf) {
+    Module.addAuxData<gtirb::schema::ElfSymbolInfo>(std::move(SymbolInfo));
+    // SHT_PROGBITS with SHF_ALLOC and SHF_EXECINSTR or SHF_WRITE.
+    gtirb::schema::SectionProperties::Type Properties;
+    Properties[Text.getSection()->getUUID()] = {1, 0x6};
+    Properties[Data.getSection()->getUUID()] = {1, 0x3};
+    Properties[Rodata.getSection()->getUUID()] = {1, 0x2};
+    Module.addAuxData<gtirb::schema::SectionProperties>(std::move(Properties));
+    Module.addAuxData<gtirb::schema::BinaryType>({"DYN"});
+  }
+  return Module;
+}
+
+} // namespace gtirb_bench
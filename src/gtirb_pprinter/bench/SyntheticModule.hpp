@@ -0,0 +1,66 @@
+//===- SyntheticModule.hpp --------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+//
+// Deterministic generator of large x86-64 modules for the benchmarks.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GTIRB_PP_BENCH_SYNTHETIC_MODULE_H
+#define GTIRB_PP_BENCH_SYNTHETIC_MODULE_H
+
+#include <gtirb/gtirb.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace gtirb_bench {
+
+struct SyntheticModuleOptions {
+  /// ELF or PE; the section names and AuxData follow the format.
+  gtirb::FileFormat Format = gtirb::FileFormat::ELF;
+  /// The code is x86-64 whatever the ISA of the module is, which is enough
+  /// for the phases that do not decode it.
+  gtirb::ISA ISA = gtirb::ISA::X64;
+  uint32_t Seed = 1;
+
+  size_t Functions = 2000;
+  size_t BlocksPerFunction = 8;
+  size_t InstructionsPerBlock = 6;
+
+  /// Pointer tables in the data section.
+  size_t DataTables = 200;
+  size_t TableEntries = 32;
+
+  /// Strings in the read-only data section.
+  size_t Strings = 2000;
+
+  /// Fraction of instructions and table entries that refer to a symbol.
+  double SymbolicDensity = 0.3;
+  /// One in this many string symbols shares its name with the others, so
+  /// that ambiguous symbol names have to be resolved. Zero disables it.
+  size_t AmbiguousEvery = 16;
+
+  /// Emit .cfi_startproc/.cfi_endproc around every function.
+  bool CFI = true;
+  /// Attach a comment to one in this many instructions. Zero disables it.
+  size_t CommentEvery = 8;
+};
+
+/// Add a synthetic module built from Options to a new IR in Context.
+gtirb::Module& generateSyntheticModule(gtirb::Context& Context,
+                                       const SyntheticModuleOptions& Options);
+
+} // namespace gtirb_bench
+
+#endif /* GTIRB_PP_BENCH_SYNTHETIC_MODULE_H */
@@ -0,0 +1,284 @@
+//===- gtirb_pprinter_bench.cpp ---------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+//
+// Benchmark of the printer phases on synthetic modules, using Google
+// Benchmark.
+//
+// A large module is generated deterministically (see SyntheticModule.hpp)
+// for each file format and ISA of the registered targets, on first use. For
+// every registered target whose file format the generator supports (ELF and
+// PE), each phase of printing is measured on its own:
+//
+//   create                constructing the printer
+//   function-information  computing the function information
+//   ambiguous-symbols     computing the names of ambiguous symbols
+//   data-blocks           printBlockContents of every data block
+//   data                  printing the data sections, as a listing does
+//
+// The generator emits x86-64 code only, so the phases that decode it are
+// measured for x86-64 targets only:
+//
+//   code-blocks           printBlockContents of every code block
+//   code                  printing .text, as a listing does
+//
+// Per file format the module-rewriting passes are measured as well, each on
+// a freshly generated x86-64 module: layout and, for ELF,
+// fixup-shared-object. The listings are discarded; the printing cases
+// report the bytes printed per second.
+//
+// Usage: gtirb_pprinter_bench [--seed=N] [--functions=N] [--blocks=N]
+//                             [--instructions=N] [--tables=N] [--strings=N]
+//                             [--density=X] [--benchmark_...]
+//===----------------------------------------------------------------------===//
+#include "SyntheticModule.hpp"
+
+#include <benchmark/benchmark.h>
+#include <gtirb_layout/gtirb_layout.hpp>
+#include <gtirb_pprinter/Fixup.hpp>
+#include <gtirb_pprinter/PrettyPrinter.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+
+using namespace gtirb_bench;
+
+namespace {
+struct CountingBuffer : std::streambuf {
+  int64_t Count = 0;
+  int overflow(int C) override {
+    ++Count;
+    return C;
+  }
+  std::streamsize xsputn(const char*, std::streamsize N) override {
+    Count += N;
+    return N;
+  }
+};
+
+// A synthetic module and the address ranges of its code and data sections.
+struct Subject {
+  gtirb::Context Context;
+  gtirb::Module* Module = nullptr;
+  gtirb::Addr TextBegin{0}, TextEnd{0}, DataBegin{0}, DataEnd{0};
+};
+
+SyntheticModuleOptions Options;
+
+std::optional<gtirb::FileFormat> fileFormat(const std::string& Name) {
+  if (Name == "elf")
+    return gtirb::FileFormat::ELF;
+  if (Name == "pe")
+    return gtirb::FileFormat::PE;
+  return std::nullopt;
+}
+
+std::optional<gtirb::ISA> isa(const std::string& Name) {
+  static const std::map<std::string, gtirb::ISA> ISAs = {
+      {"x86", gtirb::ISA::IA32},     {"x64", gtirb::ISA::X64},
+      {"arm", gtirb::ISA::ARM},      {"arm64", gtirb::ISA::ARM64},
+      {"mips32", gtirb::ISA::MIPS32}};
+  auto It = ISAs.find(Name);
+  if (It == ISAs.end())
+    return std::nullopt;
+  return It->second;
+}
+
+// The module generated for a file format and ISA, kept for all the
+// benchmarks that print it.
+Subject& subject(gtirb::FileFormat Format, gtirb::ISA ISA) {
+  static std::map<std::pair<gtirb::FileFormat, gtirb::ISA>,
+                  std::unique_ptr<Subject>>
+      Subjects;
+  auto& S = Subjects[{Format, ISA}];
+  if (S)
+    return *S;
+  S = std::make_unique<Subject>();
+  SyntheticModuleOptions ModuleOptions = Options;
+  ModuleOptions.Format = Format;
+  ModuleOptions.ISA = ISA;
+  S->Module = &generateSyntheticModule(S->Context, ModuleOptions);
+  for (const auto& Section : S->Module->sections()) {
+    auto Range = std::make_pair(*Section.getAddress(),
+                                *Section.getAddress() + *Section.getSize());
+    if (Section.getName() == ".text") {
+      std::tie(S->TextBegin, S->TextEnd) = Range;
+    } else if (S->DataBegin == S->DataEnd) {
+      std::tie(S->DataBegin, S->DataEnd) = Range;
+    } else {
+      S->DataBegin = std::min(S->DataBegin, Range.first);
+      S->DataEnd = std::max(S->DataEnd, Range.second);
+    }
+  }
+  return *S;
+}
+
+using Target = std::tuple<std::string, std::string, std::string>;
+
+void registerTarget(const Target& T, gtirb::FileFormat Format,
+                    gtirb::ISA ISA) {
+  std::string Prefix = std::get<0>(T) + "/" + std::get<1>(T) + "/" +
+                       std::get<2>(T) + "/";
+  auto Register = [&](const std::string& Phase, auto Run) {
+    benchmark::RegisterBenchmark(
+        (Prefix + Phase).c_str(), [=](benchmark::State& State) {
+          Subject& S = subject(Format, ISA);
+          gtirb_pprint::PrettyPrinter Printer;
+          Printer.setTarget(T);
+          Run(State, S, Printer);
+        });
+  };
+  // Print with Print(Printer, Stream) on every iteration, and report the
+  // bytes printed.
+  auto Printing = [&](const std::string& Phase, auto Print) {
+    Register(Phase, [Print](benchmark::State& State, Subject& S,
+                            gtirb_pprint::PrettyPrinter& Printer) {
+      auto P = Printer.createPrinter(S.Context, *S.Module);
+      CountingBuffer Buffer;
+      std::ostream Null(&Buffer);
+      for (auto _ : State)
+        Print(*P, S, Null);
+      State.SetBytesProcessed(Buffer.Count);
+    });
+  };
+
+  Register("create", [](benchmark::State& State, Subject& S,
+                        gtirb_pprint::PrettyPrinter& Printer) {
+    for (auto _ : State)
+      benchmark::DoNotOptimize(Printer.createPrinter(S.Context, *S.Module));
+  });
+  Register("function-information",
+           [](benchmark::State& State, Subject& S,
+              gtirb_pprint::PrettyPrinter& Printer) {
+             std::unique_ptr<gtirb_pprint::PrettyPrinterBase> P;
+             for (auto _ : State) {
+               // Printers compute their function information once.
+               State.PauseTiming();
+               P = Printer.createPrinter(S.Context, *S.Module);
+               State.ResumeTiming();
+               benchmark::DoNotOptimize(P->functionInformation());
+             }
+           });
+  Register("ambiguous-symbols", [](benchmark::State& State, Subject& S,
+                                   gtirb_pprint::PrettyPrinter& Printer) {
+    auto P = Printer.createPrinter(S.Context, *S.Module);
+    for (auto _ : State)
+      benchmark::DoNotOptimize(&P->listingNames());
+  });
+  Printing("data-blocks", [](auto& P, Subject& S, std::ostream& OS) {
+    for (const auto& Block : S.Module->data_blocks())
+      P.printContents(OS, Block);
+  });
+  Printing("data", [](auto& P, Subject& S, std::ostream& OS) {
+    P.printRange(OS, S.DataBegin, S.DataEnd);
+  });
+  if (ISA == gtirb::ISA::X64) {
+    Printing("code-blocks", [](auto& P, Subject& S, std::ostream& OS) {
+      for (const auto& Block : S.Module->code_blocks())
+        P.printContents(OS, Block);
+    });
+    Printing("code", [](auto& P, Subject& S, std::ostream& OS) {
+      P.printRange(OS, S.TextBegin, S.TextEnd);
+    });
+  }
+}
+
+// Measure Pass on a freshly generated x86-64 module of the given format.
+template <typename Pass>
+void registerPass(const std::string& Name, gtirb::FileFormat Format,
+                  Pass Run) {
+  benchmark::RegisterBenchmark(Name.c_str(), [=](benchmark::State& State) {
+    SyntheticModuleOptions ModuleOptions = Options;
+    ModuleOptions.Format = Format;
+    std::unique_ptr<gtirb::Context> Context;
+    for (auto _ : State) {
+      State.PauseTiming();
+      Context = std::make_unique<gtirb::Context>();
+      gtirb::Module& Module = generateSyntheticModule(*Context, ModuleOptions);
+      State.ResumeTiming();
+      Run(*Context, Module);
+    }
+  });
+}
+
+bool parseOption(const char* Arg) {
+  const char* Eq = std::strchr(Arg, '=');
+  if (!Eq || std::strncmp(Arg, "--", 2) != 0)
+    return false;
+  std::string Name(Arg + 2, Eq);
+  const char* Value = Eq + 1;
+  if (Name == "seed")
+    Options.Seed = std::stoul(Value);
+  else if (Name == "functions")
+    Options.Functions = std::stoul(Value);
+  else if (Name == "blocks")
+    Options.BlocksPerFunction = std::stoul(Value);
+  else if (Name == "instructions")
+    Options.InstructionsPerBlock = std::stoul(Value);
+  else if (Name == "tables")
+    Options.DataTables = std::stoul(Value);
+  else if (Name == "strings")
+    Options.Strings = std::stoul(Value);
+  else if (Name == "density")
+    Options.SymbolicDensity = std::stod(Value);
+  else
+    return false;
+  return true;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  // Google Benchmark takes its own options out of argv.
+  benchmark::Initialize(&argc, argv);
+  for (int I = 1; I < argc; ++I) {
+    if (!parseOption(argv[I])) {
+      std::cerr << "unknown argument: " << argv[I] << "\n";
+      return 1;
+    }
+  }
+
+  gtirb_layout::registerAuxDataTypes();
+  gtirb_pprint::registerAuxDataTypes();
+  gtirb_pprint::registerPrettyPrinters();
+
+  for (const auto& T : gtirb_pprint::getRegisteredTargets()) {
+    auto Format = fileFormat(std::get<0>(T));
+    auto ISA = isa(std::get<1>(T));
+    if (Format && ISA)
+      registerTarget(T, *Format, *ISA);
+  }
+  registerPass("elf/x64/layout", gtirb::FileFormat::ELF,
+               [](gtirb::Context& Context, gtirb::Module& Module) {
+                 gtirb_layout::layoutModule(Context, Module);
+               });
+  registerPass("elf/x64/fixup-shared-object", gtirb::FileFormat::ELF,
+               [](gtirb::Context& Context, gtirb::Module& Module) {
+                 gtirb_pprint::fixupSharedObject(Context, Module);
+               });
+  registerPass("pe/x64/layout", gtirb::FileFormat::PE,
+               [](gtirb::Context& Context, gtirb::Module& Module) {
+                 gtirb_layout::layoutModule(Context, Module);
+               });
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,426 @@
+//===- perf_compare.cpp -----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+//
+// Compares the performance of the pretty printer against a baseline taken
+// earlier on the same machine, e.g. before and after a change. Throughput
+// and RSS depend on the machine, so no baseline is checked in and the tool
+// is not run by ctest: record one with --update first.
+//
+// A fixed set of synthetic modules (see SyntheticModule.hpp), and any GTIRB
+// files given with --ir, are printed with every registered target that
+// matches their format and ISA. Each case runs in its own child process,
+// which generates or loads only its own module, so the peak resident set
+// size reported for the case is not inflated by the cases before it. The
+// throughput (bytes of assembly per second, best of the rounds) and the
+// peak RSS are compared against a baseline file, one case per line:
+//
+//   <case> <bytes per second> <peak RSS in KiB>
+//
+// A case fails if its throughput drops, or its peak RSS grows, by more than
+// the tolerance, and the check fails if a measured case is missing from the
+// baseline or a baseline case was not measured. --update rewrites the
+// baseline with the measured values. Where processes cannot be forked the
+// cases run in-process and the RSS check is skipped.
+//
+// Usage: gtirb_pprinter_perf_compare --baseline=FILE [--update] [--rounds=N]
+//                                    [--tolerance=X] [--ir=FILE]...
+//===----------------------------------------------------------------------===//
+#include "SyntheticModule.hpp"
+
+#include <gtirb_layout/gtirb_layout.hpp>
+#include <gtirb_pprinter/PrettyPrinter.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace gtirb_bench;
+
+namespace {
+struct CountingBuffer : std::streambuf {
+  uint64_t Count = 0;
+  int overflow(int C) override {
+    ++Count;
+    return C;
+  }
+  std::streamsize xsputn(const char*, std::streamsize N) override {
+    Count += N;
+    return N;
+  }
+};
+
+struct Measurement {
+  double BytesPerSecond = 0;
+  uint64_t PeakRSS = 0;
+};
+
+// Output of a task run by runIsolated, and the peak resident set size of
+// the process that ran it in KiB, or 0 if unknown.
+struct IsolatedResult {
+  std::string Output;
+  uint64_t PeakRSS = 0;
+};
+
+// Run Task in a child process, so that its peak RSS is its own rather than
+// the high-water mark of everything the tool did before. Where processes
+// cannot be forked the task runs in-process and no RSS is reported.
+std::optional<IsolatedResult>
+runIsolated(const std::function<std::string()>& Task) {
+#if defined(__unix__) || defined(__APPLE__)
+  std::cout.flush();
+  int Pipe[2];
+  if (pipe(Pipe) != 0)
+    return std::nullopt;
+  pid_t Pid = fork();
+  if (Pid < 0) {
+    close(Pipe[0]);
+    close(Pipe[1]);
+    return std::nullopt;
+  }
+  if (Pid == 0) {
+    close(Pipe[0]);
+    std::string Output;
+    try {
+      Output = Task();
+    } catch (const std::exception& E) {
+      std::cerr << E.what() << "\n";
+      _exit(1);
+    }
+    const char* Data = Output.data();
+    size_t Left = Output.size();
+    while (Left > 0) {
+      ssize_t N = write(Pipe[1], Data, Left);
+      if (N < 0 && errno == EINTR)
+        continue;
+      if (N <= 0)
+        _exit(1);
+      Data += N;
+      Left -= N;
+    }
+    _exit(0);
+  }
+  close(Pipe[1]);
+  IsolatedResult Result;
+  char Buffer[4096];
+  for (;;) {
+    ssize_t N = read(Pipe[0], Buffer, sizeof(Buffer));
+    if (N < 0 && errno == EINTR)
+      continue;
+    if (N <= 0)
+      break;
+    Result.Output.append(Buffer, N);
+  }
+  close(Pipe[0]);
+  int Status = 0;
+  rusage Usage;
+  pid_t Waited;
+  do
+    Waited = wait4(Pid, &Status, 0, &Usage);
+  while (Waited < 0 && errno == EINTR);
+  if (Waited != Pid || !WIFEXITED(Status) || WEXITSTATUS(Status) != 0)
+    return std::nullopt;
+#if defined(__APPLE__)
+  Result.PeakRSS = Usage.ru_maxrss / 1024;
+#else
+  Result.PeakRSS = Usage.ru_maxrss;
+#endif
+  return Result;
+#else
+  return IsolatedResult{Task(), 0};
+#endif
+}
+
+std::map<std::string, Measurement> readBaseline(std::istream& In) {
+  std::map<std::string, Measurement> Baseline;
+  std::string Line;
+  while (std::getline(In, Line)) {
+    if (Line.empty() || Line[0] == '#')
+      continue;
+    std::istringstream Fields(Line);
+    std::string Case;
+    Measurement M;
+    if (Fields >> Case >> M.BytesPerSecond >> M.PeakRSS)
+      Baseline[Case] = M;
+  }
+  return Baseline;
+}
+
+// The synthetic shapes: many small functions, long functions with dense
+// symbolic operands, and a module dominated by data.
+std::vector<std::pair<std::string, SyntheticModuleOptions>> shapes() {
+  SyntheticModuleOptions Small;
+  Small.Functions = 4000;
+  Small.BlocksPerFunction = 2;
+  Small.InstructionsPerBlock = 4;
+  Small.DataTables = 20;
+  Small.Strings = 500;
+
+  SyntheticModuleOptions Code;
+  Code.Functions = 500;
+  Code.BlocksPerFunction = 40;
+  Code.InstructionsPerBlock = 10;
+  Code.SymbolicDensity = 0.6;
+  Code.DataTables = 20;
+  Code.Strings = 200;
+
+  SyntheticModuleOptions Data;
+  Data.Functions = 200;
+  Data.DataTables = 2000;
+  Data.TableEntries = 64;
+  Data.Strings = 20000;
+
+  return {{"synthetic-small", Small},
+          {"synthetic-code", Code},
+          {"synthetic-data", Data}};
+}
+
+// A module to print, described so that a child process can recreate it:
+// either a synthetic shape or a module of a GTIRB file, by position.
+struct ModuleSource {
+  std::string Name;
+  std::optional<SyntheticModuleOptions> Shape;
+  std::string IRPath;
+  size_t ModuleIndex = 0;
+};
+
+gtirb::Module* loadModule(gtirb::Context& Context,
+                          const ModuleSource& Source) {
+  if (Source.Shape)
+    return &generateSyntheticModule(Context, *Source.Shape);
+  std::ifstream In(Source.IRPath, std::ios::in | std::ios::binary);
+  gtirb::ErrorOr<gtirb::IR*> IR = gtirb::IR::load(Context, In);
+  if (!IR)
+    return nullptr;
+  auto Modules = (*IR)->modules();
+  if (Source.ModuleIndex >= static_cast<size_t>(std::distance(
+                                 Modules.begin(), Modules.end())))
+    return nullptr;
+  return &*std::next(Modules.begin(), Source.ModuleIndex);
+}
+
+// Best throughput of Rounds prints of the module with the given target.
+double measureThroughput(const ModuleSource& Source,
+                         const gtirb_pprint::TargetTy& Target,
+                         unsigned Rounds) {
+  gtirb::Context Context;
+  gtirb::Module* Module = loadModule(Context, Source);
+  if (!Module)
+    throw std::runtime_error("failed to load " + Source.Name);
+  gtirb_pprint::PrettyPrinter Printer;
+  Printer.setTarget(Target);
+  double Best = 0;
+  for (unsigned R = 0; R < Rounds; ++R) {
+    CountingBuffer Buffer;
+    std::ostream Out(&Buffer);
+    auto Start = std::chrono::steady_clock::now();
+    Printer.print(Out, Context, *Module);
+    std::chrono::duration<double> Elapsed =
+        std::chrono::steady_clock::now() - Start;
+    if (Elapsed.count() > 0)
+      Best = std::max(Best, Buffer.Count / Elapsed.count());
+  }
+  return Best;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  std::string BaselinePath;
+  std::vector<std::string> IRPaths;
+  bool Update = false;
+  unsigned Rounds = 3;
+  double Tolerance = 0.25;
+  for (int I = 1; I < argc; ++I) {
+    std::string Arg = argv[I];
+    auto Value = [&](const char* Name) -> const char* {
+      size_t Len = std::strlen(Name);
+      return Arg.compare(0, Len, Name) == 0 ? argv[I] + Len : nullptr;
+    };
+    if (const char* V = Value("--baseline="))
+      BaselinePath = V;
+    else if (const char* V = Value("--ir="))
+      IRPaths.push_back(V);
+    else if (const char* V = Value("--rounds="))
+      Rounds = std::max(1ul, std::stoul(V));
+    else if (const char* V = Value("--tolerance="))
+      Tolerance = std::stod(V);
+    else if (Arg == "--update")
+      Update = true;
+    else {
+      std::cerr << "unknown argument: " << Arg << "\n";
+      return 1;
+    }
+  }
+  if (BaselinePath.empty()) {
+    std::cerr << "missing --baseline\n";
+    return 1;
+  }
+
+  gtirb_layout::registerAuxDataTypes();
+  gtirb_pprint::registerAuxDataTypes();
+  gtirb_pprint::registerPrettyPrinters();
+
+  std::vector<ModuleSource> Sources;
+  for (auto [Name, Options] : shapes()) {
+    for (gtirb::FileFormat Format :
+         {gtirb::FileFormat::ELF, gtirb::FileFormat::PE}) {
+      Options.Format = Format;
+      Sources.push_back({Name, Options, "", 0});
+    }
+  }
+  for (const auto& Path : IRPaths) {
+    // Only the module names are needed here; loading the file in a child
+    // keeps it out of the RSS of the cases forked after it.
+    std::optional<IsolatedResult> Names = runIsolated([&] {
+      gtirb::Context Context;
+      std::ifstream In(Path, std::ios::in | std::ios::binary);
+      gtirb::ErrorOr<gtirb::IR*> IR = gtirb::IR::load(Context, In);
+      if (!IR)
+        throw std::runtime_error("failed to load " + Path);
+      std::string Out;
+      for (const auto& Module : (*IR)->modules())
+        Out += Module.getName() + "\n";
+      return Out;
+    });
+    if (!Names) {
+      std::cerr << "failed to load " << Path << "\n";
+      return 1;
+    }
+    std::string Stem = Path.substr(Path.find_last_of("/\\") + 1);
+    std::istringstream Lines(Names->Output);
+    std::string ModuleName;
+    for (size_t Index = 0; std::getline(Lines, ModuleName); ++Index)
+      Sources.push_back({Stem + ":" + ModuleName, std::nullopt, Path, Index});
+  }
+
+  std::map<std::string, Measurement> Measured;
+  for (const auto& Source : Sources) {
+    std::string Format, ISA;
+    if (Source.Shape) {
+      Format = Source.Shape->Format == gtirb::FileFormat::PE ? "pe" : "elf";
+      ISA = "x64";
+    } else {
+      std::optional<IsolatedResult> Kind = runIsolated([&] {
+        gtirb::Context Context;
+        gtirb::Module* Module = loadModule(Context, Source);
+        if (!Module)
+          throw std::runtime_error("failed to load " + Source.Name);
+        return gtirb_pprint::getModuleFileFormat(*Module) + " " +
+               gtirb_pprint::getModuleISA(*Module);
+      });
+      if (!Kind) {
+        std::cerr << "failed to load " << Source.Name << "\n";
+        return 1;
+      }
+      std::istringstream(Kind->Output) >> Format >> ISA;
+    }
+    for (const auto& Target : gtirb_pprint::getRegisteredTargets()) {
+      if (std::get<0>(Target) != Format || std::get<1>(Target) != ISA)
+        continue;
+      std::string Case =
+          Source.Name + "/" + Format + "/" + ISA + "/" + std::get<2>(Target);
+      std::optional<IsolatedResult> Result = runIsolated([&] {
+        std::ostringstream Out;
+        Out.precision(17);
+        Out << measureThroughput(Source, Target, Rounds);
+        return Out.str();
+      });
+      if (!Result) {
+        std::cerr << Case << ": measurement failed\n";
+        return 1;
+      }
+      Measurement M;
+      std::istringstream(Result->Output) >> M.BytesPerSecond;
+      M.PeakRSS = Result->PeakRSS;
+      Measured[Case] = M;
+    }
+  }
+
+  if (Update) {
+    std::ofstream Out(BaselinePath);
+    Out << "# case bytes_per_second peak_rss_kib\n";
+    for (const auto& [Case, M] : Measured)
+      Out << Case << " " << static_cast<uint64_t>(M.BytesPerSecond) << " "
+          << M.PeakRSS << "\n";
+    std::cout << "baseline written to " << BaselinePath << "\n";
+    return Out ? 0 : 1;
+  }
+
+  std::ifstream In(BaselinePath);
+  if (!In) {
+    std::cerr << "baseline could not be opened: " << BaselinePath << "\n";
+    return 1;
+  }
+  std::map<std::string, Measurement> Baseline = readBaseline(In);
+
+  if (Baseline.empty()) {
+    std::cerr << "baseline has no cases, regenerate it with --update: "
+              << BaselinePath << "\n";
+    return 1;
+  }
+
+  int Regressions = 0;
+  int Missing = 0;
+  for (const auto& [Case, M] : Measured) {
+    std::cout << Case << ": " << static_cast<uint64_t>(M.BytesPerSecond)
+              << " bytes/s, " << M.PeakRSS << " KiB";
+    auto It = Baseline.find(Case);
+    if (It == Baseline.end()) {
+      std::cout << " MISSING FROM BASELINE\n";
+      ++Missing;
+      continue;
+    }
+    const Measurement& B = It->second;
+    bool Slower = M.BytesPerSecond < B.BytesPerSecond * (1 - Tolerance);
+    bool Larger = M.PeakRSS && B.PeakRSS &&
+                  M.PeakRSS > B.PeakRSS * (1 + Tolerance);
+    if (Slower)
+      std::cout << " THROUGHPUT REGRESSION (baseline "
+                << static_cast<uint64_t>(B.BytesPerSecond) << " bytes/s)";
+    if (Larger)
+      std::cout << " RSS REGRESSION (baseline " << B.PeakRSS << " KiB)";
+    std::cout << "\n";
+    Regressions += Slower || Larger;
+  }
+  for (const auto& [Case, B] : Baseline) {
+    if (!Measured.count(Case)) {
+      std::cout << Case << ": NOT MEASURED (in baseline)\n";
+      ++Missing;
+    }
+  }
+  if (Missing)
+    std::cerr << Missing << " case(s) differ between the measurement and the "
+              << "baseline, regenerate it with --update\n";
+  if (Regressions)
+    std::cerr << Regressions << " case(s) regressed by more than "
+              << Tolerance * 100 << "%\n";
+  return Missing || Regressions ? 1 : 0;
+}
@@ -0,0 +1,260 @@
+//===- x86_table_bench.cpp --------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the MIT license. See the LICENSE file in the
+//  project root for license terms.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+//
+// Benchmark of the x86 instruction flag table against the chains of
+// comparisons and hash-set lookups it replaced.
+//
+// A corpus of instructions is decoded from pseudo-random bytes (so that it
+// covers a wide variety of opcodes) and every instruction is fixed up and
+// classified repeatedly with both implementations. The results of both
+// implementations are compared, so the benchmark also fails if the table
+// goes out of sync with the reference.
+//
+// Usage: x86_table_bench [CORPUS_BYTES] [ROUNDS]
+//===----------------------------------------------------------------------===//
+#include <gtirb_pprinter/X86InstructionTable.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace gtirb_pprint;
+
+struct DecodedInsn {
+  cs_insn Insn;
+  cs_detail Detail;
+};
+
+// The fixups as they were written before the flag table.
+static void referenceFixupInstruction(cs_insn& inst) {
+  cs_x86& detail = inst.detail->x86;
+  if ((inst.id == X86_INS_MOVSB || inst.id == X86_INS_MOVSW ||
+       inst.id == X86_INS_MOVSD || inst.id == X86_INS_MOVSQ) &&
+      inst.detail->groups[0] != X86_GRP_SSE2) {
+    detail.op_count = 0;
+  }
+  if (inst.id == X86_INS_STOSB || inst.id == X86_INS_STOSW ||
+      inst.id == X86_INS_STOSD || inst.id == X86_INS_STOSQ) {
+    detail.op_count = 1;
+  }
+  if (inst.id == X86_INS_IMUL && detail.op_count == 3) {
+    cs_x86_op& op = detail.operands[2];
+    op.imm = static_cast<int32_t>(op.imm);
+  }
+  if (inst.id == X86_INS_FXCH && detail.op_count == 2) {
+    detail.operands[0] = detail.operands[1];
+    detail.op_count = 1;
+  }
+  if (inst.id == X86_INS_COMISD || inst.id == X86_INS_VCOMISD) {
+    if (detail.op_count == 2 && detail.operands[1].type == X86_OP_MEM &&
+        detail.operands[1].size == 16) {
+      detail.operands[1].size = 8;
+    }
+  }
+  if (inst.id == X86_INS_COMISS || inst.id == X86_INS_VCOMISS) {
+    if (detail.op_count == 2 && detail.operands[1].type == X86_OP_MEM) {
+      detail.operands[1].size = 4;
+    }
+  }
+  if (detail.op_count == 1 &&
+      (inst.id == X86_INS_FXSAVE || inst.id == X86_INS_XSAVE ||
+       inst.id == X86_INS_XSAVEC || inst.id == X86_INS_FXRSTOR ||
+       inst.id == X86_INS_XRSTOR)) {
+    detail.operands[0].size = 0;
+  }
+  if (inst.id == X86_INS_RDRAND) {
+    strcpy(inst.mnemonic, "rdrand");
+  } else if (inst.id == X86_INS_RDSEED) {
+    strcpy(inst.mnemonic, "rdseed");
+  }
+  if (inst.id == X86_INS_PUNPCKLWD || inst.id == X86_INS_PUNPCKLBW ||
+      inst.id == X86_INS_PUNPCKLDQ) {
+    if (detail.op_count == 2 && detail.operands[1].type == X86_OP_MEM &&
+        detail.operands[1].size == 8) {
+      detail.operands[1].size = 4;
+    }
+  } else if (inst.id == X86_INS_INT1 || inst.id == X86_INS_INT3) {
+    int N = (inst.id == X86_INS_INT1 ? 1 : 3);
+    strcpy(inst.mnemonic, "int");
+    detail.operands[0].type = X86_OP_IMM;
+    detail.operands[0].imm = N;
+    detail.op_count = 1;
+  }
+}
+
+static bool referenceIsUnbracketed(unsigned int Id) {
+  static const std::unordered_set<unsigned int> Insns{
+      X86_INS_KANDNB,   X86_INS_KANDNW,   X86_INS_KANDND,   X86_INS_KANDNQ,
+      X86_INS_KMOVB,    X86_INS_KMOVW,    X86_INS_KMOVD,    X86_INS_KMOVQ,
+      X86_INS_KUNPCKBW, X86_INS_KNOTB,    X86_INS_KNOTW,    X86_INS_KNOTD,
+      X86_INS_KNOTQ,    X86_INS_KORB,     X86_INS_KORW,     X86_INS_KORD,
+      X86_INS_KORQ,     X86_INS_KORTESTB, X86_INS_KORTESTW, X86_INS_KORTESTD,
+      X86_INS_KORTESTQ, X86_INS_KSHIFTLB, X86_INS_KSHIFTLW, X86_INS_KSHIFTLD,
+      X86_INS_KSHIFTLQ, X86_INS_KSHIFTRB, X86_INS_KSHIFTRW, X86_INS_KSHIFTRD,
+      X86_INS_KSHIFTRQ, X86_INS_KXNORB,   X86_INS_KXNORW,   X86_INS_KXNORD,
+      X86_INS_KXNORQ,   X86_INS_KXORB,    X86_INS_KXORW,    X86_INS_KXORD,
+      X86_INS_KXORQ,
+#if CS_API_MAJOR >= 5
+      X86_INS_KUNPCKDQ, X86_INS_KUNPCKWD, X86_INS_KADDB,    X86_INS_KADDW,
+      X86_INS_KADDD,    X86_INS_KADDQ,    X86_INS_KTESTB,   X86_INS_KTESTW,
+      X86_INS_KTESTD,   X86_INS_KTESTQ,   X86_INS_VPCMPESTRI
+#endif
+  };
+  return Insns.count(Id) != 0;
+}
+
+static bool referenceIsBracketedSecond(unsigned int Id) {
+  static const std::unordered_set<unsigned int> Insns{
+      X86_INS_VPCMPB,    X86_INS_VPCMPD,    X86_INS_VPCMPQ,
+      X86_INS_VPCMPW,    X86_INS_VPCMPUB,   X86_INS_VPCMPUD,
+      X86_INS_VPCMPUQ,   X86_INS_VPCMPUW,   X86_INS_VPCMPEQB,
+      X86_INS_VPCMPEQD,  X86_INS_VPCMPEQQ,  X86_INS_VPCMPEQW,
+      X86_INS_VPCMPGTB,  X86_INS_VPCMPGTD,  X86_INS_VPCMPGTQ,
+      X86_INS_VPCMPGTW,  X86_INS_VPTEST,    X86_INS_VPTESTMB,
+      X86_INS_VPTESTMD,  X86_INS_VPTESTMQ,  X86_INS_VPTESTMW,
+      X86_INS_VPTESTNMB, X86_INS_VPTESTNMD, X86_INS_VPTESTNMQ,
+      X86_INS_VPTESTNMW,
+  };
+  return Insns.count(Id) != 0;
+}
+
+static std::vector<DecodedInsn> decodeCorpus(size_t Size) {
+  csh Handle;
+  if (cs_open(CS_ARCH_X86, CS_MODE_64, &Handle) != CS_ERR_OK) {
+    std::cerr << "cs_open failed\n";
+    return {};
+  }
+  cs_option(Handle, CS_OPT_DETAIL, CS_OPT_ON);
+
+  std::mt19937 Random(0x9e3779b9);
+  std::vector<uint8_t> Bytes(Size);
+  for (auto& Byte : Bytes) {
+    Byte = static_cast<uint8_t>(Random());
+  }
+
+  std::vector<DecodedInsn> Corpus;
+  const uint8_t* Code = Bytes.data();
+  size_t Remaining = Bytes.size();
+  uint64_t Address = 0x1000;
+  cs_insn* Insn = cs_malloc(Handle);
+  while (Remaining > 0) {
+    if (cs_disasm_iter(Handle, &Code, &Remaining, &Address, Insn)) {
+      DecodedInsn& D = Corpus.emplace_back();
+      D.Insn = *Insn;
+      D.Detail = *Insn->detail;
+      D.Insn.detail = nullptr;
+    } else {
+      // Skip an undecodable byte.
+      ++Code;
+      --Remaining;
+      ++Address;
+    }
+  }
+  cs_free(Insn, 1);
+  cs_close(&Handle);
+  return Corpus;
+}
+
+template <typename F>
+static double timeRounds(std::vector<DecodedInsn>& Corpus, size_t Rounds,
+                         uint64_t& Checksum, F Fn) {
+  auto Start = std::chrono::steady_clock::now();
+  for (size_t R = 0; R < Rounds; ++R) {
+    for (auto& D : Corpus) {
+      cs_insn Insn = D.Insn;
+      cs_detail Detail = D.Detail;
+      Insn.detail = &Detail;
+      Checksum += Fn(Insn);
+    }
+  }
+  std::chrono::duration<double> Elapsed =
+      std::chrono::steady_clock::now() - Start;
+  return Elapsed.count();
+}
+
+static uint64_t digest(const cs_insn& Insn) {
+  const cs_x86& Detail = Insn.detail->x86;
+  uint64_t H = Detail.op_count;
+  for (uint8_t I = 0; I < Detail.op_count; ++I) {
+    H = H * 31 + Detail.operands[I].size;
+    H = H * 31 + Detail.operands[I].type;
+    H = H * 31 + static_cast<uint64_t>(Detail.operands[I].imm);
+  }
+  for (const char* C = Insn.mnemonic; *C; ++C) {
+    H = H * 31 + static_cast<uint8_t>(*C);
+  }
+  return H;
+}
+
+int main(int argc, char** argv) {
+  size_t CorpusBytes = argc > 1 ? std::stoul(argv[1]) : 1 << 20;
+  size_t Rounds = argc > 2 ? std::stoul(argv[2]) : 20;
+
+  std::vector<DecodedInsn> Corpus = decodeCorpus(CorpusBytes);
+  std::cout << "Decoded " << Corpus.size() << " instructions from "
+            << CorpusBytes << " bytes\n";
+
+  // Check that the table agrees with the reference on every instruction.
+  size_t Mismatches = 0;
+  for (auto& D : Corpus) {
+    cs_insn A = D.Insn, B = D.Insn;
+    cs_detail DA = D.Detail, DB = D.Detail;
+    A.detail = &DA;
+    B.detail = &DB;
+    referenceFixupInstruction(A);
+    x86::fixupInstruction(B);
+    bool Unbracketed =
+        (x86::getInsnFlags(D.Insn.id) & x86::UnbracketedKMask) != 0;
+    bool BracketedSecond =
+        (x86::getInsnFlags(D.Insn.id) & x86::BracketedSecondKMask) != 0;
+    if (digest(A) != digest(B) ||
+        Unbracketed != referenceIsUnbracketed(D.Insn.id) ||
+        BracketedSecond != referenceIsBracketedSecond(D.Insn.id)) {
+      std::cerr << "Mismatch for " << D.Insn.mnemonic << ' ' << D.Insn.op_str
+                << "\n";
+      ++Mismatches;
+    }
+  }
+
+  uint64_t Checksum = 0;
+  double Reference =
+      timeRounds(Corpus, Rounds, Checksum, [](cs_insn& Insn) -> uint64_t {
+        referenceFixupInstruction(Insn);
+        return referenceIsUnbracketed(Insn.id) +
+               referenceIsBracketedSecond(Insn.id) + Insn.detail->x86.op_count;
+      });
+  double Table =
+      timeRounds(Corpus, Rounds, Checksum, [](cs_insn& Insn) -> uint64_t {
+        x86::fixupInstruction(Insn);
+        uint16_t Flags = x86::getInsnFlags(Insn.id);
+        return ((Flags & x86::UnbracketedKMask) != 0) +
+               ((Flags & x86::BracketedSecondKMask) != 0) +
+               Insn.detail->x86.op_count;
+      });
+
+  double Count = static_cast<double>(Corpus.size() * Rounds);
+  std::cout << "reference: " << Reference * 1e9 / Count << " ns/insn\n"
+            << "table:     " << Table * 1e9 / Count << " ns/insn\n"
+            << "checksum:  " << Checksum << "\n";
+  if (Mismatches) {
+    std::cerr << Mismatches << " mismatches between table and reference\n";
+    return 1;
+  }
+  return 0;
+}
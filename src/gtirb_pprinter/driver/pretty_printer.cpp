@@ -1,4 +1,5 @@
 #include "Logger.h"
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -9,19 +10,27 @@
 #include <gtirb_pprinter/ElfBinaryPrinter.hpp>
 #include <gtirb_pprinter/ElfVersionScriptPrinter.hpp>
 #include <gtirb_pprinter/Fixup.hpp>
+#include <gtirb_pprinter/ObjectCache.hpp>
+#include <gtirb_pprinter/OutputSink.hpp>
 #include <gtirb_pprinter/PeBinaryPrinter.hpp>
 #include <gtirb_pprinter/PrettyPrinter.hpp>
+#include <gtirb_pprinter/Sha256.hpp>
 #include <gtirb_pprinter/version.h>
 #if defined(_MSC_VER)
 #include <io.h>
 #endif
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
 #if defined(__unix__)
 #include <unistd.h>
 #endif
 #include "parser.hpp"
 #include "printing_paths.hpp"
+#include "server.hpp"
 
 namespace fs = boost::filesystem;
 namespace po = boost::program_options;
@@ -61,11 +70,13 @@ getBinaryPrinter(const std::string& format,
                  const gtirb_pprint::PrettyPrinter& pp,
                  const std::vector<std::string>& extraCompileArgs,
                  const std::vector<std::string>& libraryPaths,
-                 const std::string& gccExecutable, bool dummySO) {
+                 const std::string& gccExecutable, bool dummySO,
+                 bool builtinAssembler) {
   std::unique_ptr<gtirb_bprint::BinaryPrinter> binaryPrinter;
   if (format == "elf")
     return std::make_unique<gtirb_bprint::ElfBinaryPrinter>(
-        pp, gccExecutable, extraCompileArgs, libraryPaths, true, dummySO);
+        pp, gccExecutable, extraCompileArgs, libraryPaths, true, dummySO,
+        builtinAssembler);
   if (format == "pe")
     return std::make_unique<gtirb_bprint::PeBinaryPrinter>(pp, extraCompileArgs,
                                                            libraryPaths);
@@ -116,11 +127,7 @@ getInterpreterName(const gtirb::Module& Module) {
   return std::nullopt;
 }
 
-int main(int argc, char** argv) {
-  gtirb_layout::registerAuxDataTypes();
-  gtirb_pprint::registerAuxDataTypes();
-  gtirb_pprint::registerPrettyPrinters();
-
+static po::options_description getOptions() {
   po::options_description desc("Allowed options");
   desc.add_options()(
       "help,h", po::value<std::string>()->implicit_value(""),
@@ -164,6 +171,24 @@ int main(int argc, char** argv) {
   desc.add_options()(
       "listing-mode", po::value<std::string>(),
       "The mode of use for the listing: assembler, ui, or debug");
+  desc.add_options()(
+      "asm-target",
+      po::value<std::vector<std::string>>()->composing()->value_name(
+          "SYNTAX[:MODE]=FILE"),
+      "Also print the module given with --asm to FILE with another syntax "
+      "and listing mode (by default the one of --listing-mode). The listings "
+      "are printed together, analyzing the module and decoding instructions "
+      "once. May be repeated. Only valid when printing a single module.");
+  desc.add_options()(
+      "listing-tokens",
+      "Along with each assembly file given with --asm, write a binary token "
+      "stream of the listing with addresses, block and symbol UUIDs to the "
+      "same path with a .tokens suffix.");
+  desc.add_options()(
+      "listing-index",
+      "Along with each assembly file given with --asm, write an index of the "
+      "address ranges and listing offsets of its sections, functions and "
+      "blocks to the same path with a .index suffix.");
   desc.add_options()(
       "policy,p", po::value<std::string>(),
       "The default set of objects to skip when printing assembly. To modify "
@@ -223,11 +248,36 @@ int main(int argc, char** argv) {
                      "libraries. Only relevant for ELF executables.");
   desc.add_options()("use-gcc", po::value<std::string>(),
                      "Specify the gcc binary to use for ELF binary printing.");
+  desc.add_options()(
+      "builtin-assembler",
+      "Write x86-64 ELF objects directly from the IR instead of assembling "
+      "the printed assembly, falling back to the assembler for modules it "
+      "does not support. Only relevant for ELF binary printing.");
+  desc.add_options()(
+      "object-cache", po::value<std::string>()->value_name("DIR"),
+      "Keep the objects assembled for --binary in DIR. Modules are assembled "
+      "in shards of one or more sections, and the object of a shard is "
+      "reused when its assembly and assembler arguments have not changed. "
+      "Only relevant for ELF binary printing.");
+  desc.add_options()(
+      "object-cache-size",
+      po::value<uint64_t>()->default_value(1024)->value_name("MB"),
+      "Remove the least recently used objects when the object cache grows "
+      "past this size in megabytes, or never if 0.");
   desc.add_options()(
       "symbol-versions", po::value<bool>()->default_value(true),
       "Enable symbol versions. If symbol versions are considered many "
       "binaries will require a version linker script. Only relevant for ELF "
       "executables.");
+  desc.add_options()("fixup-report",
+                     "Report the cost of each fixup pass applied to a module.");
+  desc.add_options()("fixup-dry-run",
+                     "Report the fixups that would be applied to each module "
+                     "without applying them or printing anything.");
+  desc.add_options()(
+      "stats", po::value<std::string>()->value_name("FILE"),
+      "Write the wall and CPU time of each phase and counters of the work "
+      "done for each module to FILE as JSON.");
   desc.add_options()(
       "version-script", po::value<std::string>()->value_name("FILE"),
       "Generate a version script file on the given path. Only "
@@ -236,6 +286,131 @@ int main(int argc, char** argv) {
       "as so: \n `[MODULE1=]FILE1[,[MODULE2]=FILE2...]`\n"
       "Run `gtirb-ppprinter --help modules` for more details regarding "
       "selecting modules and specifying file names.");
+  desc.add_options()(
+      "server", po::value<std::string>()->value_name("SOCKET"),
+      "Listen for requests on the Unix domain socket SOCKET, keeping the "
+      "GTIRB files they print loaded between requests. Only the user "
+      "running the server may connect.");
+  desc.add_options()(
+      "server-max-irs", po::value<size_t>()->default_value(4)->value_name("N"),
+      "With --server, the number of GTIRB files to keep loaded; the least "
+      "recently used ones are unloaded beyond it.");
+  desc.add_options()(
+      "connect", po::value<std::string>()->value_name("SOCKET"),
+      "Send the other options to the server listening on SOCKET instead of "
+      "handling them in this process.");
+  return desc;
+}
+
+/// A GTIRB file kept loaded by the server, in a Context of its own so that
+/// it can be unloaded.
+struct ResidentIR {
+  gtirb::Context Context;
+  gtirb::IR* IR = nullptr;
+  /// When the IR was last used, counted in requests.
+  uint64_t LastUse = 0;
+};
+
+/// GTIRB files kept loaded by the server, keyed by the SHA-256 of their
+/// contents. At most MaxIRs are kept; the least recently used are unloaded.
+struct ResidentIRs {
+  std::map<std::string, std::unique_ptr<ResidentIR>> ByHash;
+  size_t MaxIRs = 0;
+  uint64_t Requests = 0;
+  /// The IR of the request being handled, if it is resident.
+  ResidentIR* Current = nullptr;
+
+  /// Unload the least recently used IRs, other than the current one, until
+  /// at most MaxIRs are loaded.
+  void trim() {
+    while (ByHash.size() > std::max<size_t>(MaxIRs, 1)) {
+      auto Oldest = ByHash.end();
+      for (auto It = ByHash.begin(); It != ByHash.end(); ++It) {
+        if (It->second.get() != Current &&
+            (Oldest == ByHash.end() ||
+             It->second->LastUse < Oldest->second->LastUse)) {
+          Oldest = It;
+        }
+      }
+      LOG_INFO << "Unloading resident IR " << Oldest->first << "\n";
+      ByHash.erase(Oldest);
+    }
+  }
+};
+
+static int run(int argc, char** argv, ResidentIRs* Resident);
+
+static int serve(const std::string& Socket, size_t MaxIRs) {
+  ResidentIRs Resident;
+  Resident.MaxIRs = MaxIRs;
+  auto Prepare = [&Resident](const gtirb_pprint::ServerRequest& Request) {
+    Resident.Current = nullptr;
+    po::positional_options_description pd;
+    pd.add("ir", -1);
+    po::variables_map vm;
+    try {
+      std::vector<std::string> Args(Request.Args.begin() + 1,
+                                    Request.Args.end());
+      po::store(po::command_line_parser(Args)
+                    .options(getOptions())
+                    .positional(pd)
+                    .run(),
+                vm);
+    } catch (std::exception&) {
+      // The handler reports the error to the client.
+      return;
+    }
+    if (vm.count("ir") == 0) {
+      return;
+    }
+    fs::path Path = fs::absolute(vm["ir"].as<std::string>(),
+                                 Request.WorkingDirectory);
+    std::ifstream In(Path.string(), std::ios::in | std::ios::binary);
+    if (!In) {
+      return;
+    }
+    std::string Contents((std::istreambuf_iterator<char>(In)),
+                         std::istreambuf_iterator<char>());
+    std::string Key = gtirb_pprint::Sha256::hexDigest(Contents);
+    auto It = Resident.ByHash.find(Key);
+    if (It == Resident.ByHash.end()) {
+      auto IR = std::make_unique<ResidentIR>();
+      std::istringstream Stream(std::move(Contents));
+      gtirb::ErrorOr<gtirb::IR*> iOrE = gtirb::IR::load(IR->Context, Stream);
+      if (!iOrE) {
+        return;
+      }
+      IR->IR = *iOrE;
+      LOG_INFO << "Loaded " << Path << " as resident IR " << Key << "\n";
+      It = Resident.ByHash.emplace(Key, std::move(IR)).first;
+    }
+    It->second->LastUse = ++Resident.Requests;
+    Resident.Current = It->second.get();
+    Resident.trim();
+  };
+  auto Handle = [&Resident](const gtirb_pprint::ServerRequest& Request) {
+    std::vector<std::string> Args = Request.Args;
+    std::vector<char*> Argv;
+    for (auto& Arg : Args) {
+      Argv.push_back(Arg.data());
+    }
+    Argv.push_back(nullptr);
+    return run(static_cast<int>(Args.size()), Argv.data(), &Resident);
+  };
+  return gtirb_pprint::runServer(Socket, Prepare, Handle);
+}
+
+int main(int argc, char** argv) {
+  gtirb_layout::registerAuxDataTypes();
+  gtirb_pprint::registerAuxDataTypes();
+  gtirb_pprint::registerPrettyPrinters();
+  return run(argc, argv, nullptr);
+}
+
+/// Handle the command line given in argv. Resident is the state of the server
+/// when handling one of its requests, and null otherwise.
+static int run(int argc, char** argv, ResidentIRs* Resident) {
+  po::options_description desc = getOptions();
   po::positional_options_description pd;
   pd.add("ir", -1);
   po::variables_map vm;
@@ -266,6 +441,43 @@ int main(int argc, char** argv) {
   }
   po::notify(vm);
 
+  // Requests handled by a server carry the --connect option of the client;
+  // neither option applies to them.
+  if (!Resident && vm.count("connect") != 0) {
+    return gtirb_pprint::runClient(vm["connect"].as<std::string>(),
+                                   std::vector<std::string>(argv, argv + argc));
+  }
+  if (!Resident && vm.count("server") != 0) {
+    return serve(vm["server"].as<std::string>(),
+                 vm["server-max-irs"].as<size_t>());
+  }
+
+  // The statistics are written when main returns, so that runs that fail
+  // part of the way through are reported too.
+  class StatisticsReport {
+    gtirb_pprint::Statistics Stats;
+    std::string Path;
+
+  public:
+    explicit StatisticsReport(std::string P) : Path(std::move(P)) {}
+    ~StatisticsReport() {
+      std::ofstream Out(Path);
+      if (!Out) {
+        LOG_ERROR << "Could not output statistics file: \"" << Path
+                  << "\".\n";
+        return;
+      }
+      Stats.writeJSON(Out);
+    }
+    gtirb_pprint::Statistics* get() { return &Stats; }
+  };
+  std::optional<StatisticsReport> StatsReport;
+  gtirb_pprint::Statistics* Stats = nullptr;
+  if (vm.count("stats") != 0) {
+    StatsReport.emplace(vm["stats"].as<std::string>());
+    Stats = StatsReport->get();
+  }
+
   class ContextForgetter {
     gtirb::Context ctx;
 
@@ -275,8 +487,11 @@ int main(int argc, char** argv) {
     operator const gtirb::Context &() const { return ctx; }
   };
 
-  ContextForgetter ctx;
-  gtirb::IR* ir = nullptr;
+  ContextForgetter LocalContext;
+  gtirb::IR* ir = Resident && Resident->Current ? Resident->Current->IR
+                                                : nullptr;
+  gtirb::Context& ctx = ir ? Resident->Current->Context
+                           : static_cast<gtirb::Context&>(LocalContext);
   std::vector<gtirb_pprint_parser::FileTemplateRule> AsmRules, BinaryRules,
       VSRules;
   try {
@@ -286,12 +501,17 @@ int main(int argc, char** argv) {
   } catch (const gtirb_pprint_parser::parse_error& /*err*/) {
     return EXIT_FAILURE;
   }
-  if (vm.count("ir") != 0) {
+  if (ir) {
+    LOG_INFO << std::setw(24) << std::left
+             << "Using resident GTIRB file: " << vm["ir"].as<std::string>()
+             << "\n";
+  } else if (vm.count("ir") != 0) {
     fs::path irPath = vm["ir"].as<std::string>();
     LOG_INFO << std::setw(24) << std::left << "Reading GTIRB file: " << irPath
              << std::endl;
     std::ifstream in(irPath.string(), std::ios::in | std::ios::binary);
     if (in) {
+      gtirb_pprint::Statistics::Timer LoadTimer(Stats, "load");
       if (gtirb::ErrorOr<gtirb::IR*> iOrE = gtirb::IR::load(ctx, in))
         ir = *iOrE;
     } else {
@@ -303,6 +523,7 @@ int main(int argc, char** argv) {
       std::cout << desc << "\n";
       return EXIT_FAILURE;
     }
+    gtirb_pprint::Statistics::Timer LoadTimer(Stats, "load");
     if (gtirb::ErrorOr<gtirb::IR*> iOrE = gtirb::IR::load(ctx, std::cin)) {
       ir = *iOrE;
     }
@@ -371,6 +592,7 @@ int main(int argc, char** argv) {
 
   // Configure the pretty-printer
   gtirb_pprint::PrettyPrinter pp;
+  pp.setStatistics(Stats);
   std::string LstMode =
       vm.count("listing-mode") ? vm["listing-mode"].as<std::string>() : "";
   if (!pp.setListingMode(LstMode)) {
@@ -405,6 +627,38 @@ int main(int argc, char** argv) {
   }
   pp.setTarget(std::move(target));
 
+  // Parse the additional assembly outputs, SYNTAX[:MODE]=FILE.
+  std::vector<std::tuple<std::string, std::string, std::string>> AsmTargets;
+  if (vm.count("asm-target") != 0) {
+    if (vm.count("asm") == 0 || Modules.size() != 1 ||
+        vm.count("listing-tokens") || vm.count("listing-index")) {
+      LOG_ERROR << "--asm-target requires --asm with a single module and "
+                   "cannot be combined with --listing-tokens or "
+                   "--listing-index.\n";
+      return EXIT_FAILURE;
+    }
+    for (const auto& Value : vm["asm-target"].as<std::vector<std::string>>()) {
+      auto Eq = Value.find('=');
+      std::string Spec = Value.substr(0, Eq);
+      auto Colon = Spec.find(':');
+      std::string TargetSyntax = Spec.substr(0, Colon);
+      std::string TargetMode =
+          Colon == std::string::npos ? LstMode : Spec.substr(Colon + 1);
+      gtirb_pprint::PrettyPrinter ModeCheck;
+      if (Eq == std::string::npos || Eq + 1 == Value.size() ||
+          gtirb_pprint::getRegisteredTargets().count(
+              std::make_tuple(format, isa, TargetSyntax)) == 0 ||
+          !ModeCheck.setListingMode(TargetMode)) {
+        LOG_ERROR << "Invalid --asm-target \"" << Value
+                  << "\": expected SYNTAX[:MODE]=FILE with a syntax and "
+                     "listing mode available for format \""
+                  << format << "\" and ISA \"" << isa << "\".\n";
+        return EXIT_FAILURE;
+      }
+      AsmTargets.emplace_back(TargetSyntax, TargetMode, Value.substr(Eq + 1));
+    }
+  }
+
   if (vm.count("policy") != 0) {
     auto Policy = vm["policy"].as<std::string>();
 
@@ -500,6 +754,12 @@ int main(int argc, char** argv) {
     pp.setIgnoreSymbolVersions(!EnableSymbolVersions);
   }
 
+  std::optional<gtirb_bprint::ObjectCache> Objects;
+  if (vm.count("object-cache") != 0) {
+    Objects.emplace(vm["object-cache"].as<std::string>(),
+                    vm["object-cache-size"].as<uint64_t>() << 20);
+  }
+
   bool new_layout = false;
 
   std::set<std::string> SkippedInterpreters;
@@ -517,16 +777,21 @@ int main(int argc, char** argv) {
 
   for (auto& MP : Modules) {
     auto& M = *(MP.Module);
+    if (Stats) {
+      Stats->setModule(M.getName());
+    }
     // Layout IR in memory without overlap.
     if (vm.count("layout")) {
       LOG_INFO << "Applying new layout to module " << M.getUUID() << "..."
                << std::endl;
+      gtirb_pprint::Statistics::Timer LayoutTimer(Stats, "layout");
       gtirb_layout::layoutModule(ctx, M);
       new_layout = true;
     } else {
       auto SkipSections = pp.getPolicy(M).skipSections;
       pp.sectionPolicy().apply(SkipSections);
       if (gtirb_layout::layoutRequired(M, SkipSections)) {
+        gtirb_pprint::Statistics::Timer LayoutTimer(Stats, "layout");
         gtirb_layout::layoutModule(ctx, M);
         new_layout = true;
       }
@@ -539,13 +804,29 @@ int main(int argc, char** argv) {
         LOG_INFO << "Module " << M.getName()
                  << " has integral symbols; attempting to assign referents..."
                  << std::endl;
+        gtirb_pprint::Statistics::Timer FixTimer(Stats,
+                                                 "fix-integral-symbols");
         gtirb_layout::fixIntegralSymbols(ctx, M);
       }
     }
     // Update DynMode (-shared or -pie or none) for the module
     pp.updateDynMode(M, SharedOption);
     // Apply any needed fixups
-    applyFixups(ctx, M, pp);
+    if (vm.count("fixup-dry-run") != 0) {
+      gtirb_pprint::FixupOptions Options;
+      Options.DryRun = true;
+      gtirb_pprint::printFixupReport(std::cout, M,
+                                     applyFixups(ctx, M, pp, Options));
+      continue;
+    }
+    gtirb_pprint::FixupReport Report;
+    {
+      gtirb_pprint::Statistics::Timer FixupTimer(Stats, "fixups");
+      Report = applyFixups(ctx, M, pp);
+    }
+    if (vm.count("fixup-report") != 0) {
+      gtirb_pprint::printFixupReport(std::cout, M, Report);
+    }
     // Write version script to a file
     if (MP.VersionScriptName) {
       LOG_INFO << "Generating version script for module " << M.getName()
@@ -563,8 +844,14 @@ int main(int argc, char** argv) {
       if (MP.VersionScriptName->has_parent_path()) {
         fs::create_directories(MP.VersionScriptName->parent_path());
       }
-      std::ofstream VersionStream(MP.VersionScriptName->generic_string());
-      gtirb_pprint::printVersionScript(ctx, *MP.Module, VersionStream);
+      gtirb_pprint::Statistics::Timer VersionTimer(Stats, "version-script");
+      gtirb_pprint::OutputSinkStream VersionStream(
+          MP.VersionScriptName->generic_string());
+      if (!VersionStream) {
+        LOG_ERROR << "Unable to open version script file \n";
+      } else if (auto Script = pp.getVersionScript(ctx, *MP.Module)) {
+        VersionStream << *Script;
+      }
     }
 
     // Write ASM to a file.
@@ -579,8 +866,71 @@ int main(int argc, char** argv) {
       if (asmPath->has_parent_path()) {
         fs::create_directories(asmPath->parent_path());
       }
-      std::ofstream ofs(name);
-      if (ofs) {
+      gtirb_pprint::OutputSinkStream ofs(name);
+      if (ofs && (vm.count("listing-tokens") || vm.count("listing-index"))) {
+        auto Printer = pp.createPrinter(ctx, M);
+        if (!Printer) {
+          LOG_ERROR << "Could not print module " << M.getName() << ".\n";
+          return EXIT_FAILURE;
+        }
+        std::string TokensName = name + ".tokens";
+        gtirb_pprint::OutputSinkStream TokensStream;
+        std::optional<gtirb_pprint::ListingTokenWriter> Tokens;
+        if (vm.count("listing-tokens")) {
+          TokensStream.open(TokensName);
+          if (!TokensStream) {
+            LOG_ERROR << "Could not output listing tokens file: \""
+                      << TokensName << "\".\n";
+            return EXIT_FAILURE;
+          }
+          Tokens.emplace(TokensStream);
+          Printer->setListingTokens(&*Tokens);
+        }
+        gtirb_pprint::ListingIndex Index;
+        if (vm.count("listing-index")) {
+          Printer->setListingIndex(&Index);
+        }
+        Printer->print(ofs);
+        Tokens.reset();
+        LOG_INFO << "Assembly for module " << M.getName()
+                 << " written to: " << name << "\n";
+        if (vm.count("listing-index")) {
+          std::string IndexName = name + ".index";
+          std::ofstream IndexStream(IndexName);
+          if (!IndexStream) {
+            LOG_ERROR << "Could not output listing index file: \""
+                      << IndexName << "\".\n";
+            return EXIT_FAILURE;
+          }
+          Index.write(IndexStream);
+        }
+      } else if (ofs && !AsmTargets.empty()) {
+        std::vector<gtirb_pprint::PrintTarget> Targets{{syntax, LstMode, &ofs}};
+        std::vector<std::unique_ptr<gtirb_pprint::OutputSinkStream>> Streams;
+        for (const auto& [TargetSyntax, TargetMode, File] : AsmTargets) {
+          if (fs::path(File).has_parent_path()) {
+            fs::create_directories(fs::path(File).parent_path());
+          }
+          Streams.push_back(
+              std::make_unique<gtirb_pprint::OutputSinkStream>(File));
+          if (!*Streams.back()) {
+            LOG_ERROR << "Could not output assembly output file: \"" << File
+                      << "\".\n";
+            return EXIT_FAILURE;
+          }
+          Targets.push_back({TargetSyntax, TargetMode, Streams.back().get()});
+        }
+        if (pp.print(Targets, ctx, M)) {
+          LOG_ERROR << "Could not print module " << M.getName() << ".\n";
+          return EXIT_FAILURE;
+        }
+        LOG_INFO << "Assembly for module " << M.getName()
+                 << " written to: " << name << "\n";
+        for (const auto& [TargetSyntax, TargetMode, File] : AsmTargets) {
+          LOG_INFO << "Assembly for module " << M.getName() << " ("
+                   << TargetSyntax << ") written to: " << File << "\n";
+        }
+      } else if (ofs) {
         if (pp.print(ofs, ctx, M)) {
           LOG_INFO << "Assembly for module " << M.getName()
                    << " written to: " << name << "\n";
@@ -619,13 +969,19 @@ int main(int argc, char** argv) {
 
       std::unique_ptr<gtirb_bprint::BinaryPrinter> binaryPrinter =
           getBinaryPrinter(format, pp, extraCompilerArgs, libraryPaths,
-                           gccExecutable, vm["dummy-so"].as<bool>());
+                           gccExecutable, vm["dummy-so"].as<bool>(),
+                           vm.count("builtin-assembler") != 0);
       if (!binaryPrinter) {
         LOG_ERROR << "'" << format
                   << "' is an unsupported binary printing format.\n";
         return EXIT_FAILURE;
       }
 
+      if (Objects) {
+        binaryPrinter->setObjectCache(&*Objects);
+      }
+
+      gtirb_pprint::Statistics::Timer BinaryTimer(Stats, "binary-print");
       int Errc;
       if (vm.count("object") == 0) {
         Errc = binaryPrinter->link(binaryPath->string(), ctx, M);
@@ -644,5 +1000,9 @@ int main(int argc, char** argv) {
       pp.print(std::cout, ctx, M);
     }
   }
+  if (Objects && Objects->hits() + Objects->misses() != 0) {
+    LOG_INFO << "Object cache: " << Objects->hits() << " hits, "
+             << Objects->misses() << " misses\n";
+  }
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,359 @@
+#include "server.hpp"
+#include "Logger.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <cstdio>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace gtirb_pprint {
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// A request is a 32-bit length, sent along with the client's standard
+// streams, followed by the working directory and the arguments, each as a
+// 32-bit length and the bytes. The reply is the 32-bit exit status.
+
+// Requests are command lines, which the kernel already limits to a few MiB.
+static constexpr uint32_t MaxRequestSize = 4 << 20;
+
+// How long the server waits for a client to send its request before moving
+// on to the next one.
+static constexpr int ReceiveTimeoutSeconds = 10;
+
+static bool sendAll(int Socket, const void* Data, size_t Size) {
+  const char* Bytes = static_cast<const char*>(Data);
+  while (Size > 0) {
+    ssize_t Sent = send(Socket, Bytes, Size, 0);
+    if (Sent < 0 && errno == EINTR)
+      continue;
+    if (Sent <= 0)
+      return false;
+    Bytes += Sent;
+    Size -= Sent;
+  }
+  return true;
+}
+
+static bool receiveAll(int Socket, void* Data, size_t Size) {
+  char* Bytes = static_cast<char*>(Data);
+  while (Size > 0) {
+    ssize_t Received = recv(Socket, Bytes, Size, 0);
+    if (Received < 0 && errno == EINTR)
+      continue;
+    if (Received <= 0)
+      return false;
+    Bytes += Received;
+    Size -= Received;
+  }
+  return true;
+}
+
+static void appendString(std::string& Message, const std::string& S) {
+  uint32_t Size = static_cast<uint32_t>(S.size());
+  Message.append(reinterpret_cast<const char*>(&Size), sizeof(Size));
+  Message.append(S);
+}
+
+static bool sendRequest(int Socket, const ServerRequest& Request) {
+  std::string Body;
+  appendString(Body, Request.WorkingDirectory);
+  for (const auto& Arg : Request.Args)
+    appendString(Body, Arg);
+  uint32_t Size = static_cast<uint32_t>(Body.size());
+
+  int Streams[3] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+  char Control[CMSG_SPACE(sizeof(Streams))] = {};
+  iovec Part = {&Size, sizeof(Size)};
+  msghdr Header = {};
+  Header.msg_iov = &Part;
+  Header.msg_iovlen = 1;
+  Header.msg_control = Control;
+  Header.msg_controllen = sizeof(Control);
+  cmsghdr* Message = CMSG_FIRSTHDR(&Header);
+  Message->cmsg_level = SOL_SOCKET;
+  Message->cmsg_type = SCM_RIGHTS;
+  Message->cmsg_len = CMSG_LEN(sizeof(Streams));
+  std::memcpy(CMSG_DATA(Message), Streams, sizeof(Streams));
+  if (sendmsg(Socket, &Header, 0) != sizeof(Size))
+    return false;
+  return sendAll(Socket, Body.data(), Body.size());
+}
+
+// Close every descriptor passed in the control messages of Header.
+static void closeReceived(msghdr& Header) {
+  for (cmsghdr* Message = CMSG_FIRSTHDR(&Header); Message;
+       Message = CMSG_NXTHDR(&Header, Message)) {
+    if (Message->cmsg_level != SOL_SOCKET || Message->cmsg_type != SCM_RIGHTS)
+      continue;
+    size_t Count = (Message->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    for (size_t I = 0; I < Count; ++I) {
+      int Fd;
+      std::memcpy(&Fd, CMSG_DATA(Message) + I * sizeof(int), sizeof(Fd));
+      close(Fd);
+    }
+  }
+}
+
+// Receive a request. Streams is filled with the client's standard streams as
+// soon as they arrive, and the caller closes them whatever the result; any
+// other descriptor sent along is closed here.
+static bool receiveRequest(int Socket, ServerRequest& Request,
+                           int (&Streams)[3]) {
+  uint32_t Size = 0;
+  char Control[CMSG_SPACE(sizeof(Streams))] = {};
+  iovec Part = {&Size, sizeof(Size)};
+  msghdr Header = {};
+  Header.msg_iov = &Part;
+  Header.msg_iovlen = 1;
+  Header.msg_control = Control;
+  Header.msg_controllen = sizeof(Control);
+  ssize_t Received;
+  do
+    Received = recvmsg(Socket, &Header, 0);
+  while (Received < 0 && errno == EINTR);
+  if (Received < 0)
+    return false;
+  cmsghdr* Message = CMSG_FIRSTHDR(&Header);
+  if (!Message || Message->cmsg_level != SOL_SOCKET ||
+      Message->cmsg_type != SCM_RIGHTS ||
+      Message->cmsg_len != CMSG_LEN(sizeof(Streams)) ||
+      (Header.msg_flags & MSG_CTRUNC)) {
+    closeReceived(Header);
+    return false;
+  }
+  std::memcpy(Streams, CMSG_DATA(Message), sizeof(Streams));
+  if (Received != sizeof(Size))
+    return false;
+  if (Size > MaxRequestSize) {
+    LOG_WARNING << "Rejecting a request of " << Size << " bytes.\n";
+    return false;
+  }
+
+  std::string Body(Size, '\0');
+  if (!receiveAll(Socket, Body.data(), Body.size()))
+    return false;
+  std::vector<std::string> Strings;
+  for (size_t Pos = 0; Pos < Body.size();) {
+    uint32_t Length;
+    if (Body.size() - Pos < sizeof(Length))
+      return false;
+    std::memcpy(&Length, Body.data() + Pos, sizeof(Length));
+    Pos += sizeof(Length);
+    if (Body.size() - Pos < Length)
+      return false;
+    Strings.emplace_back(Body, Pos, Length);
+    Pos += Length;
+  }
+  if (Strings.empty())
+    return false;
+  Request.WorkingDirectory = Strings.front();
+  Request.Args.assign(Strings.begin() + 1, Strings.end());
+  return true;
+}
+
+static bool socketAddress(const std::string& Path, sockaddr_un& Address) {
+  if (Path.size() >= sizeof(Address.sun_path)) {
+    LOG_ERROR << "Socket path is too long: " << Path << "\n";
+    return false;
+  }
+  Address = {};
+  Address.sun_family = AF_UNIX;
+  std::strncpy(Address.sun_path, Path.c_str(), sizeof(Address.sun_path) - 1);
+  return true;
+}
+
+static int handleRequest(int Listener, int Connection,
+                         const ServerRequest& Request, int (&Streams)[3],
+                         const ServerHandler& Handle) {
+  // Nothing buffered in the server may be written again by the child.
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+
+  pid_t Child = fork();
+  if (Child < 0) {
+    LOG_ERROR << "Could not fork to handle a request: "
+              << std::strerror(errno) << "\n";
+    return EXIT_FAILURE;
+  }
+  if (Child == 0) {
+    close(Listener);
+    close(Connection);
+    for (int Fd = 0; Fd < 3; ++Fd) {
+      dup2(Streams[Fd], Fd);
+      close(Streams[Fd]);
+    }
+    int Status = EXIT_FAILURE;
+    if (chdir(Request.WorkingDirectory.c_str()) != 0) {
+      LOG_ERROR << "Could not change to the working directory \""
+                << Request.WorkingDirectory << "\".\n";
+    } else {
+      Status = Handle(Request);
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+    _exit(Status);
+  }
+
+  int Status = 0;
+  while (waitpid(Child, &Status, 0) < 0 && errno == EINTR)
+    ;
+  if (WIFEXITED(Status))
+    return WEXITSTATUS(Status);
+  return WIFSIGNALED(Status) ? 128 + WTERMSIG(Status) : EXIT_FAILURE;
+}
+
+// Whether the process at the other end of Connection runs as the same user
+// as the server. Anyone else could run the pretty printer, and the tools it
+// starts, with the server's permissions.
+static bool peerIsOwner(int Connection) {
+#if defined(SO_PEERCRED)
+  ucred Credentials;
+  socklen_t Size = sizeof(Credentials);
+  if (getsockopt(Connection, SOL_SOCKET, SO_PEERCRED, &Credentials, &Size) !=
+      0)
+    return false;
+  return Credentials.uid == geteuid();
+#else
+  uid_t Uid;
+  gid_t Gid;
+  if (getpeereid(Connection, &Uid, &Gid) != 0)
+    return false;
+  return Uid == geteuid();
+#endif
+}
+
+int runServer(const std::string& Path, const ServerPrepare& Prepare,
+              const ServerHandler& Handle) {
+  sockaddr_un Address;
+  if (!socketAddress(Path, Address))
+    return EXIT_FAILURE;
+  // Replace the socket left behind by a previous server.
+  struct stat Info;
+  if (lstat(Path.c_str(), &Info) == 0 && S_ISSOCK(Info.st_mode))
+    unlink(Path.c_str());
+
+  // Only the server's user may connect: the socket is created without
+  // permissions for others, and made private before anyone can connect.
+  int Listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  mode_t Mask = umask(0177);
+  bool Bound = Listener >= 0 &&
+               bind(Listener, reinterpret_cast<sockaddr*>(&Address),
+                    sizeof(Address)) == 0;
+  umask(Mask);
+  if (!Bound || chmod(Path.c_str(), S_IRUSR | S_IWUSR) != 0 ||
+      listen(Listener, 16) != 0) {
+    LOG_ERROR << "Could not listen on \"" << Path
+              << "\": " << std::strerror(errno) << "\n";
+    if (Listener >= 0)
+      close(Listener);
+    return EXIT_FAILURE;
+  }
+  // Clients that go away before their reply must not take the server along.
+  std::signal(SIGPIPE, SIG_IGN);
+  LOG_INFO << "Listening on " << Path << "\n";
+
+  while (true) {
+    int Connection = accept(Listener, nullptr, nullptr);
+    if (Connection < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      LOG_ERROR << "Could not accept a connection: " << std::strerror(errno)
+                << "\n";
+      break;
+    }
+    if (!peerIsOwner(Connection)) {
+      LOG_WARNING << "Refusing a connection from another user.\n";
+      close(Connection);
+      continue;
+    }
+    timeval Timeout = {ReceiveTimeoutSeconds, 0};
+    setsockopt(Connection, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof(Timeout));
+    setsockopt(Connection, SOL_SOCKET, SO_SNDTIMEO, &Timeout, sizeof(Timeout));
+
+    ServerRequest Request;
+    int Streams[3] = {-1, -1, -1};
+    if (receiveRequest(Connection, Request, Streams)) {
+      Prepare(Request);
+      int32_t Status =
+          handleRequest(Listener, Connection, Request, Streams, Handle);
+      sendAll(Connection, &Status, sizeof(Status));
+    } else {
+      LOG_WARNING << "Ignoring a malformed request.\n";
+    }
+    for (int Fd : Streams) {
+      if (Fd >= 0)
+        close(Fd);
+    }
+    close(Connection);
+  }
+  close(Listener);
+  unlink(Path.c_str());
+  return EXIT_FAILURE;
+}
+
+int runClient(const std::string& Path, const std::vector<std::string>& Args) {
+  sockaddr_un Address;
+  if (!socketAddress(Path, Address))
+    return EXIT_FAILURE;
+  std::vector<char> Cwd(4096);
+  while (!getcwd(Cwd.data(), Cwd.size())) {
+    if (errno != ERANGE) {
+      LOG_ERROR << "Could not get the working directory.\n";
+      return EXIT_FAILURE;
+    }
+    Cwd.resize(Cwd.size() * 2);
+  }
+
+  int Socket = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (Socket < 0 || connect(Socket, reinterpret_cast<sockaddr*>(&Address),
+                            sizeof(Address)) != 0) {
+    LOG_ERROR << "Could not connect to \"" << Path
+              << "\": " << std::strerror(errno) << "\n";
+    if (Socket >= 0)
+      close(Socket);
+    return EXIT_FAILURE;
+  }
+  // The server writes to our standard streams directly.
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+
+  int32_t Status = EXIT_FAILURE;
+  if (!sendRequest(Socket, {Cwd.data(), Args}) ||
+      !receiveAll(Socket, &Status, sizeof(Status))) {
+    LOG_ERROR << "The server at \"" << Path
+              << "\" did not handle the request.\n";
+    Status = EXIT_FAILURE;
+  }
+  close(Socket);
+  return Status;
+}
+
+#else
+
+int runServer(const std::string&, const ServerPrepare&,
+              const ServerHandler&) {
+  LOG_ERROR << "Server mode requires Unix domain sockets.\n";
+  return EXIT_FAILURE;
+}
+
+int runClient(const std::string&, const std::vector<std::string>&) {
+  LOG_ERROR << "Server mode requires Unix domain sockets.\n";
+  return EXIT_FAILURE;
+}
+
+#endif
+
+} // namespace gtirb_pprint
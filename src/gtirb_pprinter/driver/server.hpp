@@ -0,0 +1,41 @@
+#ifndef GTIRB_PPRINT_SERVER_H
+#define GTIRB_PPRINT_SERVER_H
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace gtirb_pprint {
+
+/// A request sent to the server: the command-line arguments and the working
+/// directory of the client.
+struct ServerRequest {
+  std::string WorkingDirectory;
+  std::vector<std::string> Args;
+};
+
+/// Called in the server process before a request is handled, to load
+/// whatever should stay resident between requests.
+using ServerPrepare = std::function<void(const ServerRequest&)>;
+
+/// Called in a process forked from the server for each request, with the
+/// working directory and standard streams of the client; returns the exit
+/// status reported to the client. Anything the request changes in memory
+/// is discarded with the process.
+using ServerHandler = std::function<int(const ServerRequest&)>;
+
+/// Listen on the Unix domain socket at Path and handle requests one at a
+/// time until the process is terminated.
+///
+/// \return EXIT_FAILURE if the socket could not be set up.
+int runServer(const std::string& Path, const ServerPrepare& Prepare,
+              const ServerHandler& Handle);
+
+/// Send Args, with the working directory and standard streams of this
+/// process, to the server listening at Path and wait for it to be handled.
+///
+/// \return the exit status of the request, or EXIT_FAILURE if the server
+/// could not be reached.
+int runClient(const std::string& Path, const std::vector<std::string>& Args);
+
+} // namespace gtirb_pprint
+#endif // GTIRB_PPRINT_SERVER_H
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <gtirb/gtirb.hpp>
+#include <gtirb_pprinter/AuxDataSchema.hpp>
+#include <gtirb_pprinter/AuxDataUtils.hpp>
+#include <gtirb_pprinter/Fixup.hpp>
+#include <gtirb_pprinter/PrettyPrinter.hpp>
+
+using namespace std::literals;
+using namespace gtirb_pprint;
+
+class ElfSymbolFixups : public ::testing::Test {
+protected:
+  gtirb::Context Ctx;
+  gtirb::Module* M;
+  gtirb::Symbol* Main;
+
+public:
+  ElfSymbolFixups() {
+    M = gtirb::Module::Create(Ctx, "ex"s);
+    M->setFileFormat(gtirb::FileFormat::ELF);
+    M->setISA(gtirb::ISA::X64);
+    M->addAuxData<gtirb::schema::ElfSymbolInfo>({});
+
+    Main = M->addSymbol(Ctx, "main"s);
+    aux_data::ElfSymbolInfo Info({0, "FUNC", "LOCAL", "DEFAULT", 0});
+    aux_data::setElfSymbolInfo(*Main, Info);
+  }
+};
+
+TEST_F(ElfSymbolFixups, DryRunDoesNotModify) {
+  FixupPassStats Stats = fixupELFSymbols(Ctx, *M, true);
+  EXPECT_EQ(Stats.SymbolsScanned, 1);
+  EXPECT_EQ(Stats.SymbolsModified, 1);
+  EXPECT_TRUE(Stats.changed());
+  EXPECT_EQ(aux_data::getElfSymbolInfo(*Main)->Binding, "LOCAL");
+}
+
+TEST_F(ElfSymbolFixups, ApplyMatchesDryRun) {
+  FixupPassStats DryStats = fixupELFSymbols(Ctx, *M, true);
+  FixupPassStats Stats = fixupELFSymbols(Ctx, *M);
+  EXPECT_EQ(Stats.SymbolsModified, DryStats.SymbolsModified);
+  EXPECT_EQ(aux_data::getElfSymbolInfo(*Main)->Binding, "GLOBAL");
+  EXPECT_EQ(aux_data::getElfSymbolInfo(*Main)->Visibility, "HIDDEN");
+
+  // A second run finds nothing left to do.
+  EXPECT_FALSE(fixupELFSymbols(Ctx, *M).changed());
+}
+
+TEST_F(ElfSymbolFixups, AppliedFixupsAreRecorded) {
+  PrettyPrinter Printer;
+  Printer.setTarget(std::make_tuple("elf"s, "x64"s, "att"s));
+
+  FixupReport First = applyFixups(Ctx, *M, Printer);
+  ASSERT_EQ(First.Passes.size(), 1);
+  EXPECT_FALSE(First.Passes[0].Cached);
+  EXPECT_TRUE(First.changed());
+  EXPECT_TRUE(Printer.isFixupApplied(Ctx, *M, "elf-symbols"));
+
+  // Copies of the printer share the record.
+  PrettyPrinter Copy(Printer);
+  FixupReport Second = applyFixups(Ctx, *M, Copy);
+  ASSERT_EQ(Second.Passes.size(), 1);
+  EXPECT_TRUE(Second.Passes[0].Cached);
+  EXPECT_FALSE(Second.changed());
+
+  FixupOptions Force;
+  Force.Force = true;
+  FixupReport Third = applyFixups(Ctx, *M, Printer, Force);
+  ASSERT_EQ(Third.Passes.size(), 1);
+  EXPECT_FALSE(Third.Passes[0].Cached);
+}
+
+TEST_F(ElfSymbolFixups, EditedModuleIsFixedUpAgain) {
+  PrettyPrinter Printer;
+  Printer.setTarget(std::make_tuple("elf"s, "x64"s, "att"s));
+  applyFixups(Ctx, *M, Printer);
+
+  // A symbol added after the fixups were recorded still needs them, once
+  // the edit is followed by an invalidation.
+  gtirb::Symbol* Start = M->addSymbol(Ctx, "_start"s);
+  aux_data::ElfSymbolInfo Info({0, "FUNC", "LOCAL", "DEFAULT", 0});
+  aux_data::setElfSymbolInfo(*Start, Info);
+  Printer.invalidateModuleCaches(Ctx, *M);
+
+  FixupReport Report = applyFixups(Ctx, *M, Printer);
+  ASSERT_EQ(Report.Passes.size(), 1);
+  EXPECT_FALSE(Report.Passes[0].Cached);
+  EXPECT_TRUE(Report.changed());
+  EXPECT_EQ(aux_data::getElfSymbolInfo(*Start)->Binding, "GLOBAL");
+
+  EXPECT_TRUE(applyFixups(Ctx, *M, Printer).Passes[0].Cached);
+}
+
+TEST_F(ElfSymbolFixups, DryRunIsNotRecorded) {
+  PrettyPrinter Printer;
+  Printer.setTarget(std::make_tuple("elf"s, "x64"s, "att"s));
+
+  FixupOptions DryRun;
+  DryRun.DryRun = true;
+  applyFixups(Ctx, *M, Printer, DryRun);
+  EXPECT_FALSE(Printer.isFixupApplied(Ctx, *M, "elf-symbols"));
+  EXPECT_FALSE(applyFixups(Ctx, *M, Printer).Passes[0].Cached);
+}
+
+TEST_F(ElfSymbolFixups, SymbolForwardingIsResolvedOnce) {
+  gtirb::Symbol* Puts = M->addSymbol(Ctx, "puts"s);
+  gtirb::Symbol* Stub = M->addSymbol(Ctx, "puts@plt"s);
+  gtirb::UUID Missing{}; // not a node in the context
+  M->addAuxData<gtirb::schema::SymbolForwarding>(
+      {{Stub->getUUID(), Puts->getUUID()}, {Main->getUUID(), Missing}});
+
+  PrettyPrinter Printer;
+  auto Forwarding = Printer.getSymbolForwarding(Ctx, *M);
+  ASSERT_NE(Forwarding, nullptr);
+  EXPECT_EQ(Forwarding->lookup(Stub), Puts);
+  EXPECT_EQ(Forwarding->lookup(Puts), nullptr);
+  ASSERT_EQ(Forwarding->entries().size(), 1);
+  EXPECT_EQ(Printer.getSymbolForwarding(Ctx, *M), Forwarding);
+
+  // Copies share the table; editing the forwarding takes an invalidation,
+  // which leaves the tables handed out before unchanged.
+  PrettyPrinter Copy(Printer);
+  EXPECT_EQ(Copy.getSymbolForwarding(Ctx, *M), Forwarding);
+  (*M->getAuxData<gtirb::schema::SymbolForwarding>())[Main->getUUID()] =
+      Puts->getUUID();
+  Copy.invalidateModuleCaches(Ctx, *M);
+  EXPECT_EQ(Printer.getSymbolForwarding(Ctx, *M)->lookup(Main), Puts);
+  EXPECT_EQ(Forwarding->lookup(Main), nullptr);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <gtirb_pprinter/ListingIndex.hpp>
+#include <algorithm>
+#include <random>
+#include <sstream>
+
+using namespace gtirb_pprint;
+
+namespace {
+ListingIndex makeIndex() {
+  using Kind = ListingIndexEntry::Kind;
+  ListingIndex Index;
+  gtirb::UUID Id{};
+  Id.data[15] = 1;
+  Index.add({Kind::Section, Id, 0x1000, 0x1100, 0, 400, ".text"});
+  Index.add({Kind::Function, Id, 0x1000, 0x1010, 40, 100, "main"});
+  Index.add({Kind::Block, Id, 0x1000, 0x1008, 40, 60, ""});
+  Index.add({Kind::Block, Id, 0x1008, 0x1010, 100, 40, ""});
+  return Index;
+}
+} // namespace
+
+TEST(ListingIndex, Find) {
+  ListingIndex Index = makeIndex();
+  auto Blocks = Index.find(ListingIndexEntry::Kind::Block, 0x1004, 0x1009);
+  ASSERT_EQ(Blocks.size(), 2);
+  EXPECT_EQ(Blocks[1]->Offset, 100);
+
+  Blocks = Index.find(ListingIndexEntry::Kind::Block, 0x1010, 0x1020);
+  EXPECT_TRUE(Blocks.empty());
+}
+
+TEST(ListingIndex, FindMatchesLinearScan) {
+  using Kind = ListingIndexEntry::Kind;
+  // Blocks are disjoint; functions and sections overlap each other and are
+  // added in no particular order.
+  std::mt19937_64 Random(42);
+  ListingIndex Index;
+  gtirb::UUID Id{};
+  for (uint64_t I = 0; I < 500; ++I) {
+    uint64_t Begin = (Random() % 4096) * 4;
+    Index.add({Kind::Section, Id, Begin, Begin + 1 + Random() % 512, 0, 0,
+               ".s"});
+    Index.add({Kind::Function, Id, Begin, Begin + 1 + Random() % 64, 0, 0,
+               "f"});
+    Index.add({Kind::Block, Id, I * 8, I * 8 + 8, 0, 0, ""});
+  }
+  // Growing an entry through operator[] is seen by the next find.
+  ASSERT_EQ(Index.find(Kind::Block, 0x10000, 0x10001).size(), 0);
+  Index[2].End = 0x10001;
+
+  for (int Query = 0; Query < 1000; ++Query) {
+    uint64_t Begin = Random() % 0x4400;
+    uint64_t End = Begin + Random() % 128;
+    for (Kind K : {Kind::Section, Kind::Function, Kind::Block}) {
+      std::vector<const ListingIndexEntry*> Expected;
+      for (const auto& Entry : Index.entries()) {
+        if (Entry.EntryKind == K && Entry.Begin < End && Begin < Entry.End)
+          Expected.push_back(&Entry);
+      }
+      std::stable_sort(Expected.begin(), Expected.end(),
+                       [](const auto* A, const auto* B) {
+                         return A->Begin < B->Begin;
+                       });
+      ASSERT_EQ(Index.find(K, Begin, End), Expected)
+          << int(K) << " [" << Begin << ", " << End << ")";
+    }
+  }
+}
+
+TEST(ListingIndex, RoundTrip) {
+  ListingIndex Index = makeIndex();
+  Index[0].Name = "my section";
+  std::stringstream Stream;
+  Index.write(Stream);
+  EXPECT_EQ(Stream.str().substr(0, Stream.str().find('\n')),
+            "section 00000000-0000-0000-0000-000000000001 0x1000 0x1100 0 400 "
+            "my section");
+
+  auto Read = ListingIndex::read(Stream);
+  ASSERT_TRUE(Read);
+  ASSERT_EQ(Read->entries().size(), Index.entries().size());
+  for (size_t I = 0; I < Index.entries().size(); ++I) {
+    const auto& A = Index.entries()[I];
+    const auto& B = Read->entries()[I];
+    EXPECT_EQ(A.EntryKind, B.EntryKind);
+    EXPECT_EQ(A.Id, B.Id);
+    EXPECT_EQ(A.Begin, B.Begin);
+    EXPECT_EQ(A.End, B.End);
+    EXPECT_EQ(A.Offset, B.Offset);
+    EXPECT_EQ(A.Size, B.Size);
+    EXPECT_EQ(A.Name, B.Name);
+  }
+
+  std::istringstream Bad("chapter 0 0 0 0 0\n");
+  EXPECT_FALSE(ListingIndex::read(Bad));
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <gtirb_pprinter/ListingTokens.hpp>
+#include <sstream>
+
+using namespace gtirb_pprint;
+
+namespace {
+uint32_t readU32(const std::string& S, size_t Pos) {
+  uint32_t Value = 0;
+  for (size_t I = 0; I < 4; ++I)
+    Value |= static_cast<uint32_t>(static_cast<uint8_t>(S[Pos + I])) << 8 * I;
+  return Value;
+}
+} // namespace
+
+TEST(ListingTokens, Header) {
+  std::ostringstream Stream;
+  { ListingTokenWriter Tokens(Stream); }
+  std::string Out = Stream.str();
+  ASSERT_EQ(Out.size(), 8);
+  EXPECT_EQ(Out.substr(0, 4), "GTLT");
+  EXPECT_EQ(readU32(Out, 4), ListingTokenWriter::Version);
+}
+
+TEST(ListingTokens, PendingRecordsFollowTheirLine) {
+  std::ostringstream Stream;
+  gtirb::UUID Block{}, Symbol{};
+  Symbol.data[0] = 0xab;
+  {
+    ListingTokenWriter Tokens(Stream);
+    Tokens.instruction("nop", "");
+    Tokens.symbolReference(Symbol);
+    Tokens.line(0x1000, Block, "  nop");
+  }
+  std::string Out = Stream.str();
+
+  // Line: 8-byte EA, 16-byte UUID, 5 bytes of text, padded to 32.
+  size_t Pos = 8;
+  EXPECT_EQ(Out[Pos], static_cast<char>(ListingToken::Line));
+  EXPECT_EQ(readU32(Out, Pos + 4), 29);
+  EXPECT_EQ(readU32(Out, Pos + 8), 0x1000);
+  EXPECT_EQ(Out.substr(Pos + 8 + 24, 5), "  nop");
+  Pos += 8 + 32;
+
+  // Instruction: 4-byte length and the mnemonic, padded to 8.
+  EXPECT_EQ(Out[Pos], static_cast<char>(ListingToken::Instruction));
+  EXPECT_EQ(readU32(Out, Pos + 4), 7);
+  EXPECT_EQ(readU32(Out, Pos + 8), 3);
+  EXPECT_EQ(Out.substr(Pos + 12, 3), "nop");
+  Pos += 8 + 8;
+
+  EXPECT_EQ(Out[Pos], static_cast<char>(ListingToken::SymbolRef));
+  EXPECT_EQ(readU32(Out, Pos + 4), 16);
+  EXPECT_EQ(static_cast<uint8_t>(Out[Pos + 8]), 0xab);
+  Pos += 8 + 16;
+
+  EXPECT_EQ(Out.size(), Pos);
+}
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include <gtirb_pprinter/NumberFormat.hpp>
+#include <sstream>
+
+using namespace gtirb_pprint;
+
+TEST(NumberFormat, Decimal) {
+  std::ostringstream Stream;
+  writeDecimal(Stream, int64_t{-42});
+  Stream << ' ';
+  writeDecimal(Stream, uint64_t{18446744073709551615u});
+  EXPECT_EQ(Stream.str(), "-42 18446744073709551615");
+
+  std::string Buf;
+  appendDecimal(Buf, 0);
+  EXPECT_EQ(Buf, "0");
+}
+
+TEST(NumberFormat, Hex) {
+  std::ostringstream Stream;
+  writeHex(Stream, 0x1f);
+  Stream << ' ';
+  writeHex(Stream, static_cast<uint64_t>(int64_t{-1}));
+  Stream << ' ';
+  writeHex(Stream, 0x1000, BareHexFormat);
+  EXPECT_EQ(Stream.str(), "0x1f 0xffffffffffffffff 1000");
+}
+
+TEST(NumberFormat, HexStyle) {
+  HexFormat Masm{"0", "H", true};
+  std::string Buf;
+  appendHex(Buf, 0xa, Masm, 2);
+  Buf += ' ';
+  appendHex(Buf, 0xabc, Masm, 2);
+  EXPECT_EQ(Buf, "00AH 0ABCH");
+}
+
+TEST(NumberFormat, DoesNotTouchStreamFlags) {
+  std::ostringstream Stream;
+  writeHex(Stream, 16);
+  Stream << ' ' << 16;
+  EXPECT_EQ(Stream.str(), "0x10 16");
+}
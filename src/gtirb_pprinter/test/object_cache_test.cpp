@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <gtirb_pprinter/ObjectCache.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+
+using namespace gtirb_bprint;
+namespace fs = boost::filesystem;
+
+static void writeFile(const std::string& Path, const std::string& Contents) {
+  std::ofstream Out(Path, std::ios::binary);
+  Out << Contents;
+}
+
+static std::string readFile(const std::string& Path) {
+  std::ifstream In(Path, std::ios::binary);
+  std::stringstream Contents;
+  Contents << In.rdbuf();
+  return Contents.str();
+}
+
+TEST(ObjectCache, Key) {
+  std::string Source = testing::TempDir() + "object_cache_key.s";
+  writeFile(Source, "");
+  // The SHA-256 of the tool name and its terminating null.
+  EXPECT_EQ(ObjectCache::key(Source, "", {}),
+            "6e340b9cffb37a989ca544e6bb780a2c78901d3fb33738768511a30617afa01d");
+
+  writeFile(Source, "\tnop\n");
+  auto Key = ObjectCache::key(Source, "gcc", {"-c"});
+  ASSERT_TRUE(Key);
+  EXPECT_NE(Key, ObjectCache::key(Source, "gcc", {"-c", "-g"}));
+  EXPECT_NE(Key, ObjectCache::key(Source, "gcc-c", {}));
+  writeFile(Source, "\tret\n");
+  EXPECT_NE(Key, ObjectCache::key(Source, "gcc", {"-c"}));
+  fs::remove(Source);
+
+  EXPECT_EQ(ObjectCache::key(Source, "gcc", {}), std::nullopt);
+}
+
+TEST(ObjectCache, FetchAndStore) {
+  std::string Dir = testing::TempDir() + "object_cache_store";
+  std::string Object = testing::TempDir() + "object_cache_store.o";
+  fs::remove_all(Dir);
+  ObjectCache Cache(Dir);
+
+  EXPECT_FALSE(Cache.fetch("00aa", Object));
+  writeFile(Object, "object");
+  EXPECT_TRUE(Cache.store("00aa", Object));
+  fs::remove(Object);
+  EXPECT_TRUE(Cache.fetch("00aa", Object));
+  EXPECT_EQ(readFile(Object), "object");
+  EXPECT_EQ(Cache.hits(), 1);
+  EXPECT_EQ(Cache.misses(), 1);
+
+  fs::remove(Object);
+  fs::remove_all(Dir);
+}
+
+TEST(ObjectCache, EvictsLeastRecentlyUsed) {
+  std::string Dir = testing::TempDir() + "object_cache_evict";
+  std::string Object = testing::TempDir() + "object_cache_evict.o";
+  fs::remove_all(Dir);
+  ObjectCache Cache(Dir, 10);
+
+  writeFile(Object, "123456");
+  ASSERT_TRUE(Cache.store("00aa", Object));
+  // Make the first object older than the second.
+  fs::last_write_time(fs::path(Dir) / "00" / "aa.o", 1);
+  ASSERT_TRUE(Cache.store("00bb", Object));
+  EXPECT_FALSE(Cache.fetch("00aa", Object));
+  EXPECT_TRUE(Cache.fetch("00bb", Object));
+
+  fs::remove(Object);
+  fs::remove_all(Dir);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <gtirb_pprinter/OutputSink.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace gtirb_pprint;
+
+static std::string readFile(const std::string& Path) {
+  std::ifstream In(Path, std::ios::binary);
+  std::stringstream Contents;
+  Contents << In.rdbuf();
+  return Contents.str();
+}
+
+TEST(OutputSink, SmallBuffer) {
+  std::string Path = testing::TempDir() + "output_sink_small.txt";
+  std::string Expected;
+  {
+    // A tiny buffer exercises overflow and writes larger than the buffer.
+    OutputSinkStream Stream(Path, 8);
+    ASSERT_TRUE(Stream.is_open());
+    for (int I = 0; I < 100; ++I) {
+      Stream << "line " << I << '\n';
+      Expected += "line " + std::to_string(I) + "\n";
+    }
+    std::string Long(1000, 'x');
+    Stream << Long;
+    Expected += Long;
+    Stream.close();
+    EXPECT_TRUE(Stream.good());
+  }
+  EXPECT_EQ(readFile(Path), Expected);
+  std::remove(Path.c_str());
+}
+
+TEST(OutputSink, WrittenOnSyncAndClose) {
+  std::string Path = testing::TempDir() + "output_sink_sync.txt";
+  OutputSinkStream Stream(Path);
+  Stream << "first\n";
+  EXPECT_EQ(readFile(Path), "");
+  Stream.flush();
+  EXPECT_EQ(readFile(Path), "first\n");
+  Stream << "second\n";
+  Stream.close();
+  EXPECT_TRUE(Stream.good());
+  EXPECT_EQ(readFile(Path), "first\nsecond\n");
+  std::remove(Path.c_str());
+}
+
+TEST(OutputSink, OpenFailure) {
+  OutputSinkStream Stream(testing::TempDir() + "missing/dir/file.txt");
+  EXPECT_FALSE(Stream.is_open());
+  EXPECT_TRUE(Stream.fail());
+}
+
+TEST(OutputSink, TellReportsBytesWritten) {
+  std::string Path = testing::TempDir() + "output_sink_tell.txt";
+  OutputSinkStream Stream(Path, 8);
+  EXPECT_EQ(Stream.tellp(), 0);
+  Stream << "abc";
+  EXPECT_EQ(Stream.tellp(), 3);
+  // Past the buffer, through overflow and a direct write.
+  Stream << "defghij";
+  EXPECT_EQ(Stream.tellp(), 10);
+  Stream << std::string(100, 'x');
+  EXPECT_EQ(Stream.tellp(), 110);
+  Stream.flush();
+  EXPECT_EQ(Stream.tellp(), 110);
+  Stream.close();
+  EXPECT_EQ(readFile(Path).size(), 110);
+
+  // Reopening starts over.
+  Stream.open(Path);
+  EXPECT_EQ(Stream.tellp(), 0);
+  Stream.close();
+  std::remove(Path.c_str());
+}
@@ -0,0 +1,540 @@
+#include <gtest/gtest.h>
+#include <gtirb/gtirb.hpp>
+#include <gtirb_pprinter/AuxDataSchema.hpp>
+#include <gtirb_pprinter/AuxDataUtils.hpp>
+#include <gtirb_pprinter/ListingIndex.hpp>
+#include <gtirb_pprinter/ListingTokens.hpp>
+#include <gtirb_pprinter/PrettyPrinter.hpp>
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace std::literals;
+using namespace gtirb_pprint;
+
+namespace {
+uint64_t readLE(const std::string& S, size_t Pos, size_t Bytes) {
+  uint64_t Value = 0;
+  for (size_t I = 0; I < Bytes; ++I)
+    Value |= static_cast<uint64_t>(static_cast<uint8_t>(S[Pos + I])) << 8 * I;
+  return Value;
+}
+
+struct TokenRecord {
+  ListingToken Kind;
+  std::string Payload;
+};
+
+std::vector<TokenRecord> readTokens(const std::string& S) {
+  std::vector<TokenRecord> Records;
+  for (size_t Pos = 8; Pos + 8 <= S.size();) {
+    auto Size = static_cast<size_t>(readLE(S, Pos + 4, 4));
+    Records.push_back(
+        {static_cast<ListingToken>(S[Pos]), S.substr(Pos + 8, Size)});
+    Pos += 8 + (Size + 7) / 8 * 8;
+  }
+  return Records;
+}
+
+gtirb::UUID uuidAt(const std::string& S, size_t Pos) {
+  gtirb::UUID Id;
+  std::copy(S.begin() + Pos, S.begin() + Pos + 16, Id.begin());
+  return Id;
+}
+} // namespace
+
+/// A small x86-64 ELF module: three functions in .text, the first of two
+/// blocks with CFI directives, and a table of pointers to them in .data.
+class PrinterTest : public ::testing::Test {
+protected:
+  gtirb::Context Ctx;
+  gtirb::Module* M;
+  std::vector<gtirb::CodeBlock*> Blocks;
+  std::vector<gtirb::UUID> Functions;
+  std::vector<gtirb::Symbol*> FunctionSymbols;
+  gtirb::Section* TextSection;
+  gtirb::Section* DataSection;
+  gtirb::DataBlock* Table;
+
+  static constexpr uint64_t TextAddress = 0x1000;
+  static constexpr uint64_t DataAddress = 0x2000;
+
+public:
+  PrinterTest() {
+    auto* IR = gtirb::IR::Create(Ctx);
+    M = IR->addModule(Ctx, "test"s);
+    M->setFileFormat(gtirb::FileFormat::ELF);
+    M->setISA(gtirb::ISA::X64);
+    M->addAuxData<gtirb::schema::ElfSymbolInfo>({});
+    M->addAuxData<gtirb::schema::SectionProperties>({});
+    M->addAuxData<gtirb::schema::FunctionEntries>({});
+    M->addAuxData<gtirb::schema::FunctionBlocks>({});
+    M->addAuxData<gtirb::schema::SymbolicExpressionSizes>({});
+    M->addAuxData<gtirb::schema::CfiDirectives>({});
+
+    // f1: push %rbp; mov %rsp,%rbp | pop %rbp; ret, then f2 and f3: ret.
+    const std::vector<uint8_t> Text{0x55, 0x48, 0x89, 0xe5, 0x5d, 0xc3,
+                                    0xc3, 0xc3};
+    const std::vector<uint64_t> Starts{0, 4, 6, 7, 8};
+    const std::vector<std::vector<size_t>> FunctionBlockIndices{
+        {0, 1}, {2}, {3}};
+    TextSection = M->addSection(Ctx, ".text"s);
+    TextSection->addFlag(gtirb::SectionFlag::Readable);
+    TextSection->addFlag(gtirb::SectionFlag::Executable);
+    TextSection->addFlag(gtirb::SectionFlag::Loaded);
+    TextSection->addFlag(gtirb::SectionFlag::Initialized);
+    auto* TextBI = TextSection->addByteInterval(
+        Ctx, gtirb::Addr(TextAddress), Text.begin(), Text.end(), Text.size(),
+        Text.size());
+    for (size_t I = 0; I + 1 < Starts.size(); ++I) {
+      Blocks.push_back(TextBI->addBlock<gtirb::CodeBlock>(
+          Ctx, Starts[I], Starts[I + 1] - Starts[I]));
+    }
+    for (size_t I = 0; I < FunctionBlockIndices.size(); ++I) {
+      const auto& Indices = FunctionBlockIndices[I];
+      gtirb::CodeBlock* Entry = Blocks[Indices.front()];
+      uint64_t Size = 0;
+      std::set<gtirb::UUID> FunctionBlocks;
+      for (size_t Index : Indices) {
+        Size += Blocks[Index]->getSize();
+        FunctionBlocks.insert(Blocks[Index]->getUUID());
+      }
+      auto* Symbol = M->addSymbol(Ctx, Entry, "f" + std::to_string(I + 1));
+      aux_data::ElfSymbolInfo Info({Size, "FUNC", "GLOBAL", "DEFAULT", 0});
+      aux_data::setElfSymbolInfo(*Symbol, Info);
+      gtirb::UUID Function = Entry->getUUID();
+      (*M->getAuxData<gtirb::schema::FunctionEntries>())[Function] = {
+          Entry->getUUID()};
+      (*M->getAuxData<gtirb::schema::FunctionBlocks>())[Function] =
+          FunctionBlocks;
+      Functions.push_back(Function);
+      FunctionSymbols.push_back(Symbol);
+    }
+
+    auto& Cfi = *M->getAuxData<gtirb::schema::CfiDirectives>();
+    auto addCfi = [&](gtirb::CodeBlock* Block, uint64_t Offset,
+                   const std::string& Directive, std::vector<int64_t> Ops) {
+      Cfi[gtirb::Offset(Block->getUUID(), Offset)].emplace_back(
+          Directive, std::move(Ops), gtirb::UUID{});
+    };
+    addCfi(Blocks[0], 0, ".cfi_startproc", {});
+    addCfi(Blocks[0], 1, ".cfi_def_cfa_offset", {16});
+    addCfi(Blocks[1], 1, ".cfi_def_cfa_offset", {8});
+    addCfi(Blocks[1], 2, ".cfi_endproc", {});
+
+    const std::vector<uint8_t> Data(8 * FunctionSymbols.size(), 0);
+    DataSection = M->addSection(Ctx, ".data"s);
+    DataSection->addFlag(gtirb::SectionFlag::Readable);
+    DataSection->addFlag(gtirb::SectionFlag::Writable);
+    DataSection->addFlag(gtirb::SectionFlag::Loaded);
+    DataSection->addFlag(gtirb::SectionFlag::Initialized);
+    auto* DataBI = DataSection->addByteInterval(
+        Ctx, gtirb::Addr(DataAddress), Data.begin(), Data.end(), Data.size(),
+        Data.size());
+    Table = DataBI->addBlock<gtirb::DataBlock>(Ctx, 0, Data.size());
+    M->addSymbol(Ctx, Table, "table"s);
+    for (size_t I = 0; I < FunctionSymbols.size(); ++I) {
+      DataBI->addSymbolicExpression<gtirb::SymAddrConst>(
+          8 * I, 0, FunctionSymbols[I]);
+      (*M->getAuxData<gtirb::schema::SymbolicExpressionSizes>())
+          [gtirb::Offset(DataBI->getUUID(), 8 * I)] = 8;
+    }
+  }
+
+  PrettyPrinter printer() const {
+    PrettyPrinter Printer;
+    Printer.setTarget(std::make_tuple("elf"s, "x64"s, "att"s));
+    return Printer;
+  }
+
+  /// Add a section holding Bytes at Address, without any blocks.
+  gtirb::ByteInterval* addBytes(const std::string& Name, uint64_t Address,
+                                const std::vector<uint8_t>& Bytes) {
+    gtirb::Section* Section = M->addSection(Ctx, Name);
+    Section->addFlag(gtirb::SectionFlag::Readable);
+    Section->addFlag(gtirb::SectionFlag::Loaded);
+    Section->addFlag(gtirb::SectionFlag::Initialized);
+    return Section->addByteInterval(Ctx, gtirb::Addr(Address), Bytes.begin(),
+                                    Bytes.end(), Bytes.size(), Bytes.size());
+  }
+
+  /// Print the contents of a block, and return its lines with their words
+  /// separated by single spaces.
+  std::vector<std::string> contentLines(const gtirb::DataBlock& Block) {
+    PrettyPrinter Printer = printer();
+    std::ostringstream Listing;
+    Printer.createPrinter(Ctx, *M)->printContents(Listing, Block);
+    std::vector<std::string> Lines;
+    std::istringstream In(Listing.str());
+    for (std::string Line; std::getline(In, Line);) {
+      std::istringstream Words(Line);
+      std::string Joined;
+      for (std::string Word; Words >> Word;)
+        Joined += (Joined.empty() ? "" : " ") + Word;
+      if (!Joined.empty())
+        Lines.push_back(Joined);
+    }
+    return Lines;
+  }
+
+  /// Print the whole module, recording where each entry was printed.
+  std::string printAll(ListingIndex& Index) {
+    PrettyPrinter Printer = printer();
+    auto Base = Printer.createPrinter(Ctx, *M);
+    std::ostringstream Listing;
+    Base->setListingIndex(&Index);
+    Base->print(Listing);
+    return Listing.str();
+  }
+
+  /// The part of the full listing that printing only the .text blocks
+  /// [First, Last] should produce: everything before the first block (the
+  /// file header and the section header), the blocks, the rest of the .text
+  /// section (its footer) and everything after the last section (the file
+  /// footer).
+  std::string expectedSlice(size_t First, size_t Last) {
+    ListingIndex Index;
+    std::string Full = printAll(Index);
+    auto entry = [&](const gtirb::UUID& Id) {
+      for (const auto& Entry : Index.entries())
+        if (Entry.Id == Id)
+          return Entry;
+      ADD_FAILURE() << "no index entry";
+      return ListingIndexEntry{};
+    };
+    ListingIndexEntry Text = entry(TextSection->getUUID());
+    ListingIndexEntry Data = entry(DataSection->getUUID());
+    ListingIndexEntry Begin = entry(Blocks[First]->getUUID());
+    ListingIndexEntry End = entry(Blocks[Last]->getUUID());
+    ListingIndexEntry LastText = entry(Blocks.back()->getUUID());
+    EXPECT_LT(Text.Offset, Data.Offset);
+
+    uint64_t BlocksBegin = entry(Blocks.front()->getUUID()).Offset;
+    uint64_t BlocksEnd = LastText.Offset + LastText.Size;
+    return Full.substr(0, BlocksBegin) +
+           Full.substr(Begin.Offset, End.Offset + End.Size - Begin.Offset) +
+           Full.substr(BlocksEnd, Text.Offset + Text.Size - BlocksEnd) +
+           Full.substr(Data.Offset + Data.Size);
+  }
+};
+
+TEST_F(PrinterTest, DataLineTokens) {
+  PrettyPrinter Printer = printer();
+  auto Base = Printer.createPrinter(Ctx, *M);
+  ASSERT_NE(Base, nullptr);
+  std::ostringstream Listing, TokenStream;
+  {
+    ListingTokenWriter Tokens(TokenStream);
+    Base->setListingTokens(&Tokens);
+    Base->print(Listing);
+  }
+
+  // Each pointer in the table is a line at its own address, followed by a
+  // reference to the function it points to.
+  std::vector<TokenRecord> Records = readTokens(TokenStream.str());
+  size_t Found = 0;
+  for (size_t I = 0; I < Records.size(); ++I) {
+    const auto& Record = Records[I];
+    if (Record.Kind != ListingToken::Line ||
+        Record.Payload.find(".quad") == std::string::npos) {
+      continue;
+    }
+    ASSERT_LT(Found, FunctionSymbols.size());
+    EXPECT_EQ(readLE(Record.Payload, 0, 8), DataAddress + 8 * Found);
+    EXPECT_EQ(uuidAt(Record.Payload, 8), Table->getUUID());
+    ASSERT_LT(I + 1, Records.size());
+    EXPECT_EQ(Records[I + 1].Kind, ListingToken::SymbolRef);
+    EXPECT_EQ(uuidAt(Records[I + 1].Payload, 0),
+              FunctionSymbols[Found]->getUUID());
+    ++Found;
+  }
+  EXPECT_EQ(Found, FunctionSymbols.size()) << Listing.str();
+}
+
+TEST_F(PrinterTest, CfiSymbolTokens) {
+  gtirb::Symbol* Personality = M->addSymbol(Ctx, "__gxx_personality_v0"s);
+  gtirb::Symbol* Lsda = M->addSymbol(Ctx, Table, "lsda"s);
+  auto& Cfi = (*M->getAuxData<gtirb::schema::CfiDirectives>())[gtirb::Offset(
+      Blocks[0]->getUUID(), 0)];
+  Cfi.emplace_back(".cfi_personality", std::vector<int64_t>{0x9b},
+                   Personality->getUUID());
+  Cfi.emplace_back(".cfi_lsda", std::vector<int64_t>{0x1b}, Lsda->getUUID());
+
+  PrettyPrinter Printer = printer();
+  auto Base = Printer.createPrinter(Ctx, *M);
+  ASSERT_NE(Base, nullptr);
+  std::ostringstream Listing, TokenStream;
+  {
+    ListingTokenWriter Tokens(TokenStream);
+    Base->setListingTokens(&Tokens);
+    Base->print(Listing);
+  }
+
+  // Each directive is a line of its own, at the address of the block,
+  // followed by its symbol reference; no reference follows an instruction.
+  std::vector<TokenRecord> Records = readTokens(TokenStream.str());
+  using Reference = std::tuple<std::string, uint64_t, gtirb::UUID>;
+  std::vector<Reference> References;
+  const TokenRecord* Line = nullptr;
+  for (const auto& Record : Records) {
+    if (Record.Kind == ListingToken::Line) {
+      Line = &Record;
+      continue;
+    }
+    if (Record.Kind != ListingToken::SymbolRef) {
+      continue;
+    }
+    gtirb::UUID Id = uuidAt(Record.Payload, 0);
+    if (Id == Personality->getUUID() || Id == Lsda->getUUID()) {
+      ASSERT_NE(Line, nullptr);
+      std::string Text = Line->Payload.substr(24);
+      References.emplace_back(Text.substr(0, Text.find(' ')),
+                              readLE(Line->Payload, 0, 8), Id);
+    }
+  }
+  std::vector<Reference> Expected{
+      {".cfi_personality", TextAddress, Personality->getUUID()},
+      {".cfi_lsda", TextAddress, Lsda->getUUID()}};
+  EXPECT_EQ(References, Expected) << Listing.str();
+}
+
+TEST_F(PrinterTest, PrintRangeIsSliceOfListing) {
+  // The second block of f1: its CFI directives are printed only because
+  // the .cfi_startproc of the first block is replayed.
+  uint64_t Begin = static_cast<uint64_t>(*Blocks[1]->getAddress());
+  uint64_t End = Begin + Blocks[1]->getSize();
+  // Integral symbols are printed after the sections, as in the full listing.
+  M->addSymbol(Ctx, gtirb::Addr(0x3000), "integral"s);
+  PrettyPrinter Printer = printer();
+  std::ostringstream Range;
+  Printer.createPrinter(Ctx, *M)->printRange(Range, gtirb::Addr(Begin),
+                                             gtirb::Addr(End));
+  EXPECT_EQ(Range.str(), expectedSlice(1, 1));
+  EXPECT_NE(Range.str().find(".cfi_endproc"), std::string::npos);
+  EXPECT_EQ(Range.str().find(".cfi_startproc"), std::string::npos);
+  EXPECT_NE(Range.str().find(".set integral, 0x3000"), std::string::npos);
+}
+
+TEST_F(PrinterTest, PrintFunctionIsSliceOfListing) {
+  for (auto [Function, First, Last] :
+       {std::make_tuple(0, 0, 1), std::make_tuple(1, 2, 2)}) {
+    PrettyPrinter Printer = printer();
+    std::ostringstream Listing;
+    Printer.createPrinter(Ctx, *M)->printFunction(Listing, Functions[Function]);
+    EXPECT_EQ(Listing.str(), expectedSlice(First, Last))
+        << "function f" << Function + 1;
+  }
+}
+
+TEST_F(PrinterTest, AmbiguousSymbolNames) {
+  // Integral symbols are printed as ".set NAME, ADDRESS".
+  for (uint64_t Addr : {0, 0, 0, 0x30, 0x30}) {
+    M->addSymbol(Ctx, gtirb::Addr(Addr), "dup"s);
+  }
+  // Takes the first name the symbols at address zero would get.
+  M->addSymbol(Ctx, gtirb::Addr(0x40), "dup_disambig_0_0"s);
+  // Enough duplicated names to be renamed by several threads.
+  const size_t ManyNames = 3 * 4096;
+  for (size_t I = 0; I < ManyNames; ++I) {
+    M->addSymbol(Ctx, gtirb::Addr(0x50), "many" + std::to_string(I));
+    M->addSymbol(Ctx, gtirb::Addr(0x50), "many" + std::to_string(I));
+  }
+
+  PrettyPrinter Printer = printer();
+  std::ostringstream Listing;
+  Printer.createPrinter(Ctx, *M)->print(Listing);
+  std::vector<std::string> Names;
+  std::istringstream Lines(Listing.str());
+  for (std::string Line; std::getline(Lines, Line);) {
+    if (Line.rfind(".set ", 0) == 0) {
+      Names.push_back(Line.substr(5, Line.find(',') - 5));
+    }
+  }
+  std::sort(Names.begin(), Names.end());
+
+  // One symbol of each group keeps its name; the others are numbered per
+  // address, skipping names that are already taken.
+  std::vector<std::string> Expected{
+      "dup",              "dup_disambig_0_0",    "dup_disambig_0_1",
+      "dup_disambig_0_2", "dup_disambig_0x30_0", "dup_disambig_0x30_1"};
+  for (size_t I = 0; I < ManyNames; ++I) {
+    Expected.push_back("many" + std::to_string(I));
+    Expected.push_back("many" + std::to_string(I) + "_disambig_0x50_0");
+  }
+  std::sort(Expected.begin(), Expected.end());
+  EXPECT_EQ(Names, Expected);
+}
+
+TEST_F(PrinterTest, VersionScriptIsCachedPerModule) {
+  PrettyPrinter Printer = printer();
+  PrettyPrinter Copy(Printer);
+
+  // Every thread and every copy of the printer gets the same script.
+  std::vector<std::shared_ptr<const std::string>> Scripts(4);
+  std::vector<std::thread> Threads;
+  for (size_t I = 0; I < Scripts.size(); ++I) {
+    Threads.emplace_back([&, I] {
+      Scripts[I] = (I % 2 ? Copy : Printer).getVersionScript(Ctx, *M);
+    });
+  }
+  for (auto& Thread : Threads)
+    Thread.join();
+  ASSERT_NE(Scripts.front(), nullptr);
+  for (const auto& Script : Scripts)
+    EXPECT_EQ(Script, Scripts.front());
+
+  // Scripts returned before an invalidation stay valid.
+  Printer.invalidateModuleCaches(Ctx, *M);
+  auto After = Copy.getVersionScript(Ctx, *M);
+  ASSERT_NE(After, nullptr);
+  EXPECT_NE(After, Scripts.front());
+  EXPECT_EQ(*After, *Scripts.front());
+
+  // A moved-from printer still shares the caches.
+  PrettyPrinter Moved(std::move(Copy));
+  EXPECT_EQ(Moved.getVersionScript(Ctx, *M), After);
+  EXPECT_EQ(Copy.getVersionScript(Ctx, *M), After);
+}
+
+TEST_F(PrinterTest, ListingShards) {
+  // The .data shard refers to f3, which is local to the .text shard.
+  aux_data::ElfSymbolInfo Local({1, "FUNC", "LOCAL", "DEFAULT", 0});
+  aux_data::setElfSymbolInfo(*FunctionSymbols[2], Local);
+  PrettyPrinter Printer = printer();
+  auto Base = Printer.createPrinter(Ctx, *M);
+  std::vector<ListingShard> Shards = Base->computeListingShards();
+  ASSERT_EQ(Shards.size(), 2);
+  EXPECT_TRUE(Shards[0].Primary);
+  EXPECT_FALSE(Shards[1].Primary);
+  EXPECT_EQ(Shards[0].Sections,
+            std::vector<const gtirb::Section*>{TextSection});
+  EXPECT_EQ(Shards[1].Sections,
+            std::vector<const gtirb::Section*>{DataSection});
+  EXPECT_EQ(Shards[0].Exports,
+            std::vector<const gtirb::Symbol*>(FunctionSymbols.begin(),
+                                              FunctionSymbols.end()));
+  EXPECT_TRUE(Shards[1].Exports.empty());
+
+  std::ostringstream Text, Data;
+  Base->printShards(Shards, {&Text, &Data});
+  // Only the local symbol needs to be made visible.
+  EXPECT_NE(Text.str().find(".globl f3\n.hidden f3\n"), std::string::npos)
+      << Text.str();
+  EXPECT_EQ(Text.str().find(".hidden f1"), std::string::npos) << Text.str();
+  EXPECT_EQ(Text.str().find(".data"), std::string::npos) << Text.str();
+  EXPECT_NE(Data.str().find(".quad f3"), std::string::npos) << Data.str();
+  EXPECT_EQ(Data.str().find("f3:"), std::string::npos) << Data.str();
+}
+
+TEST_F(PrinterTest, ListingShardsKeepSymbolDifferencesTogether) {
+  // The assembler resolves f3 - f1, so the table must be assembled with
+  // .text.
+  gtirb::ByteInterval* DataBI = Table->getByteInterval();
+  DataBI->removeSymbolicExpression(16);
+  DataBI->addSymbolicExpression<gtirb::SymAddrAddr>(
+      16, 1, 0, FunctionSymbols[2], FunctionSymbols[0]);
+  PrettyPrinter Printer = printer();
+  auto Base = Printer.createPrinter(Ctx, *M);
+  std::vector<ListingShard> Shards = Base->computeListingShards();
+  ASSERT_EQ(Shards.size(), 1);
+  EXPECT_TRUE(Shards[0].Primary);
+  EXPECT_EQ(Shards[0].Sections,
+            (std::vector<const gtirb::Section*>{TextSection, DataSection}));
+  EXPECT_TRUE(Shards[0].Exports.empty());
+}
+
+TEST_F(PrinterTest, ZeroRunsArePrintedAsFill) {
+  // A run of at least 16 zero bytes inside a block is printed with a single
+  // directive; shorter runs are printed byte by byte.
+  std::vector<uint8_t> Bytes{1};
+  Bytes.insert(Bytes.end(), 20, 0);
+  Bytes.push_back(2);
+  Bytes.insert(Bytes.end(), 15, 0);
+  Bytes.push_back(3);
+  gtirb::ByteInterval* BI = addBytes(".rodata"s, 0x3000, Bytes);
+  auto* Block = BI->addBlock<gtirb::DataBlock>(Ctx, 0, Bytes.size());
+
+  std::vector<std::string> Expected{".byte 0x1", ".zero 20", ".byte 0x2"};
+  Expected.insert(Expected.end(), 15, ".byte 0x0");
+  Expected.push_back(".byte 0x3");
+  EXPECT_EQ(contentLines(*Block), Expected);
+}
+
+TEST_F(PrinterTest, ZeroRunStopsAtSymbolicExpression) {
+  // The pointer at 24 is zero in the bytes, but keeps its own line between
+  // the zero runs around it.
+  std::vector<uint8_t> Bytes(48, 0);
+  Bytes[0] = 1;
+  gtirb::ByteInterval* BI = addBytes(".rodata"s, 0x3000, Bytes);
+  auto* Block = BI->addBlock<gtirb::DataBlock>(Ctx, 0, Bytes.size());
+  BI->addSymbolicExpression<gtirb::SymAddrConst>(24, 0, FunctionSymbols[0]);
+  (*M->getAuxData<gtirb::schema::SymbolicExpressionSizes>())[gtirb::Offset(
+      BI->getUUID(), 24)] = 8;
+
+  EXPECT_EQ(contentLines(*Block),
+            (std::vector<std::string>{".byte 0x1", ".zero 23", ".quad f1",
+                                      ".zero 16"}));
+}
+
+TEST_F(PrinterTest, ZeroRunStopsAtBlockBoundary) {
+  // The zeros at the end of the first block and at the start of the second
+  // are contiguous in the interval, but each block prints its own.
+  std::vector<uint8_t> Bytes(42, 0);
+  Bytes[0] = 1;
+  Bytes[41] = 2;
+  gtirb::ByteInterval* BI = addBytes(".rodata"s, 0x3000, Bytes);
+  auto* First = BI->addBlock<gtirb::DataBlock>(Ctx, 0, 21);
+  auto* Second = BI->addBlock<gtirb::DataBlock>(Ctx, 21, 21);
+
+  EXPECT_EQ(contentLines(*First),
+            (std::vector<std::string>{".byte 0x1", ".zero 20"}));
+  EXPECT_EQ(contentLines(*Second),
+            (std::vector<std::string>{".zero 20", ".byte 0x2"}));
+}
+
+TEST_F(PrinterTest, SymbolicExpressionsArePrintedPerBlock) {
+  // Four expressions in an interval split into two blocks. Each block
+  // prints only its own, and the expression at 12, overlapped by the one at
+  // 8, is not printed.
+  std::vector<uint8_t> Bytes(24, 0);
+  gtirb::ByteInterval* BI = addBytes(".data.rel.ro"s, 0x3000, Bytes);
+  auto* First = BI->addBlock<gtirb::DataBlock>(Ctx, 0, 8);
+  auto* Second = BI->addBlock<gtirb::DataBlock>(Ctx, 8, 16);
+  auto& Sizes = *M->getAuxData<gtirb::schema::SymbolicExpressionSizes>();
+  for (auto [Offset, Addend, Symbol, Size] :
+       {std::make_tuple(0, 0, 0, 8), std::make_tuple(8, 0, 1, 8),
+        std::make_tuple(12, 0, 2, 4), std::make_tuple(16, 4, 2, 8)}) {
+    BI->addSymbolicExpression<gtirb::SymAddrConst>(Offset, Addend,
+                                                   FunctionSymbols[Symbol]);
+    Sizes[gtirb::Offset(BI->getUUID(), Offset)] = Size;
+  }
+
+  EXPECT_EQ(contentLines(*First), std::vector<std::string>{".quad f1"});
+  EXPECT_EQ(contentLines(*Second),
+            (std::vector<std::string>{".quad f2", ".quad f3+4"}));
+}
+
+TEST_F(PrinterTest, SymbolicExpressionSizesFollowCursor) {
+  // The sizes of the expressions at 0 and 8 are in the size table, and the
+  // size of the one at 4 is inferred from the 4-byte block there. The
+  // entries of another interval at the same offsets are not used.
+  std::vector<uint8_t> Bytes(16, 0);
+  gtirb::ByteInterval* BI = addBytes(".data.rel.ro"s, 0x3000, Bytes);
+  gtirb::ByteInterval* Other = addBytes(".other"s, 0x4000, Bytes);
+  auto* Block = BI->addBlock<gtirb::DataBlock>(Ctx, 0, 16);
+  BI->addBlock<gtirb::DataBlock>(Ctx, 4, 4);
+  auto& Sizes = *M->getAuxData<gtirb::schema::SymbolicExpressionSizes>();
+  for (uint64_t Offset : {0, 4, 8}) {
+    BI->addSymbolicExpression<gtirb::SymAddrConst>(
+        Offset, 0, FunctionSymbols[Offset / 4]);
+    Sizes[gtirb::Offset(Other->getUUID(), Offset)] = 2;
+  }
+  Sizes[gtirb::Offset(BI->getUUID(), 0)] = 4;
+  Sizes[gtirb::Offset(BI->getUUID(), 8)] = 8;
+
+  EXPECT_EQ(contentLines(*Block),
+            (std::vector<std::string>{".long f1", ".long f2", ".quad f3"}));
+}
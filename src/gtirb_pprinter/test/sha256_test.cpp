@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+#include <gtirb_pprinter/Sha256.hpp>
+#include <algorithm>
+#include <string>
+
+using namespace gtirb_pprint;
+
+TEST(Sha256, KnownDigests) {
+  EXPECT_EQ(Sha256::hexDigest(""),
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  EXPECT_EQ(Sha256::hexDigest("abc"),
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  EXPECT_EQ(Sha256::hexDigest(
+                "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+}
+
+TEST(Sha256, Incremental) {
+  // Split across block boundaries in uneven pieces.
+  std::string Data(1000, 'a');
+  Sha256 Hash;
+  for (size_t I = 0; I < Data.size(); I += 37) {
+    Hash.update(Data.data() + I, std::min<size_t>(37, Data.size() - I));
+  }
+  EXPECT_EQ(Hash.hexDigest(), Sha256::hexDigest(Data));
+  EXPECT_EQ(Sha256::hexDigest(Data),
+            "41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3");
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <gtirb_pprinter/Statistics.hpp>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace gtirb_pprint;
+
+TEST(Statistics, PhasesAndCounters) {
+  Statistics Stats;
+  { Statistics::Timer Timer(&Stats, "load"); }
+  Stats.setModule("hello");
+  {
+    Statistics::Timer Timer(&Stats, "print");
+    Stats.add(Statistics::Counter::InstructionsDecoded, 3);
+    Stats.add(Statistics::Counter::SymbolicExpressions);
+  }
+  // Timers without statistics record nothing.
+  { Statistics::Timer Timer(nullptr, "ignored"); }
+
+  std::ostringstream Stream;
+  Stats.writeJSON(Stream);
+  std::string Json = Stream.str();
+  EXPECT_NE(Json.find("{\"phase\": \"load\", \"module\": \"\""),
+            std::string::npos);
+  EXPECT_NE(Json.find("{\"phase\": \"print\", \"module\": \"hello\""),
+            std::string::npos);
+  EXPECT_EQ(Json.find("ignored"), std::string::npos);
+  EXPECT_NE(Json.find("\"hello\": {\"instructions_decoded\": 3, "
+                      "\"data_lines\": 0, \"symbolic_expressions\": 1, "
+                      "\"bytes_written\": 0, \"object_cache_hits\": 0, "
+                      "\"object_cache_misses\": 0}"),
+            std::string::npos);
+}
+
+TEST(Statistics, EscapesNames) {
+  Statistics Stats;
+  Stats.setModule("a\"b\\c\n");
+  std::ostringstream Stream;
+  Stats.writeJSON(Stream);
+  EXPECT_NE(Stream.str().find("\"a\\\"b\\\\c\\u000a\""), std::string::npos);
+}
+
+TEST(Statistics, CountsFromSeveralThreads) {
+  Statistics Stats;
+  Stats.setModule("m");
+  std::vector<std::thread> Threads;
+  for (int T = 0; T < 4; ++T) {
+    Threads.emplace_back([&Stats] {
+      for (int I = 0; I < 10000; ++I)
+        Stats.add(Statistics::Counter::DataLines);
+    });
+  }
+  for (auto& Thread : Threads)
+    Thread.join();
+
+  std::ostringstream Stream;
+  Stats.writeJSON(Stream);
+  EXPECT_NE(Stream.str().find("\"data_lines\": 40000"), std::string::npos);
+}
+
+TEST(Statistics, CpuTimeIsThatOfTheTimingThread) {
+  Statistics Stats;
+  {
+    Statistics::Timer Timer(&Stats, "wait");
+    // Work on another thread is not CPU time of the waiting one.
+    std::thread Busy([] {
+      auto End =
+          std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+      while (std::chrono::steady_clock::now() < End) {
+      }
+    });
+    Busy.join();
+  }
+
+  std::ostringstream Stream;
+  Stats.writeJSON(Stream);
+  std::string Json = Stream.str();
+  size_t Wall = Json.find("\"wall_seconds\": ");
+  size_t Cpu = Json.find("\"cpu_seconds\": ");
+  ASSERT_NE(Wall, std::string::npos);
+  ASSERT_NE(Cpu, std::string::npos);
+  EXPECT_GE(std::stod(Json.substr(Wall + 16)), 0.3);
+  EXPECT_LT(std::stod(Json.substr(Cpu + 15)), 0.15);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <gtirb_pprinter/ElfPrettyPrinter.hpp>
+#include <gtirb_pprinter/MasmPrettyPrinter.hpp>
+#include <string>
+#include <vector>
+
+using namespace gtirb_pprint;
+
+namespace {
+// escapeString as it would be without the word-at-a-time screen.
+std::string escapeBytewise(const Syntax& S, const std::string& Bytes) {
+  std::string Escaped;
+  for (char C : Bytes)
+    Escaped += S.escapeByte(static_cast<uint8_t>(C));
+  return Escaped;
+}
+
+std::string escape(const Syntax& S, const std::string& Bytes) {
+  std::string Escaped;
+  S.escapeString(Escaped, Bytes);
+  return Escaped;
+}
+
+// The escaped bytes, and bytes next to the values the screen compares
+// against (below 0x0e, '"' and '\\'), including their high-bit twins.
+const std::vector<char> SpecialBytes{
+    '\\', '"',    '\n',   '\t',   '\b',   '\f',   '\r',   '\a',
+    '\0', '\x01', '\x0d', '\x0e', '\x21', '\x23', '\x5b', '\x5d',
+    '\x7f', '\x80', '\x87', '\x8a', '\x8e', '\xa2', '\xdc', '\xff'};
+
+// Bytes surrounding the special byte, so that borrows from a neighbour in
+// the same word cannot hide or invent an escape.
+const std::vector<char> Fillers{'a', '\0', '\x0e', '\x80', '\xff', '\xdc'};
+} // namespace
+
+TEST(SyntaxEscape, EveryPositionAndLength) {
+  ElfSyntax Elf;
+  // Lengths up to three words cover every position within a word, strings
+  // crossing word boundaries and tails shorter than a word.
+  for (char Filler : Fillers) {
+    for (char Special : SpecialBytes) {
+      for (size_t Length = 1; Length <= 24; ++Length) {
+        for (size_t Pos = 0; Pos < Length; ++Pos) {
+          std::string Bytes(Length, Filler);
+          Bytes[Pos] = Special;
+          ASSERT_EQ(escape(Elf, Bytes), escapeBytewise(Elf, Bytes))
+              << "filler " << int(uint8_t(Filler)) << ", byte "
+              << int(uint8_t(Special)) << " at " << Pos << " of " << Length;
+        }
+      }
+    }
+  }
+}
+
+TEST(SyntaxEscape, SeveralEscapesAcrossWords) {
+  ElfSyntax Elf;
+  for (size_t Length = 2; Length <= 24; ++Length) {
+    for (size_t First = 0; First < Length; ++First) {
+      for (size_t Second = First + 1; Second < Length; ++Second) {
+        std::string Bytes(Length, 'x');
+        Bytes[First] = '"';
+        Bytes[Second] = '\n';
+        ASSERT_EQ(escape(Elf, Bytes), escapeBytewise(Elf, Bytes))
+            << First << ", " << Second << " of " << Length;
+      }
+    }
+  }
+}
+
+TEST(SyntaxEscape, AllBytes) {
+  ElfSyntax Elf;
+  std::string Bytes;
+  for (int B = 0; B < 256; ++B)
+    Bytes += static_cast<char>(B);
+  // Unaligned starts shift every byte to every position within a word.
+  for (size_t Start = 0; Start < 8; ++Start) {
+    std::string Shifted = std::string(Start, 'a') + Bytes;
+    EXPECT_EQ(escape(Elf, Shifted), escapeBytewise(Elf, Shifted)) << Start;
+  }
+  EXPECT_EQ(escape(Elf, ""), "");
+  EXPECT_EQ(escape(Elf, "a\\b\"c\td"), "a\\\\b\\\"c\\td");
+  EXPECT_EQ(escape(Elf, "\x80\xff\x01"), "\x80\xff\x01");
+}
+
+TEST(SyntaxEscape, AppendsToBuffer) {
+  ElfSyntax Elf;
+  std::string Buf = "prefix ";
+  Elf.escapeString(Buf, "\"q\"");
+  EXPECT_EQ(Buf, "prefix \\\"q\\\"");
+}
+
+TEST(SyntaxEscape, Masm) {
+  MasmSyntax Masm;
+  // Only single quotes are escaped, by doubling them.
+  EXPECT_EQ(escape(Masm, ""), "");
+  EXPECT_EQ(escape(Masm, "it's"), "it''s");
+  EXPECT_EQ(escape(Masm, "'"), "''");
+  EXPECT_EQ(escape(Masm, "''x'"), "''''x''");
+  EXPECT_EQ(escape(Masm, "a\\b\"c\n\x80\xff"), "a\\b\"c\n\x80\xff");
+  for (size_t Length = 1; Length <= 24; ++Length) {
+    for (size_t Pos = 0; Pos < Length; ++Pos) {
+      std::string Bytes(Length, '\xff');
+      Bytes[Pos] = '\'';
+      std::string Expected = Bytes;
+      Expected.insert(Pos, 1, '\'');
+      ASSERT_EQ(escape(Masm, Bytes), Expected) << Pos << " of " << Length;
+    }
+  }
+}
@@ -2,10 +2,11 @@
 #include <gtirb/AuxDataContainer.hpp>
 #include <gtirb/AuxDataSchema.hpp>
 #include <gtirb_pprinter/AuxDataSchema.hpp>
+#include <gtirb_pprinter/PrettyPrinter.hpp>
 
 int main(int argc, char** argv) {
-  gtirb::AuxDataContainer::registerAuxDataType<gtirb::schema::Libraries>();
-  gtirb::AuxDataContainer::registerAuxDataType<gtirb::schema::LibraryPaths>();
+  gtirb_pprint::registerAuxDataTypes();
+  gtirb_pprint::registerPrettyPrinters();
 
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,89 @@
+import os
+import subprocess
+import unittest
+
+import hello_world
+from pprinter_helpers import PPrinterTest, pprinter_binary, temp_directory
+
+
+class AsmTargetTest(PPrinterTest):
+    def print_asm(self, cwd, *args):
+        proc = subprocess.run(
+            (pprinter_binary(), "hello.gtirb", *args),
+            cwd=cwd,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+        )
+        self.assertEqual(proc.returncode, 0, proc.stdout)
+
+    def read(self, *path):
+        with open(os.path.join(*path)) as f:
+            return f.read()
+
+    def test_same_as_separate_runs(self):
+        ir = hello_world.build_gtirb()
+        with temp_directory() as tmpdir:
+            ir.save_protobuf(os.path.join(tmpdir, "hello.gtirb"))
+            targets = (
+                ("att", "assembler"),
+                ("intel", "assembler"),
+                ("intel", "debug"),
+            )
+            for syntax, mode in targets:
+                self.print_asm(
+                    tmpdir,
+                    "--syntax",
+                    syntax,
+                    "--listing-mode",
+                    mode,
+                    "--asm",
+                    f"{syntax}-{mode}.s",
+                )
+
+            self.print_asm(
+                tmpdir,
+                "--syntax",
+                "att",
+                "--asm",
+                "together.s",
+                "--asm-target",
+                "intel=together-intel.s",
+                "--asm-target",
+                "intel:debug=together-debug.s",
+            )
+            self.assertEqual(
+                self.read(tmpdir, "together.s"),
+                self.read(tmpdir, "att-assembler.s"),
+            )
+            self.assertEqual(
+                self.read(tmpdir, "together-intel.s"),
+                self.read(tmpdir, "intel-assembler.s"),
+            )
+            self.assertEqual(
+                self.read(tmpdir, "together-debug.s"),
+                self.read(tmpdir, "intel-debug.s"),
+            )
+
+    def test_invalid_target(self):
+        ir = hello_world.build_gtirb()
+        with temp_directory() as tmpdir:
+            ir.save_protobuf(os.path.join(tmpdir, "hello.gtirb"))
+            for value in ("intel", "nosuchsyntax=out.s", "intel:nomode=out.s"):
+                proc = subprocess.run(
+                    (
+                        pprinter_binary(),
+                        "hello.gtirb",
+                        "--asm",
+                        "out.s",
+                        "--asm-target",
+                        value,
+                    ),
+                    cwd=tmpdir,
+                    stdout=subprocess.PIPE,
+                    stderr=subprocess.STDOUT,
+                )
+                self.assertNotEqual(proc.returncode, 0, value)
+
+
+if __name__ == "__main__":
+    unittest.main()
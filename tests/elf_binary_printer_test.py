@@ -1,5 +1,6 @@
 import os
 from pathlib import Path
+import re
 import subprocess
 import typing
 import unittest
@@ -7,12 +8,14 @@ import unittest
 import gtirb
 import gtirb_test_helpers as gth
 import dummyso
+from gtirb_helpers import add_elf_symbol_info, add_function
 import hello_world
 
 from pprinter_helpers import (
     BinaryPPrinterTest,
     run_asm_pprinter,
     run_asm_pprinter_with_version_script,
+    temp_directory,
 )
 
 
@@ -459,6 +462,349 @@ class ElfBinaryPrinterTests(BinaryPPrinterTest):
             )
             self.assertTrue("relocatable" in output.stdout)
 
+    def object_contents(self, path: Path):
+        """
+        Return the named symbols and the relocations of an object file, in a
+        form that does not depend on how the assembler orders its tables or
+        whether a relocation refers to a local symbol or to its section.
+        """
+        sections = {}
+        for line in self.readelf(path, "-W", "-S").stdout.splitlines():
+            match = re.match(r"\s*\[\s*(\d+)\]\s+(\S+)", line)
+            if match and match.group(1) != "0":
+                sections[match.group(1)] = match.group(2)
+
+        symbols = {}
+        for line in self.readelf(path, "-W", "-s").stdout.splitlines():
+            fields = line.split()
+            if len(fields) != 8 or not re.fullmatch(r"\d+:", fields[0]):
+                continue
+            _, value, size, type_, bind, vis, ndx, name = fields
+            if type_ in ("SECTION", "FILE") or name.startswith(".L"):
+                continue
+            symbols[name] = (
+                int(value, 16),
+                int(size, 0),
+                type_,
+                bind,
+                vis,
+                sections.get(ndx, ndx),
+            )
+
+        relocations = []
+        section = None
+        for line in self.readelf(path, "-W", "-r").stdout.splitlines():
+            match = re.match(r"Relocation section '(\S+)'", line)
+            if match:
+                section = match.group(1)
+                continue
+            match = re.match(
+                r"([0-9a-f]+)\s+[0-9a-f]+\s+(R_\S+)\s+([0-9a-f]+)\s+(\S+)"
+                r"\s*([+-])\s*([0-9a-f]+)$",
+                line,
+            )
+            if not match:
+                continue
+            offset, type_, value, name, sign, addend = match.groups()
+            addend = int(addend, 16) * (-1 if sign == "-" else 1)
+            symbol = symbols.get(name)
+            if symbol is None and name in sections.values():
+                target = (name, int(value, 16) + addend)
+            elif symbol is not None and symbol[3] == "LOCAL":
+                target = (symbol[5], int(value, 16) + addend)
+            else:
+                target = (name, addend)
+            relocations.append((section, int(offset, 16), type_, target))
+        return symbols, sorted(relocations)
+
+    def test_builtin_assembler(self):
+        """
+        Test that objects written by --builtin-assembler behave like the
+        assembled ones, and have the same symbols and relocations
+        """
+        ir = hello_world.build_gtirb()
+        outputs = []
+        contents = []
+        for args in ((), ("--builtin-assembler",)):
+            with self.subTest(args=args):
+                with self.binary_print(ir, "--object", *args) as result:
+                    self.assertNotIn(
+                        "Using the external assembler",
+                        result.completed_process.stdout,
+                    )
+                    contents.append(self.object_contents(result.path))
+                    if args:
+                        self.assertIn(
+                            ".note.GNU-stack",
+                            self.readelf(result.path, "-W", "-S").stdout,
+                        )
+                    exe_path = result.path.with_suffix(".exe")
+                    subprocess.run(
+                        [
+                            "gcc",
+                            "-nostdlib",
+                            "-static",
+                            "-o",
+                            exe_path,
+                            result.path,
+                        ],
+                        check=True,
+                    )
+                    run = subprocess.run(
+                        [exe_path], check=True, capture_output=True
+                    )
+                    outputs.append(run.stdout)
+        self.assertEqual(outputs, [b"hello world\n", b"hello world\n"])
+        assembled, builtin = contents
+        self.assertEqual(builtin[0], assembled[0])
+        self.assertEqual(builtin[1], assembled[1])
+
+    def build_gcc_like_ir(self) -> gtirb.IR:
+        """
+        Build an IR shaped like one of an executable built by gcc: startup
+        functions and symbols that the dynamic policy skips, padding between
+        functions, two static functions with the same name and a constructor
+        in .init_array next to frame_dummy's.
+        """
+        ir, m = gth.create_test_module(
+            gtirb.Module.FileFormat.ELF,
+            gtirb.Module.ISA.X64,
+        )
+        properties = m.aux_data["sectionProperties"].data
+
+        def pad(bi):
+            # Bytes that are not in any block.
+            padding = -bi.size % 16
+            bi.contents += b"\xcc" * padding
+            bi.size += padding
+
+        def add_local_function(name, bi, code, exprs=None):
+            block = gth.add_code_block(bi, code, exprs)
+            sym = gth.add_symbol(m, name, block)
+            add_function(m, sym, block)
+            add_elf_symbol_info(m, sym, len(code), "FUNC", "LOCAL")
+            pad(bi)
+            return sym
+
+        rodata_section, rodata = gth.add_section(m, ".rodata", 0x2000)
+        properties[rodata_section] = (1, 2)
+        msg = gth.add_symbol(
+            m, "msg", gth.add_data_block(rodata, b"hello world\x00")
+        )
+
+        data_section, data = gth.add_data_section(m, 0x3000)
+        properties[data_section] = (1, 3)
+        dso_handle = gth.add_symbol(m, "__dso_handle", None)
+        dso_handle.referent = gth.add_data_block(
+            data,
+            b"\x00\x30\x00\x00\x00\x00\x00\x00",
+            {0: gtirb.SymAddrConst(0, dso_handle)},
+        )
+        add_elf_symbol_info(m, dso_handle, 0, "OBJECT", "GLOBAL", "HIDDEN")
+        counter = gth.add_symbol(
+            m, "counter", gth.add_data_block(data, b"\x00" * 4)
+        )
+        add_elf_symbol_info(m, counter, 4, "OBJECT", "LOCAL")
+
+        text_section, text = gth.add_text_section(m, 0x1040)
+        properties[text_section] = (1, 6)
+        # xor ebp, ebp; xor eax, eax; hlt
+        start = add_local_function("_start", text, b"\x31\xed\x31\xc0\xf4")
+        add_elf_symbol_info(m, start, 5, "FUNC")
+        # ret
+        frame_dummy = add_local_function("frame_dummy", text, b"\xc3")
+        # mov eax, 10; ret
+        helper1 = add_local_function(
+            "helper", text, b"\xb8\x0a\x00\x00\x00\xc3"
+        )
+        # mov dword ptr [rip + counter], 1; ret
+        setup = add_local_function(
+            "setup",
+            text,
+            b"\xc7\x05\x00\x00\x00\x00\x01\x00\x00\x00\xc3",
+            {2: gtirb.SymAddrConst(0, counter)},
+        )
+        # mov eax, 1; ret
+        helper2 = add_local_function(
+            "helper", text, b"\xb8\x01\x00\x00\x00\xc3"
+        )
+
+        puts = gth.add_symbol(m, "puts", gth.add_proxy_block(m))
+        add_elf_symbol_info(m, puts, 0, "FUNC")
+        plt = {gtirb.SymbolicExpression.Attribute.PLT}
+        # push rbx
+        # call helper (the first one)
+        # mov ebx, eax
+        # call helper (the second one)
+        # add ebx, eax
+        # add ebx, dword ptr [rip + counter]
+        # lea rax, [rip + __dso_handle]
+        # lea rdi, [rip + msg]
+        # call puts
+        # mov eax, ebx
+        # pop rbx
+        # ret
+        main_block = gth.add_code_block(
+            text,
+            b"\x53\xe8\x00\x00\x00\x00\x89\xc3\xe8\x00\x00\x00\x00\x01\xc3"
+            b"\x03\x1d\x00\x00\x00\x00\x48\x8d\x05\x00\x00\x00\x00"
+            b"\x48\x8d\x3d\x00\x00\x00\x00\xe8\x00\x00\x00\x00"
+            b"\x89\xd8\x5b\xc3",
+            {
+                2: gtirb.SymAddrConst(0, helper1),
+                9: gtirb.SymAddrConst(0, helper2),
+                17: gtirb.SymAddrConst(0, counter),
+                24: gtirb.SymAddrConst(0, dso_handle),
+                31: gtirb.SymAddrConst(0, msg),
+                36: gtirb.SymAddrConst(0, puts, plt),
+            },
+        )
+        add_function(m, "main", main_block)
+
+        init_section, init_array = gth.add_section(
+            m,
+            ".init_array",
+            0x3100,
+            flags={
+                gtirb.Section.Flag.Readable,
+                gtirb.Section.Flag.Writable,
+                gtirb.Section.Flag.Loaded,
+                gtirb.Section.Flag.Initialized,
+            },
+        )
+        properties[init_section] = (14, 3)
+        for function in (frame_dummy, setup):
+            gth.add_data_block(
+                init_array,
+                b"\x00" * 8,
+                {0: gtirb.SymAddrConst(0, function)},
+            )
+        return ir
+
+    def section_contents(self, path: Path, name: str) -> bytes:
+        """
+        Return the contents of a section of an object file.
+        """
+        with temp_directory() as tmpdir:
+            contents = Path(tmpdir) / "contents"
+            subprocess.run(
+                [
+                    "objcopy",
+                    "--dump-section",
+                    f"{name}={contents}",
+                    path,
+                    Path(tmpdir) / "copy.o",
+                ],
+                check=True,
+            )
+            return contents.read_bytes()
+
+    def test_builtin_assembler_policy(self):
+        """
+        Test that --builtin-assembler leaves out what the printing policy
+        skips, lays out the rest and names ambiguous symbols like the
+        assembled listing does
+        """
+        ir = self.build_gcc_like_ir()
+        objects = []
+        for args in ((), ("--builtin-assembler",)):
+            with self.subTest(args=args):
+                with self.binary_print(
+                    ir, "--policy", "dynamic", "--object", *args
+                ) as result:
+                    self.assertNotIn(
+                        "Using the external assembler",
+                        result.completed_process.stdout,
+                    )
+                    symbols, relocations = self.object_contents(result.path)
+                    sections = [
+                        self.section_contents(result.path, name)
+                        for name in (".text", ".rodata", ".data")
+                    ]
+                    objects.append((symbols, relocations, sections))
+                    exe_path = result.path.with_suffix(".exe")
+                    subprocess.run(
+                        ["gcc", "-o", exe_path, result.path], check=True
+                    )
+                    run = subprocess.run([exe_path], capture_output=True)
+                    self.assertEqual(run.stdout, b"hello world\n")
+                    self.assertEqual(run.returncode, 12)
+        assembled, builtin = objects
+        self.assertEqual(builtin, assembled)
+
+        symbols = builtin[0]
+        for skipped in ("_start", "frame_dummy", "__dso_handle"):
+            self.assertNotIn(skipped, symbols)
+        helpers = [name for name in symbols if name.startswith("helper")]
+        self.assertEqual(len(helpers), 2)
+        self.assertIn("helper", helpers)
+
+    def object_cache_runs(self, ir, cache, edits):
+        """
+        Binary print ir with the object cache once before and once after each
+        edit, returning the log and binary of each run.
+        """
+        outputs = []
+        for edit in [None, *edits]:
+            if edit:
+                edit(ir)
+            with self.binary_print(ir, "--object-cache", cache) as result:
+                outputs.append(
+                    (
+                        result.completed_process.stdout,
+                        result.path.read_bytes(),
+                    )
+                )
+        return outputs
+
+    def test_object_cache(self):
+        """
+        Test that --object-cache reuses the objects of an unchanged module
+        """
+        ir = hello_world.build_gtirb()
+        with temp_directory() as cache:
+            outputs = self.object_cache_runs(ir, cache, [lambda ir: None])
+        (first_log, first_binary), (second_log, second_binary) = outputs
+        # .data and .text are assembled separately.
+        self.assertIn("as 2 shards", first_log)
+        self.assertNotIn("Using the cached object", first_log)
+        self.assertIn("Object cache: 0 hits, 2 misses", first_log)
+        self.assertIn("Using the cached object", second_log)
+        self.assertIn("Object cache: 2 hits, 0 misses", second_log)
+        self.assertEqual(first_binary, second_binary)
+
+    def test_object_cache_edited_section(self):
+        """
+        Test that --object-cache only assembles again the sections that
+        changed, and that the shards link into a working binary
+        """
+
+        def set_exit_code(ir):
+            (text,) = [
+                s for s in ir.modules[0].sections if s.name == ".text"
+            ]
+            (bi,) = text.byte_intervals
+            # The immediate of "mov edi, 0".
+            contents = bytearray(bi.contents)
+            contents[33] = 3
+            bi.contents = bytes(contents)
+
+        ir = hello_world.build_gtirb()
+        with temp_directory() as cache:
+            outputs = self.object_cache_runs(ir, cache, [set_exit_code])
+        (first_log, first_binary), (second_log, second_binary) = outputs
+        self.assertIn("Object cache: 0 hits, 2 misses", first_log)
+        self.assertIn("Object cache: 1 hits, 1 misses", second_log)
+        self.assertNotEqual(first_binary, second_binary)
+
+        with temp_directory() as testdir:
+            exe_path = Path(testdir) / "exit_code"
+            exe_path.write_bytes(second_binary)
+            exe_path.chmod(0o755)
+            run = subprocess.run([exe_path], capture_output=True)
+        self.assertEqual(run.stdout, b"hello world\n")
+        self.assertEqual(run.returncode, 3)
+
     def subtest_dyn_option(
         self,
         mode: str,
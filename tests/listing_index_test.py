@@ -0,0 +1,53 @@
+import os
+import subprocess
+import unittest
+
+import hello_world
+from pprinter_helpers import PPrinterTest, pprinter_binary, temp_directory
+
+
+class ListingIndexTest(PPrinterTest):
+    def test_index_entries(self):
+        ir = hello_world.build_gtirb()
+        with temp_directory() as tmpdir:
+            ir.save_protobuf(os.path.join(tmpdir, "hello.gtirb"))
+            proc = subprocess.run(
+                (
+                    pprinter_binary(),
+                    "hello.gtirb",
+                    "--asm",
+                    "hello.s",
+                    "--listing-index",
+                ),
+                cwd=tmpdir,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.STDOUT,
+            )
+            self.assertEqual(proc.returncode, 0, proc.stdout)
+
+            with open(os.path.join(tmpdir, "hello.s"), "rb") as f:
+                listing = f.read()
+            with open(os.path.join(tmpdir, "hello.s.index")) as f:
+                entries = [line.split() for line in f if line.strip()]
+
+        kinds = {entry[0] for entry in entries}
+        self.assertIn("section", kinds)
+        self.assertIn("block", kinds)
+        for entry in entries:
+            offset, size = int(entry[4]), int(entry[5])
+            self.assertLessEqual(offset + size, len(listing), entry)
+        self.assertTrue(
+            any(e[0] == "block" and int(e[5]) > 0 for e in entries)
+        )
+
+        # Each section's text starts with its section directive.
+        for entry in entries:
+            if entry[0] == "section":
+                offset, size = int(entry[4]), int(entry[5])
+                self.assertGreater(size, 0, entry)
+                text = listing[offset : offset + size].decode()
+                self.assertIn(entry[6], text, entry)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,79 @@
+import os
+import sys
+import unittest
+from concurrent.futures import ThreadPoolExecutor
+
+import hello_world
+from pprinter_helpers import PPrinterTest, run_asm_pprinter
+
+if os.environ.get("PPRINTER_PYTHON_PATH"):
+    sys.path.insert(0, os.environ["PPRINTER_PYTHON_PATH"])
+
+try:
+    from gtirb_pprinter import printing
+except ImportError:
+    printing = None
+
+
+@unittest.skipUnless(printing, "requires the gtirb_pprinter native extension")
+class PrintingTest(PPrinterTest):
+    def test_same_as_driver(self):
+        ir = hello_world.build_gtirb()
+        resident = printing.ResidentIR.from_ir(ir)
+        for syntax in ("att", "intel"):
+            listing = printing.PrettyPrinter(syntax=syntax).print(resident)
+            self.assertEqual(
+                listing.decode(), run_asm_pprinter(ir, ("--syntax", syntax))
+            )
+
+    def test_module_selection(self):
+        ir = hello_world.build_gtirb()
+        resident = printing.ResidentIR.from_ir(ir)
+        name = resident.module_names[0]
+        printer = printing.PrettyPrinter()
+        self.assertEqual(printer.print(resident, 0), printer.print(resident))
+        self.assertEqual(
+            printer.print(resident, name), printer.print(resident)
+        )
+        with self.assertRaises(KeyError):
+            printer.print(resident, 1)
+        with self.assertRaises(KeyError):
+            printer.print(resident, "nosuchmodule")
+
+    def test_calls_are_independent(self):
+        ir = hello_world.build_gtirb()
+        expected = printing.PrettyPrinter().print(
+            printing.ResidentIR.from_ir(ir)
+        )
+
+        # Options that change how the module is rewritten do not affect the
+        # later calls with other options.
+        resident = printing.ResidentIR.from_ir(ir)
+        shared = printing.PrettyPrinter(shared="yes")
+        shared.skip_sections.append(".data")
+        shared.print(resident)
+        self.assertEqual(printing.PrettyPrinter().print(resident), expected)
+
+    def test_threads(self):
+        ir = hello_world.build_gtirb()
+        resident = printing.ResidentIR.from_ir(ir)
+        printers = [
+            printing.PrettyPrinter(syntax="att"),
+            printing.PrettyPrinter(syntax="intel"),
+            printing.PrettyPrinter(syntax="att", shared="yes"),
+        ]
+        expected = [
+            p.print(printing.ResidentIR.from_ir(ir)) for p in printers
+        ]
+        with ThreadPoolExecutor(max_workers=8) as pool:
+            results = list(
+                pool.map(
+                    lambda i: printers[i % 3].print(resident), range(30)
+                )
+            )
+        for i, listing in enumerate(results):
+            self.assertEqual(listing, expected[i % 3])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,151 @@
+import os
+import socket
+import stat
+import struct
+import subprocess
+import time
+import unittest
+
+import hello_world
+from pprinter_helpers import (
+    PPrinterTest,
+    can_mock_binaries,
+    pprinter_binary,
+    temp_directory,
+)
+
+
+@unittest.skipUnless(can_mock_binaries(), "requires Unix domain sockets")
+class ServerTest(PPrinterTest):
+    def run_client(self, socket_path, cwd, *args):
+        return subprocess.run(
+            (pprinter_binary(), "--connect", socket_path, *args),
+            cwd=cwd,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+        )
+
+    def start_server(self, socket_path, *args):
+        server = subprocess.Popen(
+            (pprinter_binary(), "--server", socket_path, *args),
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.DEVNULL,
+        )
+        for _ in range(100):
+            if os.path.exists(socket_path):
+                break
+            time.sleep(0.1)
+        return server
+
+    def test_requests(self):
+        ir = hello_world.build_gtirb()
+        with temp_directory() as tmpdir:
+            ir.save_protobuf(os.path.join(tmpdir, "hello.gtirb"))
+            socket_path = os.path.join(tmpdir, "pprinter.sock")
+            server = self.start_server(socket_path)
+            try:
+
+                subprocess.run(
+                    (pprinter_binary(), "hello.gtirb", "--asm", "direct.s"),
+                    cwd=tmpdir,
+                    check=True,
+                    stdout=subprocess.DEVNULL,
+                )
+                with open(os.path.join(tmpdir, "direct.s")) as f:
+                    expected = f.read()
+
+                # Requests use the working directory of the client, and the
+                # resident IR is not changed by the requests before them.
+                for name in ("first.s", "second.s"):
+                    proc = self.run_client(
+                        socket_path, tmpdir, "hello.gtirb", "--asm", name
+                    )
+                    self.assertEqual(proc.returncode, 0, proc.stdout)
+                    with open(os.path.join(tmpdir, name)) as f:
+                        self.assertEqual(f.read(), expected)
+
+                # Listings printed to the standard output reach the client.
+                proc = self.run_client(socket_path, tmpdir, "hello.gtirb")
+                self.assertEqual(proc.returncode, 0)
+                self.assertIn("hello:", proc.stdout.decode())
+
+                proc = self.run_client(socket_path, tmpdir, "missing.gtirb")
+                self.assertNotEqual(proc.returncode, 0)
+            finally:
+                server.terminate()
+                server.wait()
+
+    def test_unloading(self):
+        # With room for one resident IR, alternating between two files
+        # unloads and reloads them; each request still prints its own file.
+        first = hello_world.build_gtirb()
+        second = hello_world.build_gtirb()
+        second.modules[0].name = "other"
+        for sym in second.modules[0].symbols:
+            if sym.name == "hello":
+                sym.name = "greeting"
+        with temp_directory() as tmpdir:
+            first.save_protobuf(os.path.join(tmpdir, "first.gtirb"))
+            second.save_protobuf(os.path.join(tmpdir, "second.gtirb"))
+            expected = {}
+            for name in ("first", "second"):
+                subprocess.run(
+                    (pprinter_binary(), f"{name}.gtirb", "--asm", f"{name}.s"),
+                    cwd=tmpdir,
+                    check=True,
+                    stdout=subprocess.DEVNULL,
+                )
+                with open(os.path.join(tmpdir, f"{name}.s")) as f:
+                    expected[name] = f.read()
+            self.assertNotEqual(expected["first"], expected["second"])
+
+            socket_path = os.path.join(tmpdir, "pprinter.sock")
+            server = self.start_server(
+                socket_path, "--server-max-irs", "1"
+            )
+            try:
+                for i, name in enumerate(("first", "second", "first")):
+                    out = f"served-{i}.s"
+                    proc = self.run_client(
+                        socket_path, tmpdir, f"{name}.gtirb", "--asm", out
+                    )
+                    self.assertEqual(proc.returncode, 0, proc.stdout)
+                    with open(os.path.join(tmpdir, out)) as f:
+                        self.assertEqual(f.read(), expected[name])
+            finally:
+                server.terminate()
+                server.wait()
+
+    def test_rejects_bad_requests(self):
+        ir = hello_world.build_gtirb()
+        with temp_directory() as tmpdir:
+            ir.save_protobuf(os.path.join(tmpdir, "hello.gtirb"))
+            socket_path = os.path.join(tmpdir, "pprinter.sock")
+            server = self.start_server(socket_path)
+            try:
+                # Only the server's user may connect.
+                mode = stat.S_IMODE(os.stat(socket_path).st_mode)
+                self.assertEqual(mode, 0o600)
+
+                # An oversized request, or one without exactly the three
+                # standard streams, is dropped without a reply.
+                read_end, write_end = os.pipe()
+                try:
+                    for fds in ([0, 1, 2], [0, 1, 2, read_end], [read_end]):
+                        with socket.socket(socket.AF_UNIX) as client:
+                            client.connect(socket_path)
+                            socket.send_fds(
+                                client, [struct.pack("<I", 0xFFFFFFFF)], fds
+                            )
+                            self.assertEqual(client.recv(4), b"")
+                finally:
+                    os.close(read_end)
+                    os.close(write_end)
+
+                # The server still handles requests afterwards.
+                proc = self.run_client(socket_path, tmpdir, "hello.gtirb")
+                self.assertEqual(proc.returncode, 0, proc.stdout)
+                self.assertIn("hello:", proc.stdout.decode())
+            finally:
+                server.terminate()
+                server.wait()